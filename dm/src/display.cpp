@@ -20,6 +20,7 @@
 
 #include "class_var_definition.h"
 #include "display_info.h"
+#include "display_manager.h"
 #include "display_manager_adapter.h"
 #include "singleton_container.h"
 #include "window_manager_hilog.h"
@@ -106,8 +107,15 @@ void Display::UpdateDisplayInfo(sptr<DisplayInfo> displayInfo) const
 
 void Display::UpdateDisplayInfo() const
 {
-    auto displayInfo = SingletonContainer::Get<DisplayManagerAdapter>().GetDisplayInfo(GetId());
-    UpdateDisplayInfo(displayInfo);
+    // DisplayManager answers from its cache while DMS pushes display changes, and fetches the info otherwise
+    auto display = DisplayManager::GetInstance().GetDisplayById(GetId());
+    if (display == nullptr) {
+        WLOGFE("display is invalid");
+        return;
+    }
+    if (display.GetRefPtr() != this) {
+        UpdateDisplayInfo(display->GetDisplayInfo());
+    }
 }
 
 float Display::GetVirtualPixelRatio() const
@@ -15,6 +15,8 @@
 
 #include "display_manager.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cinttypes>
 #include <transaction/rs_interfaces.h>
 
@@ -29,6 +31,9 @@ namespace OHOS::Rosen {
 namespace {
     constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_DISPLAY, "DisplayManager"};
     const static uint32_t MAX_DISPLAY_SIZE = 32;
+    constexpr int64_t DISPLAY_CACHE_RETRY_MIN_MS = 100;
+    constexpr int64_t DISPLAY_CACHE_RETRY_MAX_MS = 30000;
+    constexpr uint32_t DISPLAY_CACHE_RETRY_MAX_SHIFT = 9;
 }
 WM_IMPLEMENT_SINGLE_INSTANCE(DisplayManager)
 
@@ -56,6 +61,8 @@ private:
     void NotifyDisplayDestroy(DisplayId);
     void NotifyDisplayChange(sptr<DisplayInfo> displayInfo);
     bool UpdateDisplayInfoLocked(sptr<DisplayInfo>);
+    bool ShouldEnableDisplayCacheLocked();
+    void EnableDisplayCache();
 
     class DisplayManagerListener;
     sptr<DisplayManagerListener> displayManagerListener_;
@@ -67,6 +74,17 @@ private:
     sptr<DisplayManagerAgent> powerEventListenerAgent_;
     sptr<DisplayManagerAgent> displayStateAgent_;
     std::set<sptr<IDisplayListener>> displayListeners_;
+    // registered on the first display query, keeps cached displays up to date without user listeners
+    class DisplayCacheAgent;
+    sptr<DisplayCacheAgent> displayCacheAgent_;
+    // displays whose info is the latest one pushed by DMS, served without IPC
+    std::set<DisplayId> cachedDisplayIds_;
+    // bumped on every pushed change, a fetch racing with a push is not trusted as the latest info
+    uint64_t displayInfoGeneration_ = 0;
+    // the cache agent is registered outside mutex_, failed registrations are retried with backoff
+    bool isDisplayCacheRegistering_ = false;
+    uint32_t displayCacheRegisterFailCount_ = 0;
+    std::chrono::steady_clock::time_point nextDisplayCacheRegisterTime_;
 };
 
 class DisplayManager::Impl::DisplayManagerListener : public DisplayManagerAgentDefault {
@@ -127,6 +145,40 @@ private:
     sptr<Impl> pImpl_;
 };
 
+class DisplayManager::Impl::DisplayCacheAgent : public DisplayManagerAgentDefault {
+public:
+    explicit DisplayCacheAgent(sptr<Impl> impl) : pImpl_(impl)
+    {
+    }
+    ~DisplayCacheAgent() = default;
+
+    void OnDisplayCreate(sptr<DisplayInfo> displayInfo) override
+    {
+        if (displayInfo == nullptr || displayInfo->GetDisplayId() == DISPLAY_ID_INVALID) {
+            return;
+        }
+        pImpl_->NotifyDisplayCreate(displayInfo);
+    }
+
+    void OnDisplayDestroy(DisplayId displayId) override
+    {
+        if (displayId == DISPLAY_ID_INVALID) {
+            return;
+        }
+        pImpl_->NotifyDisplayDestroy(displayId);
+    }
+
+    void OnDisplayChange(sptr<DisplayInfo> displayInfo, DisplayChangeEvent event) override
+    {
+        if (displayInfo == nullptr || displayInfo->GetDisplayId() == DISPLAY_ID_INVALID) {
+            return;
+        }
+        pImpl_->NotifyDisplayChange(displayInfo);
+    }
+private:
+    sptr<Impl> pImpl_;
+};
+
 class DisplayManager::Impl::DisplayManagerAgent : public DisplayManagerAgentDefault {
 public:
     explicit DisplayManagerAgent(sptr<Impl> impl) : pImpl_(impl)
@@ -200,6 +252,11 @@ DisplayManager::Impl::~Impl()
             displayManagerListener_, DisplayManagerAgentType::DISPLAY_EVENT_LISTENER);
     }
     displayManagerListener_ = nullptr;
+    if (displayCacheAgent_ != nullptr) {
+        res = SingletonContainer::Get<DisplayManagerAdapter>().UnregisterDisplayManagerAgent(
+            displayCacheAgent_, DisplayManagerAgentType::DISPLAY_EVENT_LISTENER) && res;
+    }
+    displayCacheAgent_ = nullptr;
     if (!res) {
         WLOGFW("UnregisterDisplayManagerAgent DISPLAY_EVENT_LISTENER failed !");
     }
@@ -249,15 +306,70 @@ sptr<Display> DisplayManager::Impl::GetDefaultDisplay()
 
 sptr<Display> DisplayManager::Impl::GetDisplayById(DisplayId displayId)
 {
+    uint64_t generation = 0;
+    bool needEnableCache = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (displayCacheAgent_ != nullptr && cachedDisplayIds_.find(displayId) != cachedDisplayIds_.end()) {
+            auto iter = displayMap_.find(displayId);
+            if (iter != displayMap_.end() && iter->second != nullptr) {
+                return iter->second;
+            }
+        }
+        needEnableCache = ShouldEnableDisplayCacheLocked();
+        generation = displayInfoGeneration_;
+    }
+    if (needEnableCache) {
+        EnableDisplayCache();
+    }
     auto displayInfo = SingletonContainer::Get<DisplayManagerAdapter>().GetDisplayInfo(displayId);
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!UpdateDisplayInfoLocked(displayInfo)) {
         displayMap_.erase(displayId);
+        cachedDisplayIds_.erase(displayId);
         return nullptr;
     }
+    if (displayCacheAgent_ != nullptr && generation == displayInfoGeneration_) {
+        cachedDisplayIds_.insert(displayId);
+    }
     return displayMap_[displayId];
 }
 
+bool DisplayManager::Impl::ShouldEnableDisplayCacheLocked()
+{
+    if (displayCacheAgent_ != nullptr || isDisplayCacheRegistering_ ||
+        std::chrono::steady_clock::now() < nextDisplayCacheRegisterTime_) {
+        return false;
+    }
+    isDisplayCacheRegistering_ = true;
+    return true;
+}
+
+void DisplayManager::Impl::EnableDisplayCache()
+{
+    sptr<DisplayCacheAgent> agent = new DisplayCacheAgent(this);
+    bool res = SingletonContainer::Get<DisplayManagerAdapter>().RegisterDisplayManagerAgent(
+        agent, DisplayManagerAgentType::DISPLAY_EVENT_LISTENER);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    isDisplayCacheRegistering_ = false;
+    if (!res) {
+        int64_t retryMs = DISPLAY_CACHE_RETRY_MAX_MS;
+        if (displayCacheRegisterFailCount_ < DISPLAY_CACHE_RETRY_MAX_SHIFT) {
+            retryMs = std::min(DISPLAY_CACHE_RETRY_MIN_MS << displayCacheRegisterFailCount_,
+                DISPLAY_CACHE_RETRY_MAX_MS);
+            displayCacheRegisterFailCount_++;
+        }
+        nextDisplayCacheRegisterTime_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(retryMs);
+        WLOGFW("RegisterDisplayManagerAgent failed, display info is not cached, retry in %{public}" PRId64" ms",
+            retryMs);
+        return;
+    }
+    displayCacheRegisterFailCount_ = 0;
+    // fetches that started before the agent was registered may have missed a push
+    displayInfoGeneration_++;
+    displayCacheAgent_ = agent;
+}
+
 sptr<Display> DisplayManager::GetDisplayById(DisplayId displayId)
 {
     return pImpl_->GetDisplayById(displayId);
@@ -539,20 +651,28 @@ void DisplayManager::Impl::NotifyDisplayStateChanged(DisplayId id, DisplayState
 void DisplayManager::Impl::NotifyDisplayCreate(sptr<DisplayInfo> info)
 {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    UpdateDisplayInfoLocked(info);
+    displayInfoGeneration_++;
+    if (UpdateDisplayInfoLocked(info) && displayCacheAgent_ != nullptr) {
+        cachedDisplayIds_.insert(info->GetDisplayId());
+    }
 }
 
 void DisplayManager::Impl::NotifyDisplayDestroy(DisplayId displayId)
 {
     WLOGFI("displayId:%{public}" PRIu64".", displayId);
     std::lock_guard<std::recursive_mutex> lock(mutex_);
+    displayInfoGeneration_++;
     displayMap_.erase(displayId);
+    cachedDisplayIds_.erase(displayId);
 }
 
 void DisplayManager::Impl::NotifyDisplayChange(sptr<DisplayInfo> displayInfo)
 {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    UpdateDisplayInfoLocked(displayInfo);
+    displayInfoGeneration_++;
+    if (UpdateDisplayInfoLocked(displayInfo) && displayCacheAgent_ != nullptr) {
+        cachedDisplayIds_.insert(displayInfo->GetDisplayId());
+    }
 }
 
 bool DisplayManager::Impl::UpdateDisplayInfoLocked(sptr<DisplayInfo> displayInfo)
@@ -562,14 +682,14 @@ bool DisplayManager::Impl::UpdateDisplayInfoLocked(sptr<DisplayInfo> displayInfo
         return false;
     }
     DisplayId displayId = displayInfo->GetDisplayId();
-    WLOGFI("displayId:%{public}" PRIu64".", displayId);
+    WLOGFD("displayId:%{public}" PRIu64".", displayId);
     if (displayId == DISPLAY_ID_INVALID) {
         WLOGFE("displayId is invalid.");
         return false;
     }
     auto iter = displayMap_.find(displayId);
     if (iter != displayMap_.end() && iter->second != nullptr) {
-        WLOGFI("get screen in screen map");
+        WLOGFD("get screen in screen map");
         iter->second->UpdateDisplayInfo(displayInfo);
         return true;
     }
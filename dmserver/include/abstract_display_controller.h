@@ -18,7 +18,10 @@
 
 #include "abstract_screen_controller.h"
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <pixel_map.h>
 #include <surface.h>
 #include <transaction/rs_interfaces.h>
@@ -33,7 +36,7 @@ class AbstractDisplayController : public RefBase {
 using DisplayStateChangeListener = std::function<void(DisplayId, sptr<DisplayInfo>,
     const std::map<DisplayId, sptr<DisplayInfo>>&, DisplayStateChangeType)>;
 public:
-    AbstractDisplayController(std::recursive_mutex& mutex, DisplayStateChangeListener);
+    AbstractDisplayController(TrackedRecursiveMutex& mutex, DisplayStateChangeListener);
     ~AbstractDisplayController();
     WM_DISALLOW_COPY_AND_MOVE(AbstractDisplayController);
 
@@ -66,8 +69,10 @@ private:
         sptr<AbstractScreen> absScreen, sptr<AbstractScreenGroup> screenGroup, sptr<AbstractDisplay>& absDisplay);
     bool UpdateDisplaySize(sptr<AbstractDisplay> absDisplay, sptr<SupportedScreenModes> info);
     void SetDisplayStateChangeListener(sptr<AbstractDisplay> abstractDisplay, DisplayStateChangeType type);
+    bool AcquireCaptureSlot(std::chrono::steady_clock::time_point deadline);
+    void ReleaseCaptureSlot();
 
-    std::recursive_mutex& mutex_;
+    TrackedRecursiveMutex& mutex_;
     std::atomic<DisplayId> displayCount_ { 0 };
     sptr<AbstractDisplay> dummyDisplay_;
     std::map<DisplayId, sptr<AbstractDisplay>> abstractDisplayMap_;
@@ -75,6 +80,10 @@ private:
     sptr<AbstractScreenController::AbstractScreenCallback> abstractScreenCallback_;
     OHOS::Rosen::RSInterfaces& rsInterface_;
     DisplayStateChangeListener displayStateChangeListener_;
+    // screen captures run outside mutex_, these only bound how many wait for the render service at once
+    std::mutex captureMutex_;
+    std::condition_variable captureCondition_;
+    uint32_t capturesInFlight_ { 0 };
 };
 } // namespace OHOS::Rosen
 #endif // FOUNDATION_DMSERVER_ABSTRACT_DISPLAY_CONTROLLER_H
\ No newline at end of file
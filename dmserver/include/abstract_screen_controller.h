@@ -29,6 +29,7 @@
 #include "display_manager_agent_controller.h"
 #include "dm_common.h"
 #include "screen.h"
+#include "tracked_recursive_mutex.h"
 #include "zidl/display_manager_agent_interface.h"
 
 namespace OHOS::Rosen {
@@ -42,7 +43,7 @@ public:
         OnAbstractScreenChangeCb onChange_;
     };
 
-    explicit AbstractScreenController(std::recursive_mutex& mutex);
+    explicit AbstractScreenController(TrackedRecursiveMutex& mutex);
     ~AbstractScreenController();
     WM_DISALLOW_COPY_AND_MOVE(AbstractScreenController);
 
@@ -131,7 +132,7 @@ private:
         std::map<ScreenId, ScreenId> dms2RsScreenIdMap_;
     };
 
-    std::recursive_mutex& mutex_;
+    TrackedRecursiveMutex& mutex_;
     OHOS::Rosen::RSInterfaces& rsInterface_;
     ScreenIdManager screenIdManager_;
     std::map<ScreenId, sptr<AbstractScreen>> dmsScreenMap_;
@@ -22,6 +22,7 @@
 #include "display.h"
 #include "display_change_listener.h"
 #include "dm_common.h"
+#include "tracked_recursive_mutex.h"
 
 namespace OHOS {
 namespace Rosen {
@@ -29,7 +30,7 @@ class DisplayPowerController : public RefBase {
 using DisplayStateChangeListener = std::function<void(DisplayId, sptr<DisplayInfo>,
     const std::map<DisplayId, sptr<DisplayInfo>>&, DisplayStateChangeType)>;
 public:
-    DisplayPowerController(std::recursive_mutex& mutex, DisplayStateChangeListener listener)
+    DisplayPowerController(TrackedRecursiveMutex& mutex, DisplayStateChangeListener listener)
         : mutex_(mutex), displayStateChangeListener_(listener)
     {
     }
@@ -43,7 +44,7 @@ public:
 private:
     DisplayState displayState_ { DisplayState::UNKNOWN };
     bool isKeyguardDrawn_ { false };
-    std::recursive_mutex& mutex_;
+    TrackedRecursiveMutex& mutex_;
     DisplayStateChangeListener displayStateChangeListener_;
 };
 }
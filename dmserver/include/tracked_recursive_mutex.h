@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FOUNDATION_DMSERVER_TRACKED_RECURSIVE_MUTEX_H
+#define FOUNDATION_DMSERVER_TRACKED_RECURSIVE_MUTEX_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "noncopyable.h"
+
+namespace OHOS::Rosen {
+/*
+ * Recursive mutex shared by the DMS controllers that counts how often and how long callers wait for it,
+ * and how long the outermost owner holds it. Usable with std::lock_guard and std::unique_lock.
+ */
+class TrackedRecursiveMutex {
+public:
+    TrackedRecursiveMutex() = default;
+    ~TrackedRecursiveMutex() = default;
+    WM_DISALLOW_COPY_AND_MOVE(TrackedRecursiveMutex);
+
+    void lock();
+    bool try_lock();
+    void unlock();
+    std::string GetContentionInfo() const;
+
+private:
+    void OnAcquired(std::chrono::steady_clock::time_point now);
+
+    std::recursive_mutex mutex_;
+    // only touched by the owner while the mutex is held
+    uint32_t depth_ { 0 };
+    std::chrono::steady_clock::time_point holdStartTime_;
+    std::atomic<uint64_t> lockCount_ { 0 };
+    std::atomic<uint64_t> contendedCount_ { 0 };
+    std::atomic<uint64_t> totalWaitUs_ { 0 };
+    std::atomic<uint64_t> maxWaitUs_ { 0 };
+    std::atomic<uint64_t> maxHoldUs_ { 0 };
+};
+} // namespace OHOS::Rosen
+#endif // FOUNDATION_DMSERVER_TRACKED_RECURSIVE_MUTEX_H
@@ -15,6 +15,8 @@
 
 #include "abstract_display_controller.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cinttypes>
 #include <hitrace_meter.h>
 #include <sstream>
@@ -29,9 +31,11 @@
 namespace OHOS::Rosen {
 namespace {
     constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_DISPLAY, "AbstractDisplayController"};
+    constexpr uint32_t MAX_CONCURRENT_SCREEN_CAPTURES = 2;
+    constexpr int64_t SCREEN_CAPTURE_TIMEOUT_MS = 2000;
 }
 
-AbstractDisplayController::AbstractDisplayController(std::recursive_mutex& mutex, DisplayStateChangeListener listener)
+AbstractDisplayController::AbstractDisplayController(TrackedRecursiveMutex& mutex, DisplayStateChangeListener listener)
     : mutex_(mutex), rsInterface_(RSInterfaces::GetInstance()), displayStateChangeListener_(listener)
 {
 }
@@ -74,7 +78,7 @@ RSScreenModeInfo AbstractDisplayController::GetScreenActiveMode(ScreenId id)
 
 sptr<AbstractDisplay> AbstractDisplayController::GetAbstractDisplay(DisplayId displayId) const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     auto iter = abstractDisplayMap_.find(displayId);
     if (iter == abstractDisplayMap_.end()) {
         WLOGFE("Failed to get AbstractDisplay %{public}" PRIu64", return nullptr!", displayId);
@@ -85,7 +89,7 @@ sptr<AbstractDisplay> AbstractDisplayController::GetAbstractDisplay(DisplayId di
 
 sptr<AbstractDisplay> AbstractDisplayController::GetAbstractDisplayByScreen(ScreenId screenId) const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     for (auto iter : abstractDisplayMap_) {
         sptr<AbstractDisplay> display = iter.second;
         if (display->GetAbstractScreenId() == screenId) {
@@ -98,7 +102,7 @@ sptr<AbstractDisplay> AbstractDisplayController::GetAbstractDisplayByScreen(Scre
 
 std::vector<DisplayId> AbstractDisplayController::GetAllDisplayIds() const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     std::vector<DisplayId> res;
     for (auto iter = abstractDisplayMap_.begin(); iter != abstractDisplayMap_.end(); ++iter) {
         res.push_back(iter->first);
@@ -108,24 +112,60 @@ std::vector<DisplayId> AbstractDisplayController::GetAllDisplayIds() const
 
 std::shared_ptr<Media::PixelMap> AbstractDisplayController::GetScreenSnapshot(DisplayId displayId)
 {
-    sptr<AbstractDisplay> abstractDisplay = GetAbstractDisplay(displayId);
-    if (abstractDisplay == nullptr) {
-        WLOGFE("GetScreenSnapshot: GetAbstractDisplay failed");
+    // one deadline for the whole call, the wait for a slot is taken from the time left for the capture
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SCREEN_CAPTURE_TIMEOUT_MS);
+    std::shared_ptr<RSDisplayNode> displayNode;
+    {
+        // only resolve the node under the dms lock, the capture below may wait for seconds
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
+        sptr<AbstractDisplay> abstractDisplay = GetAbstractDisplay(displayId);
+        if (abstractDisplay == nullptr) {
+            WLOGFE("GetScreenSnapshot: GetAbstractDisplay failed");
+            return nullptr;
+        }
+        ScreenId dmsScreenId = abstractDisplay->GetAbstractScreenId();
+        displayNode = abstractScreenController_->GetRSDisplayNodeByScreenId(dmsScreenId);
+    }
+    if (displayNode == nullptr) {
+        WLOGFE("GetScreenSnapshot: displayNode is null");
+        return nullptr;
+    }
+    if (!AcquireCaptureSlot(deadline)) {
+        WLOGFE("GetScreenSnapshot: too many screen captures in flight");
         return nullptr;
     }
-    ScreenId dmsScreenId = abstractDisplay->GetAbstractScreenId();
-    std::shared_ptr<RSDisplayNode> displayNode = abstractScreenController_->GetRSDisplayNodeByScreenId(dmsScreenId);
-
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
     std::shared_ptr<SurfaceCaptureFuture> callback = std::make_shared<SurfaceCaptureFuture>();
     rsInterface_.TakeSurfaceCapture(displayNode, callback);
-    std::shared_ptr<Media::PixelMap> screenshot = callback->GetResult(2000); // wait for <= 2000ms
+    auto remainingTime = std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+        std::chrono::steady_clock::now()).count();
+    std::shared_ptr<Media::PixelMap> screenshot = callback->GetResult(std::max<long>(remainingTime, 0));
+    ReleaseCaptureSlot();
     if (screenshot == nullptr) {
         WLOGFE("Failed to get pixelmap from RS, return nullptr!");
     }
     return screenshot;
 }
 
+bool AbstractDisplayController::AcquireCaptureSlot(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(captureMutex_);
+    bool hasSlot = captureCondition_.wait_until(lock, deadline,
+        [this] { return capturesInFlight_ < MAX_CONCURRENT_SCREEN_CAPTURES; });
+    if (hasSlot) {
+        capturesInFlight_++;
+    }
+    return hasSlot;
+}
+
+void AbstractDisplayController::ReleaseCaptureSlot()
+{
+    {
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        capturesInFlight_--;
+    }
+    captureCondition_.notify_one();
+}
+
 void AbstractDisplayController::OnAbstractScreenConnect(sptr<AbstractScreen> absScreen)
 {
     if (absScreen == nullptr) {
@@ -133,7 +173,7 @@ void AbstractDisplayController::OnAbstractScreenConnect(sptr<AbstractScreen> abs
         return;
     }
     WLOGI("connect new screen. id:%{public}" PRIu64"", absScreen->dmsId_);
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     sptr<AbstractScreenGroup> group = absScreen->GetGroup();
     if (group == nullptr) {
         WLOGE("the group information of the screen is wrong");
@@ -162,7 +202,7 @@ void AbstractDisplayController::OnAbstractScreenDisconnect(sptr<AbstractScreen>
     sptr<AbstractScreenGroup> screenGroup;
     DisplayId absDisplayId = DISPLAY_ID_INVALID;
     sptr<AbstractDisplay> abstractDisplay = nullptr;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     screenGroup = absScreen->GetGroup();
     if (screenGroup == nullptr) {
         WLOGE("the group information of the screen is wrong");
@@ -185,6 +225,10 @@ void AbstractDisplayController::OnAbstractScreenDisconnect(sptr<AbstractScreen>
         if (screenGroup->GetChildCount() == 0) {
             abstractDisplayMap_.erase(absDisplayId);
             DisplayManagerAgentController::GetInstance().OnDisplayDestroy(absDisplayId);
+        } else {
+            // the display now shows the default screen, clients caching its info must refresh it
+            DisplayManagerAgentController::GetInstance().OnDisplayChange(abstractDisplay->ConvertToDisplayInfo(),
+                DisplayChangeEvent::UNKNOWN);
         }
     } else if (screenGroup->combination_ == ScreenCombination::SCREEN_EXPAND) {
         SetDisplayStateChangeListener(abstractDisplay, DisplayStateChangeType::DESTROY);
@@ -240,6 +284,8 @@ DisplayId AbstractDisplayController::ProcessExpandScreenDisconnected(
             abstractDisplay->SetOffset(0, 0);
             auto screenId = abstractDisplay->GetAbstractScreenId();
             abstractScreenController_->GetRSDisplayNodeByScreenId(screenId)->SetDisplayOffset(0, 0);
+            DisplayManagerAgentController::GetInstance().OnDisplayChange(abstractDisplay->ConvertToDisplayInfo(),
+                DisplayChangeEvent::UNKNOWN);
         }
     }
     return displayId;
@@ -283,7 +329,7 @@ void AbstractDisplayController::ProcessDisplayRotationChange(sptr<AbstractScreen
 sptr<AbstractDisplay> AbstractDisplayController::GetAbstractDisplayByAbsScreen(sptr<AbstractScreen> absScreen)
 {
     sptr<AbstractDisplay> abstractDisplay = nullptr;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     auto iter = abstractDisplayMap_.begin();
     for (; iter != abstractDisplayMap_.end(); iter++) {
         if (iter->second->GetAbstractScreenId() == absScreen->dmsId_) {
@@ -317,7 +363,7 @@ void AbstractDisplayController::ProcessDisplayUpdateOrientation(sptr<AbstractScr
 {
     sptr<AbstractDisplay> abstractDisplay = nullptr;
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         auto iter = abstractDisplayMap_.begin();
         for (; iter != abstractDisplayMap_.end(); iter++) {
             abstractDisplay = iter->second;
@@ -369,7 +415,7 @@ void AbstractDisplayController::ProcessDisplaySizeChange(sptr<AbstractScreen> ab
 
     std::map<DisplayId, sptr<AbstractDisplay>> matchedDisplays;
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         for (auto iter = abstractDisplayMap_.begin(); iter != abstractDisplayMap_.end(); ++iter) {
             sptr<AbstractDisplay> absDisplay = iter->second;
             if (absDisplay == nullptr || absDisplay->GetAbstractScreenId() != absScreen->dmsId_) {
@@ -413,7 +459,7 @@ void AbstractDisplayController::ProcessVirtualPixelRatioChange(sptr<AbstractScre
 {
     sptr<AbstractDisplay> abstractDisplay = nullptr;
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         auto iter = abstractDisplayMap_.begin();
         for (; iter != abstractDisplayMap_.end(); iter++) {
             abstractDisplay = iter->second;
@@ -551,7 +597,7 @@ void AbstractDisplayController::SetFreeze(std::vector<DisplayId> displayIds, boo
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "dms:SetFreeze(%" PRIu64")", displayId);
         {
             WLOGI("setfreeze display %{public}" PRIu64"", displayId);
-            std::lock_guard<std::recursive_mutex> lock(mutex_);
+            std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
             auto iter = abstractDisplayMap_.find(displayId);
             if (iter == abstractDisplayMap_.end()) {
                 WLOGE("setfreeze fail, cannot get display %{public}" PRIu64"", displayId);
@@ -580,7 +626,7 @@ std::map<DisplayId, sptr<DisplayInfo>> AbstractDisplayController::GetAllDisplayI
 {
     ScreenId screenGroupId = info->GetScreenGroupId();
     std::map<DisplayId, sptr<DisplayInfo>> displayInfoMap;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     for (auto& iter : abstractDisplayMap_) {
         sptr<AbstractDisplay> display = iter.second;
         if (display->GetAbstractScreenGroupId() == screenGroupId) {
@@ -36,7 +36,7 @@ namespace {
     const std::string CONTROLLER_THREAD_ID = "abstract_screen_controller_thread";
 }
 
-AbstractScreenController::AbstractScreenController(std::recursive_mutex& mutex)
+AbstractScreenController::AbstractScreenController(TrackedRecursiveMutex& mutex)
     : mutex_(mutex), rsInterface_(RSInterfaces::GetInstance())
 {
     auto runner = AppExecFwk::EventRunner::Create(CONTROLLER_THREAD_ID);
@@ -67,7 +67,7 @@ void AbstractScreenController::RegisterRsScreenConnectionChangeListener()
 
 std::vector<ScreenId> AbstractScreenController::GetAllScreenIds() const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     std::vector<ScreenId> res;
     for (const auto& iter : dmsScreenMap_) {
         res.emplace_back(iter.first);
@@ -78,7 +78,7 @@ std::vector<ScreenId> AbstractScreenController::GetAllScreenIds() const
 std::vector<ScreenId> AbstractScreenController::GetShotScreenIds(std::vector<ScreenId> mirrorScreenIds) const
 {
     WLOGI("GetShotScreenIds");
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     std::vector<ScreenId> screenIds;
     for (ScreenId screenId : mirrorScreenIds) {
         auto iter = std::find(screenIds.begin(), screenIds.end(), screenId);
@@ -97,7 +97,7 @@ std::vector<ScreenId> AbstractScreenController::GetShotScreenIds(std::vector<Scr
 std::vector<ScreenId> AbstractScreenController::GetAllExpandOrMirrorScreenIds(
     std::vector<ScreenId> mirrorScreenIds) const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     std::vector<ScreenId> screenIds;
     for (ScreenId screenId : mirrorScreenIds) {
         auto screenIdIter = std::find(screenIds.begin(), screenIds.end(), screenId);
@@ -155,7 +155,7 @@ void AbstractScreenController::UpdateRSTree(ScreenId dmsScreenId, std::shared_pt
 sptr<AbstractScreen> AbstractScreenController::GetAbstractScreen(ScreenId dmsScreenId) const
 {
     WLOGI("GetAbstractScreen: screenId: %{public}" PRIu64"", dmsScreenId);
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     auto iter = dmsScreenMap_.find(dmsScreenId);
     if (iter == dmsScreenMap_.end()) {
         WLOGE("did not find screen:%{public}" PRIu64"", dmsScreenId);
@@ -166,7 +166,7 @@ sptr<AbstractScreen> AbstractScreenController::GetAbstractScreen(ScreenId dmsScr
 
 sptr<AbstractScreenGroup> AbstractScreenController::GetAbstractScreenGroup(ScreenId dmsScreenId)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     auto iter = dmsScreenGroupMap_.find(dmsScreenId);
     if (iter == dmsScreenGroupMap_.end()) {
         WLOGE("did not find screen:%{public}" PRIu64"", dmsScreenId);
@@ -184,7 +184,7 @@ ScreenId AbstractScreenController::GetDefaultAbstractScreenId()
         WLOGFW("GetDefaultAbstractScreenId, rsDefaultId is invalid.");
         return SCREEN_ID_INVALID;
     }
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     ScreenId defaultDmsScreenId;
     if (screenIdManager_.ConvertToDmsScreenId(defaultRsScreenId_, defaultDmsScreenId)) {
         WLOGI("GetDefaultAbstractScreenId, screen:%{public}" PRIu64"", defaultDmsScreenId);
@@ -197,19 +197,19 @@ ScreenId AbstractScreenController::GetDefaultAbstractScreenId()
 
 ScreenId AbstractScreenController::ConvertToRsScreenId(ScreenId dmsScreenId) const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     return screenIdManager_.ConvertToRsScreenId(dmsScreenId);
 }
 
 ScreenId AbstractScreenController::ConvertToDmsScreenId(ScreenId rsScreenId) const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     return screenIdManager_.ConvertToDmsScreenId(rsScreenId);
 }
 
 void AbstractScreenController::RegisterAbstractScreenCallback(sptr<AbstractScreenCallback> cb)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     abstractScreenCallback_ = cb;
 }
 
@@ -238,7 +238,7 @@ void AbstractScreenController::ScreenConnectionInDisplayInit(sptr<AbstractScreen
 {
     std::map<ScreenId, sptr<AbstractScreen>> dmsScreenMap;
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         dmsScreenMap = dmsScreenMap_;
         if (dmsScreenMap_.empty()) {
             return;
@@ -255,7 +255,7 @@ void AbstractScreenController::ScreenConnectionInDisplayInit(sptr<AbstractScreen
 
 void AbstractScreenController::ProcessScreenConnected(ScreenId rsScreenId)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     if (!screenIdManager_.HasRsScreenId(rsScreenId)) {
         WLOGFD("connect new screen");
         auto absScreen = InitAndGetScreen(rsScreenId);
@@ -302,7 +302,7 @@ void AbstractScreenController::ProcessScreenDisconnected(ScreenId rsScreenId)
 {
     WLOGFI("disconnect screen, screenId=%{public}" PRIu64"", rsScreenId);
     ScreenId dmsScreenId;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     if (!screenIdManager_.ConvertToDmsScreenId(rsScreenId, dmsScreenId)) {
         WLOGFE("disconnect screen, screenId=%{public}" PRIu64" is not in rs2DmsScreenIdMap_", rsScreenId);
         return;
@@ -489,7 +489,7 @@ ScreenId AbstractScreenController::CreateVirtualScreen(VirtualScreenOption optio
     if (rsId == SCREEN_ID_INVALID) {
         return SCREEN_ID_INVALID;
     }
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     ScreenId dmsScreenId = SCREEN_ID_INVALID;
     if (!screenIdManager_.ConvertToDmsScreenId(rsId, dmsScreenId)) {
         dmsScreenId = screenIdManager_.CreateAndGetNewScreenId(rsId);
@@ -530,7 +530,7 @@ ScreenId AbstractScreenController::CreateVirtualScreen(VirtualScreenOption optio
 DMError AbstractScreenController::DestroyVirtualScreen(ScreenId screenId)
 {
     WLOGFI("AbstractScreenController::DestroyVirtualScreen");
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     ScreenId rsScreenId = SCREEN_ID_INVALID;
     screenIdManager_.ConvertToRsScreenId(screenId, rsScreenId);
 
@@ -776,7 +776,7 @@ bool AbstractScreenController::SetScreenActiveMode(ScreenId screenId, uint32_t m
     }
     uint32_t usedModeId = 0;
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         auto screen = GetAbstractScreen(screenId);
         if (screen == nullptr) {
             WLOGFE("SetScreenActiveMode: Get AbstractScreen failed");
@@ -809,7 +809,7 @@ void AbstractScreenController::ProcessScreenModeChanged(ScreenId dmsScreenId)
     sptr<AbstractScreen> absScreen = nullptr;
     sptr<AbstractScreenCallback> absScreenCallback = nullptr;
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         auto dmsScreenMapIter = dmsScreenMap_.find(dmsScreenId);
         if (dmsScreenMapIter == dmsScreenMap_.end()) {
             WLOGFE("dmsScreenId=%{public}" PRIu64" is not in dmsScreenMap", dmsScreenId);
@@ -840,7 +840,7 @@ bool AbstractScreenController::MakeMirror(ScreenId screenId, std::vector<ScreenI
     WLOGFI("GetAbstractScreenGroup start");
     auto group = GetAbstractScreenGroup(screen->groupDmsId_);
     if (group == nullptr) {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         sptr<AbstractScreenGroup> group = AddToGroupLocked(screen);
         if (group == nullptr) {
             WLOGFE("group is nullptr");
@@ -869,7 +869,7 @@ void AbstractScreenController::ChangeScreenGroup(sptr<AbstractScreenGroup> group
     std::map<ScreenId, bool> removeChildResMap;
     std::vector<ScreenId> addScreens;
     std::vector<Point> addChildPos;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     for (uint64_t i = 0; i != screens.size(); i++) {
         ScreenId screenId = screens[i];
         WLOGFI("ChangeScreenGroup: screenId: %{public}" PRIu64"", screenId);
@@ -1011,7 +1011,7 @@ bool AbstractScreenController::OnRemoteDied(const sptr<IRemoteObject>& agent)
     if (agent == nullptr) {
         return false;
     }
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     auto agentIter = screenAgentMap_.find(agent);
     if (agentIter != screenAgentMap_.end()) {
         while (screenAgentMap_[agent].size() > 0) {
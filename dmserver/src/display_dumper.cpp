@@ -38,7 +38,7 @@ namespace {
 }
 
 DisplayDumper::DisplayDumper(const sptr<AbstractDisplayController>& abstractDisplayController,
-    const sptr<AbstractScreenController>& abstractScreenController, std::recursive_mutex& mutex)
+    const sptr<AbstractScreenController>& abstractScreenController, TrackedRecursiveMutex& mutex)
     : abstractDisplayController_(abstractDisplayController), abstractScreenController_(abstractScreenController),
     mutex_(mutex)
 {
@@ -161,7 +161,7 @@ DMError DisplayDumper::DumpAllScreenInfo(std::string& dumpInfo) const
     oss << "ScreenName           Type     IsGroup DmsId RsId                 ActiveIdx VPR Rotation Orientation "
         << "RequestOrientation NodeId               IsMirrored MirrorNodeId"
         << std::endl;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     for (ScreenId screenId : screenIds) {
         auto screen = abstractScreenController_->GetAbstractScreen(screenId);
         if (screen == nullptr) {
@@ -250,7 +250,7 @@ DMError DisplayDumper::DumpAllDisplayInfo(std::string& dumpInfo) const
         << std::endl;
     oss << "DisplayId ScreenId RefreshRate VPR Rotation Orientation FreezeFlag [ x    y    w    h    ]"
         << std::endl;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     for (DisplayId displayId : displayIds) {
         auto display = abstractDisplayController_->GetAbstractDisplay(displayId);
         if (display == nullptr) {
@@ -259,6 +259,7 @@ DMError DisplayDumper::DumpAllDisplayInfo(std::string& dumpInfo) const
         }
         GetDisplayInfo(display, oss);
     }
+    oss << "DMS lock " << mutex_.GetContentionInfo() << std::endl;
     dumpInfo.append(oss.str());
     return DMError::DM_OK;
 }
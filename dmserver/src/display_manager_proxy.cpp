@@ -960,9 +960,7 @@ ScreenId DisplayManagerProxy::MakeExpand(std::vector<ScreenId> screenId, std::ve
         WLOGFE("MakeExpand: write screenId failed");
         return SCREEN_ID_INVALID;
     }
-    if (!MarshallingHelper::MarshallingVectorObj<Point>(data, startPoint, [](Parcel& parcel, const Point& point) {
-            return parcel.WriteInt32(point.posX_) && parcel.WriteInt32(point.posY_);
-        })) {
+    if (!MarshallingHelper::MarshallingVectorPodObj<Point>(data, startPoint)) {
         WLOGFE("MakeExpand: write startPoint failed");
         return SCREEN_ID_INVALID;
     }
@@ -434,7 +434,7 @@ ScreenId DisplayManagerService::GetScreenIdByDisplayId(DisplayId displayId) cons
 
 DisplayState DisplayManagerService::GetDisplayState(DisplayId displayId)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
     return displayPowerController_->GetDisplayState(displayId);
 }
 
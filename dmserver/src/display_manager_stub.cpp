@@ -223,9 +223,7 @@ int32_t DisplayManagerStub::OnRemoteRequest(uint32_t code, MessageParcel &data,
                 break;
             }
             std::vector<Point> startPoint;
-            if (!MarshallingHelper::UnmarshallingVectorObj<Point>(data, startPoint, [](Parcel& parcel, Point& point) {
-                    return parcel.ReadInt32(point.posX_) && parcel.ReadInt32(point.posY_);
-                })) {
+            if (!MarshallingHelper::UnmarshallingVectorPodObj<Point>(data, startPoint)) {
                 WLOGE("fail to receive startPoint in stub.");
                 break;
             }
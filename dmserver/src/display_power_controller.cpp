@@ -36,7 +36,7 @@ bool DisplayPowerController::SetDisplayState(DisplayState state)
 {
     WLOGFI("state:%{public}u", state);
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         if (displayState_ == state) {
             WLOGFE("state is already set");
             return false;
@@ -46,7 +46,7 @@ bool DisplayPowerController::SetDisplayState(DisplayState state)
         case DisplayState::ON: {
             bool isKeyguardDrawn;
             {
-                std::lock_guard<std::recursive_mutex> lock(mutex_);
+                std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
                 displayState_ = state;
                 isKeyguardDrawn = isKeyguardDrawn_;
             }
@@ -61,7 +61,7 @@ bool DisplayPowerController::SetDisplayState(DisplayState state)
         }
         case DisplayState::OFF: {
             {
-                std::lock_guard<std::recursive_mutex> lock(mutex_);
+                std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
                 displayState_ = state;
             }
             DisplayManagerAgentController::GetInstance().NotifyDisplayPowerEvent(DisplayPowerEvent::DISPLAY_OFF,
@@ -90,12 +90,12 @@ void DisplayPowerController::NotifyDisplayEvent(DisplayEvent event)
         displayStateChangeListener_(DISPLAY_ID_INVALID, nullptr, emptyMap, DisplayStateChangeType::BEFORE_UNLOCK);
         DisplayManagerAgentController::GetInstance().NotifyDisplayPowerEvent(DisplayPowerEvent::DESKTOP_READY,
             EventStatus::BEGIN);
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         isKeyguardDrawn_ = false;
         return;
     }
     if (event == DisplayEvent::KEYGUARD_DRAWN) {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex_);
         isKeyguardDrawn_ = true;
     }
 }
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tracked_recursive_mutex.h"
+
+#include <sstream>
+
+namespace OHOS::Rosen {
+namespace {
+    uint64_t ElapsedUs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+    }
+
+    void UpdateMax(std::atomic<uint64_t>& maxValue, uint64_t value)
+    {
+        uint64_t current = maxValue.load(std::memory_order_relaxed);
+        while (value > current && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+void TrackedRecursiveMutex::lock()
+{
+    if (mutex_.try_lock()) {
+        OnAcquired(std::chrono::steady_clock::now());
+        return;
+    }
+    auto waitStartTime = std::chrono::steady_clock::now();
+    mutex_.lock();
+    auto now = std::chrono::steady_clock::now();
+    uint64_t waitUs = ElapsedUs(waitStartTime, now);
+    contendedCount_.fetch_add(1, std::memory_order_relaxed);
+    totalWaitUs_.fetch_add(waitUs, std::memory_order_relaxed);
+    UpdateMax(maxWaitUs_, waitUs);
+    OnAcquired(now);
+}
+
+bool TrackedRecursiveMutex::try_lock()
+{
+    if (!mutex_.try_lock()) {
+        return false;
+    }
+    OnAcquired(std::chrono::steady_clock::now());
+    return true;
+}
+
+void TrackedRecursiveMutex::unlock()
+{
+    if (--depth_ == 0) {
+        UpdateMax(maxHoldUs_, ElapsedUs(holdStartTime_, std::chrono::steady_clock::now()));
+    }
+    mutex_.unlock();
+}
+
+void TrackedRecursiveMutex::OnAcquired(std::chrono::steady_clock::time_point now)
+{
+    if (depth_++ == 0) {
+        holdStartTime_ = now;
+        lockCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::string TrackedRecursiveMutex::GetContentionInfo() const
+{
+    std::ostringstream oss;
+    oss << "lock: " << lockCount_.load(std::memory_order_relaxed)
+        << ", contended: " << contendedCount_.load(std::memory_order_relaxed)
+        << ", total wait(us): " << totalWaitUs_.load(std::memory_order_relaxed)
+        << ", max wait(us): " << maxWaitUs_.load(std::memory_order_relaxed)
+        << ", max hold(us): " << maxHoldUs_.load(std::memory_order_relaxed);
+    return oss.str();
+}
+} // namespace OHOS::Rosen
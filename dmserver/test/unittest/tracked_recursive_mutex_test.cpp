@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "tracked_recursive_mutex.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Rosen {
+class TrackedRecursiveMutexTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+};
+
+void TrackedRecursiveMutexTest::SetUpTestCase()
+{
+}
+
+void TrackedRecursiveMutexTest::TearDownTestCase()
+{
+}
+
+void TrackedRecursiveMutexTest::SetUp()
+{
+}
+
+void TrackedRecursiveMutexTest::TearDown()
+{
+}
+
+namespace {
+/**
+ * @tc.name: RecursiveLock
+ * @tc.desc: nested locks of the owner count as one uncontended lock
+ * @tc.type: FUNC
+ */
+HWTEST_F(TrackedRecursiveMutexTest, RecursiveLock, Function | SmallTest | Level2)
+{
+    TrackedRecursiveMutex mutex;
+    {
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex);
+        std::lock_guard<TrackedRecursiveMutex> nestedLock(mutex);
+        ASSERT_TRUE(mutex.try_lock());
+        mutex.unlock();
+    }
+    std::string info = mutex.GetContentionInfo();
+    ASSERT_NE(std::string::npos, info.find("lock: 1, contended: 0"));
+
+    std::lock_guard<TrackedRecursiveMutex> lock(mutex);
+    ASSERT_NE(std::string::npos, mutex.GetContentionInfo().find("lock: 2, contended: 0"));
+}
+
+/**
+ * @tc.name: ContendedLock
+ * @tc.desc: a lock that waits for another owner counts as contended, a failed try_lock does not
+ * @tc.type: FUNC
+ */
+HWTEST_F(TrackedRecursiveMutexTest, ContendedLock, Function | SmallTest | Level2)
+{
+    TrackedRecursiveMutex mutex;
+    std::atomic<bool> isWaiting { false };
+    bool isTryLocked = true;
+    mutex.lock();
+    std::thread waiter([&mutex, &isWaiting, &isTryLocked]() {
+        isTryLocked = mutex.try_lock();
+        isWaiting = true;
+        std::lock_guard<TrackedRecursiveMutex> lock(mutex);
+    });
+    while (!isWaiting) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: let the waiter block on the mutex
+    mutex.unlock();
+    waiter.join();
+
+    ASSERT_FALSE(isTryLocked);
+    std::string info = mutex.GetContentionInfo();
+    ASSERT_NE(std::string::npos, info.find("lock: 2, contended: 1"));
+    ASSERT_EQ(std::string::npos, info.find("total wait(us): 0,"));
+}
+}
+} // namespace Rosen
+} // namespace OHOS
@@ -15,92 +15,98 @@
 #ifndef ATOMIC_MAP_H
 #define ATOMIC_MAP_H
 
-#include <atomic>
+#include <array>
+#include <functional>
 #include <map>
-#include "nocopyable.h"
+#include <mutex>
+#include <shared_mutex>
+#include "noncopyable.h"
 
 namespace OHOS {
 namespace Rosen {
-template<class Key, class Value>
+/*
+ * Map shared by binder threads. Keys are spread over shards guarded by their own reader-writer lock,
+ * so unrelated keys do not contend and lookups run in parallel; a waiting thread blocks in the lock
+ * instead of spinning. Lookups return copies, nothing refers into the map after the lock is released.
+ */
+template<class Key, class Value, size_t ShardNum = 16>
 class AtomicMap {
 public:
+    AtomicMap() = default;
+    WM_DISALLOW_COPY_AND_MOVE(AtomicMap);
+    ~AtomicMap() = default;
+
     void insert(const std::pair<Key, Value>& kv)
     {
-        locked();
-        data_.insert(kv);
-        unlocked();
+        Shard& shard = GetShard(kv.first);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        shard.data_.insert(kv);
     }
 
     void erase(const Key& key)
     {
-        locked();
-        data_.erase(key);
-        unlocked();
+        Shard& shard = GetShard(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        shard.data_.erase(key);
     }
 
-    auto find(Key k)
+    bool find(const Key& key, Value& value) const
     {
-        locked();
-        auto key = data_.find(k);
-        unlocked();
-        return key;
+        const Shard& shard = GetShard(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+        auto iter = shard.data_.find(key);
+        if (iter == shard.data_.end()) {
+            return false;
+        }
+        value = iter->second;
+        return true;
     }
 
-    int count(Key k)
+    int count(const Key& key) const
     {
-        locked();
-        int size = data_.count(k);
-        unlocked();
-        return size;
+        const Shard& shard = GetShard(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+        return static_cast<int>(shard.data_.count(key));
     }
 
-    bool isExistAndRemove(Key k, uint32_t value)
+    bool isExistAndRemove(const Key& key, const Value& value)
     {
-        locked();
-        if (data_.count(k) <= 0) {
-            unlocked();
+        Shard& shard = GetShard(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        auto iter = shard.data_.find(key);
+        if (iter == shard.data_.end() || !(iter->second == value)) {
             return false;
         }
-        if (data_[k] == value) {
-            data_.erase(k);
-            unlocked();
-            return true;
-        }
-        unlocked();
-        return false;
+        shard.data_.erase(iter);
+        return true;
     }
 
-    bool isExist(Key k, uint32_t value)
+    bool isExist(const Key& key, const Value& value) const
     {
-        locked();
-        if (data_.count(k) <= 0) {
-            unlocked();
-            return false;
-        }
-        if (data_[k] == value) {
-            unlocked();
-            return true;
-        }
-        unlocked();
-        return false;
+        const Shard& shard = GetShard(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+        auto iter = shard.data_.find(key);
+        return iter != shard.data_.end() && iter->second == value;
     }
+
 private:
-    void locked()
+    struct Shard {
+        mutable std::shared_mutex mutex_;
+        std::map<Key, Value> data_;
+    };
+
+    Shard& GetShard(const Key& key)
     {
-        bool expect = false;
-        while (!isWritingOrReading_.compare_exchange_weak(expect, true, std::memory_order_relaxed)) {
-            expect = false;
-        }
+        return shards_[std::hash<Key>()(key) % ShardNum];
     }
 
-    void unlocked()
+    const Shard& GetShard(const Key& key) const
     {
-        isWritingOrReading_.store(false);
+        return shards_[std::hash<Key>()(key) % ShardNum];
     }
 
-    std::map<Key, Value> data_;
-    std::atomic<bool> isWritingOrReading_ { false };
+    std::array<Shard, ShardNum> shards_;
 };
 } // Rosen
 } // OHOS
-#endif // ATOMIC_MAP_H
\ No newline at end of file
+#endif // ATOMIC_MAP_H
@@ -16,7 +16,9 @@
 #ifndef OHOS_ROSEN_CLIENT_AGENT_MANAGER_H
 #define OHOS_ROSEN_CLIENT_AGENT_MANAGER_H
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include "agent_death_recipient.h"
@@ -24,6 +26,45 @@
 
 namespace OHOS {
 namespace Rosen {
+// an immutable agent set of one type as published when it was taken, iterating it needs no lock
+template <typename T1>
+class ClientAgentSnapshot {
+public:
+    using AgentSet = std::set<sptr<T1>>;
+    explicit ClientAgentSnapshot(const std::shared_ptr<const AgentSet>& agents)
+        : agents_(agents != nullptr ? agents : GetEmptyAgents()) {}
+
+    typename AgentSet::const_iterator begin() const
+    {
+        return agents_->begin();
+    }
+    typename AgentSet::const_iterator end() const
+    {
+        return agents_->end();
+    }
+    bool empty() const
+    {
+        return agents_->empty();
+    }
+    size_t size() const
+    {
+        return agents_->size();
+    }
+
+private:
+    static const std::shared_ptr<const AgentSet>& GetEmptyAgents()
+    {
+        static const std::shared_ptr<const AgentSet> emptyAgents = std::make_shared<const AgentSet>();
+        return emptyAgents;
+    }
+
+    std::shared_ptr<const AgentSet> agents_;
+};
+
+/*
+ * Agents are published copy-on-write: registration and agent death build a new version of the
+ * changed set under the mutex and swap it in, while notifications take a snapshot without locking.
+ */
 template <typename T1, typename T2>
 class ClientAgentContainer {
 public:
@@ -32,11 +73,14 @@ public:
 
     bool RegisterAgent(const sptr<T1>& agent, T2 type);
     bool UnregisterAgent(const sptr<T1>& agent, T2 type);
-    std::set<sptr<T1>> GetAgentsByType(T2 type);
+    ClientAgentSnapshot<T1> GetAgentsByType(T2 type);
 
 private:
+    using AgentSet = std::set<sptr<T1>>;
+    using AgentMap = std::map<T2, std::shared_ptr<const AgentSet>>;
+
     void RemoveAgent(const sptr<IRemoteObject>& remoteObject);
-    bool UnregisterAgentLocked(std::set<sptr<T1>>& agents, const sptr<IRemoteObject>& agent);
+    bool UnregisterAgentLocked(AgentMap& agentMap, T2 type, const sptr<IRemoteObject>& agent);
 
     static constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "ClientAgentContainer"};
 
@@ -51,8 +95,9 @@ private:
         sptr<IRemoteObject> remoteObject_;
     };
 
-    std::recursive_mutex mutex_;
-    std::map<T2, std::set<sptr<T1>>> agentMap_;
+    // serializes writers only, readers load agentMap_ atomically
+    std::mutex mutex_;
+    std::shared_ptr<const AgentMap> agentMap_ { std::make_shared<const AgentMap>() };
     sptr<AgentDeathRecipient> deathRecipient_;
 };
 
@@ -63,13 +108,17 @@ ClientAgentContainer<T1, T2>::ClientAgentContainer() : deathRecipient_(
 template<typename T1, typename T2>
 bool ClientAgentContainer<T1, T2>::RegisterAgent(const sptr<T1>& agent, T2 type)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    auto iter = std::find_if(agentMap_[type].begin(), agentMap_[type].end(), finder_t(agent->AsObject()));
-    if (iter != agentMap_[type].end()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto agentMap = std::make_shared<AgentMap>(*agentMap_);
+    auto iter = agentMap->find(type);
+    auto agents = (iter != agentMap->end()) ? std::make_shared<AgentSet>(*iter->second) : std::make_shared<AgentSet>();
+    if (std::find_if(agents->begin(), agents->end(), finder_t(agent->AsObject())) != agents->end()) {
         WLOGFW("failed to register agent");
         return false;
     }
-    agentMap_[type].insert(agent);
+    agents->insert(agent);
+    (*agentMap)[type] = agents;
+    std::atomic_store(&agentMap_, std::shared_ptr<const AgentMap>(agentMap));
     if (deathRecipient_ == nullptr || !agent->AsObject()->AddDeathRecipient(deathRecipient_)) {
         WLOGFI("failed to add death recipient");
     }
@@ -79,38 +128,51 @@ bool ClientAgentContainer<T1, T2>::RegisterAgent(const sptr<T1>& agent, T2 type)
 template<typename T1, typename T2>
 bool ClientAgentContainer<T1, T2>::UnregisterAgent(const sptr<T1>& agent, T2 type)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    if (agent == nullptr || agentMap_.count(type) == 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (agent == nullptr || agentMap_->count(type) == 0) {
         WLOGFE("agent or type is invalid");
         return false;
     }
-    auto& agents = agentMap_.at(type);
-    bool ret = UnregisterAgentLocked(agents, agent->AsObject());
+    auto agentMap = std::make_shared<AgentMap>(*agentMap_);
+    bool ret = UnregisterAgentLocked(*agentMap, type, agent->AsObject());
+    if (ret) {
+        std::atomic_store(&agentMap_, std::shared_ptr<const AgentMap>(agentMap));
+    } else {
+        WLOGFW("could not find this agent");
+    }
     agent->AsObject()->RemoveDeathRecipient(deathRecipient_);
     return ret;
 }
 
 template<typename T1, typename T2>
-std::set<sptr<T1>> ClientAgentContainer<T1, T2>::GetAgentsByType(T2 type)
+ClientAgentSnapshot<T1> ClientAgentContainer<T1, T2>::GetAgentsByType(T2 type)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    if (agentMap_.count(type) == 0) {
+    auto agentMap = std::atomic_load(&agentMap_);
+    auto iter = agentMap->find(type);
+    if (iter == agentMap->end()) {
         WLOGFI("no such type of agent registered! type:%{public}u", type);
-        return std::set<sptr<T1>>();
+        return ClientAgentSnapshot<T1>(nullptr);
     }
-    return agentMap_.at(type);
+    return ClientAgentSnapshot<T1>(iter->second);
 }
 
 template<typename T1, typename T2>
-bool ClientAgentContainer<T1, T2>::UnregisterAgentLocked(std::set<sptr<T1>>& agents,
+bool ClientAgentContainer<T1, T2>::UnregisterAgentLocked(AgentMap& agentMap, T2 type,
     const sptr<IRemoteObject>& agent)
 {
+    auto mapIter = agentMap.find(type);
+    if (mapIter == agentMap.end()) {
+        return false;
+    }
+    const AgentSet& agents = *mapIter->second;
     auto iter = std::find_if(agents.begin(), agents.end(), finder_t(agent));
     if (iter == agents.end()) {
-        WLOGFW("could not find this agent");
         return false;
     }
-    agents.erase(iter);
+    // the published set may still be iterated by a reader, so a new one without the agent replaces it
+    auto newAgents = std::make_shared<AgentSet>(agents);
+    newAgents->erase(*iter);
+    mapIter->second = newAgents;
     WLOGFI("agent unregistered");
     return true;
 }
@@ -119,11 +181,15 @@ template<typename T1, typename T2>
 void ClientAgentContainer<T1, T2>::RemoveAgent(const sptr<IRemoteObject>& remoteObject)
 {
     WLOGFI("RemoveAgent");
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    for (auto& elem : agentMap_) {
-        if (UnregisterAgentLocked(elem.second, remoteObject)) {
-            break;
-        }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto agentMap = std::make_shared<AgentMap>(*agentMap_);
+    bool isRemoved = false;
+    // a dead agent may have registered for several types
+    for (auto& elem : *agentMap) {
+        isRemoved = UnregisterAgentLocked(*agentMap, elem.first, remoteObject) || isRemoved;
+    }
+    if (isRemoved) {
+        std::atomic_store(&agentMap_, std::shared_ptr<const AgentMap>(agentMap));
     }
     remoteObject->RemoveDeathRecipient(deathRecipient_);
 }
@@ -44,7 +44,7 @@ protected:
     {
         std::unique_lock <std::mutex> lock(mutex_);
         Call(t);
-        conditionVariable_.notify_one();
+        conditionVariable_.notify_all();
     }
 
 private:
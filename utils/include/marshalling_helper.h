@@ -16,7 +16,12 @@
 #ifndef FOUNDATION_MARSHALLING_HELPER_H
 #define FOUNDATION_MARSHALLING_HELPER_H
 
+#include <climits>
+#include <functional>
 #include <parcel.h>
+#include <securec.h>
+#include <type_traits>
+#include <vector>
 
 namespace OHOS::Rosen {
 class MarshallingHelper : public Parcelable {
@@ -116,6 +121,65 @@ public:
         }
         return true;
     }
+
+    // T must be trivially copyable and free of padding, its bytes are copied to the parcel as they are
+    template<class T>
+    static bool MarshallingPodObj(Parcel &parcel, const T& data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types are written as a buffer");
+        return parcel.WriteBuffer(&data, sizeof(T));
+    }
+
+    template<class T>
+    static bool UnmarshallingPodObj(Parcel &parcel, T& data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types are read from a buffer");
+        const uint8_t* buffer = parcel.ReadBuffer(sizeof(T));
+        if (buffer == nullptr) {
+            return false;
+        }
+        return memcpy_s(&data, sizeof(T), buffer, sizeof(T)) == EOK;
+    }
+
+    // the length followed by all elements in one buffer, see MarshallingPodObj for the requirements on T
+    template<class T>
+    static bool MarshallingVectorPodObj(Parcel &parcel, const std::vector<T>& data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types are written as a buffer");
+        if (data.size() > INT_MAX / sizeof(T)) {
+            return false;
+        }
+        if (!parcel.WriteInt32(static_cast<int32_t>(data.size()))) {
+            return false;
+        }
+        return data.empty() || parcel.WriteBuffer(data.data(), data.size() * sizeof(T));
+    }
+
+    template<class T>
+    static bool UnmarshallingVectorPodObj(Parcel &parcel, std::vector<T>& data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types are read from a buffer");
+        int32_t len = parcel.ReadInt32();
+        if (len < 0) {
+            return false;
+        }
+        size_t size = static_cast<size_t>(len);
+        // checked before anything is allocated, a bogus length must not reserve more than the parcel holds
+        if ((size > parcel.GetReadableBytes() / sizeof(T)) || (size > data.max_size())) {
+            return false;
+        }
+        data.clear();
+        if (size == 0) {
+            return true;
+        }
+        size_t bytes = size * sizeof(T);
+        const uint8_t* buffer = parcel.ReadBuffer(bytes);
+        if (buffer == nullptr) {
+            return false;
+        }
+        data.resize(size);
+        return memcpy_s(data.data(), bytes, buffer, bytes) == EOK;
+    }
 };
 } // namespace OHOS::Rosen
 #endif // FOUNDATION_MARSHALLING_HELPER_H
\ No newline at end of file
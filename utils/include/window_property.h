@@ -118,20 +118,27 @@ public:
     WindowSizeLimits GetUpdatedSizeLimits() const;
     const TransformHelper::Matrix4& GetTransformMat() const;
 
+    // versioned compact format: packed fixed size fields, then only the blocks that differ from the defaults
     virtual bool Marshalling(Parcel& parcel) const override;
     static WindowProperty* Unmarshalling(Parcel& parcel);
 
+    // action may combine several PropertyChangeAction bits, fields are written in ascending bit order
     bool Write(Parcel& parcel, PropertyChangeAction action);
     void Read(Parcel& parcel, PropertyChangeAction action);
 private:
+    bool WriteActionField(Parcel& parcel, PropertyChangeAction action);
+    void ReadActionField(Parcel& parcel, PropertyChangeAction action);
     bool MapMarshalling(Parcel& parcel) const;
-    static void MapUnmarshalling(Parcel& parcel, WindowProperty* property);
+    static bool MapUnmarshalling(Parcel& parcel, WindowProperty* property);
     bool MarshallingTouchHotAreas(Parcel& parcel) const;
-    static void UnmarshallingTouchHotAreas(Parcel& parcel, WindowProperty* property);
+    static bool UnmarshallingTouchHotAreas(Parcel& parcel, WindowProperty* property);
     bool MarshallingTransform(Parcel& parcel) const;
-    static void UnmarshallingTransform(Parcel& parcel, WindowProperty* property);
+    static bool UnmarshallingTransform(Parcel& parcel, WindowProperty* property);
     bool MarshallingWindowSizeLimits(Parcel& parcel) const;
-    static void UnmarshallingWindowSizeLimits(Parcel& parcel, WindowProperty* property);
+    static bool UnmarshallingWindowSizeLimits(Parcel& parcel, WindowProperty* property);
+    bool UnmarshallingBlocks(Parcel& parcel, uint32_t presentBlocks);
+    uint32_t PackBoolFields() const;
+    void UnpackBoolFields(uint32_t packed);
 
     std::string windowName_;
     Rect requestRect_ { 0, 0, 0, 0 }; // window rect requested by the client (without decoration size)
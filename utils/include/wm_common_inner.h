@@ -97,6 +97,15 @@ struct GetSnapshotTimeConfig {
     std::atomic<uint32_t> above200msTimes_;
 };
 
+struct MoveDragLatencyConfig {
+    std::atomic<uint32_t> frameTimes_;
+    std::atomic<uint32_t> below8msTimes_;
+    std::atomic<uint32_t> below16msTimes_;
+    std::atomic<uint32_t> below33msTimes_;
+    std::atomic<uint32_t> below50msTimes_;
+    std::atomic<uint32_t> above50msTimes_;
+};
+
 struct ModeChangeHotZonesConfig {
     bool isModeChangeHotZoneConfigured_;
     uint32_t fullscreenRange_;
@@ -15,6 +15,8 @@
 
 #include "cutout_info.h"
 
+#include "marshalling_helper.h"
+
 namespace OHOS::Rosen {
 CutoutInfo::CutoutInfo(const std::vector<Rect>& boundingRects,
     WaterfallDisplayAreaRects waterfallDisplayAreaRects) : waterfallDisplayAreaRects_(waterfallDisplayAreaRects),
@@ -55,37 +57,12 @@ CutoutInfo *CutoutInfo::Unmarshalling(Parcel &parcel)
 
 bool CutoutInfo::WriteBoundingRectsVector(const std::vector<Rect>& boundingRects, Parcel &parcel) const
 {
-    if (!parcel.WriteUint32(static_cast<uint32_t>(boundingRects.size()))) {
-        return false;
-    }
-    for (Rect rect : boundingRects) {
-        if (!(parcel.WriteInt32(rect.posX_) && parcel.WriteInt32(rect.posY_) &&
-            parcel.WriteUint32(rect.width_) && parcel.WriteUint32(rect.height_))) {
-            return false;
-        }
-    }
-    return true;
+    return MarshallingHelper::MarshallingVectorPodObj<Rect>(parcel, boundingRects);
 }
 
 bool CutoutInfo::ReadBoundingRectsVector(std::vector<Rect>& unmarBoundingRects, Parcel &parcel)
 {
-    uint32_t size;
-    if (!parcel.ReadUint32(size)) {
-        return false;
-    }
-    for (uint32_t index = 0; index < size; index++) {
-        int32_t posX;
-        int32_t posY;
-        uint32_t width;
-        uint32_t height;
-        if (!(parcel.ReadInt32(posX) && parcel.ReadInt32(posY) &&
-            parcel.ReadUint32(width) && parcel.ReadUint32(height))) {
-            return false;
-        }
-        Rect rect = {posX, posY, width, height};
-        unmarBoundingRects.push_back(rect);
-    }
-    return true;
+    return MarshallingHelper::UnmarshallingVectorPodObj<Rect>(parcel, unmarBoundingRects);
 }
 
 bool CutoutInfo::ReadWaterfallDisplayAreaRects(WaterfallDisplayAreaRects& waterfallDisplayAreaRects, Parcel &parcel)
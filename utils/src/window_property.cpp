@@ -14,11 +14,69 @@
  */
 
 #include "window_property.h"
+
+#include "marshalling_helper.h"
 #include "window_helper.h"
+#include "window_manager_hilog.h"
 #include "wm_common.h"
 
 namespace OHOS {
 namespace Rosen {
+namespace {
+    constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WindowProperty"};
+    // bumped whenever the layout of the marshalled property changes
+    constexpr uint32_t WINDOW_PROPERTY_PARCEL_VERSION = 2;
+
+    // variable or rarely changed fields, marshalled only when they differ from a default constructed property
+    enum class WindowPropertyBlock : uint32_t {
+        NAME = 1,
+        WINDOW_RECT = 1 << 1,
+        REQUEST_RECT = 1 << 2,
+        ORIGIN_RECT = 1 << 3,
+        HIT_OFFSET = 1 << 4,
+        SYSTEM_BAR_PROPS = 1 << 5,
+        TOUCH_HOT_AREAS = 1 << 6,
+        TRANSFORM = 1 << 7,
+        SIZE_LIMITS = 1 << 8,
+    };
+
+    // fixed size fields, always marshalled as a single buffer
+    struct PackedWindowFields {
+        uint64_t displayId_;
+        uint32_t type_;
+        uint32_t mode_;
+        uint32_t lastMode_;
+        uint32_t flags_;
+        uint32_t windowId_;
+        uint32_t parentId_;
+        uint32_t animationFlag_;
+        uint32_t windowSizeChangeReason_;
+        uint32_t callingWindow_;
+        uint32_t requestedOrientation_;
+        uint32_t modeSupportInfo_;
+        uint32_t requestModeSupportInfo_;
+        uint32_t dragType_;
+        uint32_t accessTokenId_;
+        uint32_t boolFields_;
+        float alpha_;
+        float brightness_;
+        uint32_t reserved_; // keeps the struct free of padding, so no uninitialized bytes reach the parcel
+    };
+    static_assert(sizeof(PackedWindowFields) == 80, "PackedWindowFields must not contain padding");
+
+    bool IsSameSizeLimits(const WindowSizeLimits& a, const WindowSizeLimits& b)
+    {
+        return a.maxWidth_ == b.maxWidth_ && a.maxHeight_ == b.maxHeight_ && a.minWidth_ == b.minWidth_ &&
+            a.minHeight_ == b.minHeight_ && a.maxRatio_ == b.maxRatio_ && a.minRatio_ == b.minRatio_;
+    }
+
+    const WindowProperty& GetDefaultProperty()
+    {
+        static const WindowProperty defaultProperty;
+        return defaultProperty;
+    }
+}
+
 WindowProperty::WindowProperty(const sptr<WindowProperty>& property)
 {
     CopyFrom(property);
@@ -470,38 +528,38 @@ bool WindowProperty::MapMarshalling(Parcel& parcel) const
     return true;
 }
 
-void WindowProperty::MapUnmarshalling(Parcel& parcel, WindowProperty* property)
+bool WindowProperty::MapUnmarshalling(Parcel& parcel, WindowProperty* property)
 {
-    uint32_t size = parcel.ReadUint32();
-    for (uint32_t i = 0; i < size; i++) {
-        WindowType type = static_cast<WindowType>(parcel.ReadUint32());
-        SystemBarProperty prop = { parcel.ReadBool(), parcel.ReadUint32(), parcel.ReadUint32() };
-        property->SetSystemBarProperty(type, prop);
-    }
-}
-
-bool WindowProperty::MarshallingTouchHotAreas(Parcel& parcel) const
-{
-    auto size = touchHotAreas_.size();
-    if (!parcel.WriteUint32(static_cast<uint32_t>(size))) {
+    uint32_t size = 0;
+    if (!parcel.ReadUint32(size)) {
         return false;
     }
-    for (const auto& rect : touchHotAreas_) {
-        if (!(parcel.WriteInt32(rect.posX_) && parcel.WriteInt32(rect.posY_) &&
-            parcel.WriteUint32(rect.width_) && parcel.WriteUint32(rect.height_))) {
+    for (uint32_t i = 0; i < size; i++) {
+        uint32_t type = 0;
+        SystemBarProperty prop;
+        if (!(parcel.ReadUint32(type) && parcel.ReadBool(prop.enable_) &&
+            parcel.ReadUint32(prop.backgroundColor_) && parcel.ReadUint32(prop.contentColor_))) {
             return false;
         }
+        property->SetSystemBarProperty(static_cast<WindowType>(type), prop);
     }
     return true;
 }
 
-void WindowProperty::UnmarshallingTouchHotAreas(Parcel& parcel, WindowProperty* property)
+bool WindowProperty::MarshallingTouchHotAreas(Parcel& parcel) const
 {
-    auto size = parcel.ReadUint32();
-    for (uint32_t i = 0; i < size; i++) {
-        property->touchHotAreas_.emplace_back(
-            Rect{ parcel.ReadInt32(), parcel.ReadInt32(), parcel.ReadUint32(), parcel.ReadUint32() });
+    return MarshallingHelper::MarshallingVectorPodObj<Rect>(parcel, touchHotAreas_);
+}
+
+bool WindowProperty::UnmarshallingTouchHotAreas(Parcel& parcel, WindowProperty* property)
+{
+    std::vector<Rect> rects;
+    if (!MarshallingHelper::UnmarshallingVectorPodObj<Rect>(parcel, rects)) {
+        WLOGFE("read touch hot areas failed");
+        return false;
     }
+    property->SetTouchHotAreas(rects);
+    return true;
 }
 
 bool WindowProperty::MarshallingTransform(Parcel& parcel) const
@@ -513,20 +571,18 @@ bool WindowProperty::MarshallingTransform(Parcel& parcel) const
         parcel.WriteFloat(trans_.translateY_) && parcel.WriteFloat(trans_.translateZ_);
 }
 
-void WindowProperty::UnmarshallingTransform(Parcel& parcel, WindowProperty* property)
+bool WindowProperty::UnmarshallingTransform(Parcel& parcel, WindowProperty* property)
 {
     Transform trans;
-    trans.pivotX_ = parcel.ReadFloat();
-    trans.pivotY_ = parcel.ReadFloat();
-    trans.scaleX_ = parcel.ReadFloat();
-    trans.scaleY_ = parcel.ReadFloat();
-    trans.rotationX_ = parcel.ReadFloat();
-    trans.rotationY_ = parcel.ReadFloat();
-    trans.rotationZ_ = parcel.ReadFloat();
-    trans.translateX_ = parcel.ReadFloat();
-    trans.translateY_ = parcel.ReadFloat();
-    trans.translateZ_ = parcel.ReadFloat();
+    if (!(parcel.ReadFloat(trans.pivotX_) && parcel.ReadFloat(trans.pivotY_) &&
+        parcel.ReadFloat(trans.scaleX_) && parcel.ReadFloat(trans.scaleY_) &&
+        parcel.ReadFloat(trans.rotationX_) && parcel.ReadFloat(trans.rotationY_) &&
+        parcel.ReadFloat(trans.rotationZ_) && parcel.ReadFloat(trans.translateX_) &&
+        parcel.ReadFloat(trans.translateY_) && parcel.ReadFloat(trans.translateZ_))) {
+        return false;
+    }
     property->SetTransform(trans);
+    return true;
 }
 
 bool WindowProperty::MarshallingWindowSizeLimits(Parcel& parcel) const
@@ -540,92 +596,172 @@ bool WindowProperty::MarshallingWindowSizeLimits(Parcel& parcel) const
     return false;
 }
 
-void WindowProperty::UnmarshallingWindowSizeLimits(Parcel& parcel, WindowProperty* property)
+bool WindowProperty::UnmarshallingWindowSizeLimits(Parcel& parcel, WindowProperty* property)
 {
-    WindowSizeLimits sizeLimits = { parcel.ReadUint32(), parcel.ReadUint32(), parcel.ReadUint32(),
-                                    parcel.ReadUint32(), parcel.ReadFloat(), parcel.ReadFloat() };
+    WindowSizeLimits sizeLimits;
+    if (!(parcel.ReadUint32(sizeLimits.maxWidth_) && parcel.ReadUint32(sizeLimits.maxHeight_) &&
+        parcel.ReadUint32(sizeLimits.minWidth_) && parcel.ReadUint32(sizeLimits.minHeight_) &&
+        parcel.ReadFloat(sizeLimits.maxRatio_) && parcel.ReadFloat(sizeLimits.minRatio_))) {
+        return false;
+    }
     property->SetSizeLimits(sizeLimits);
+    return true;
 }
 
 bool WindowProperty::Marshalling(Parcel& parcel) const
 {
-    return parcel.WriteString(windowName_) && parcel.WriteInt32(windowRect_.posX_) &&
-        parcel.WriteInt32(windowRect_.posY_) && parcel.WriteUint32(windowRect_.width_) &&
-        parcel.WriteUint32(windowRect_.height_) && parcel.WriteInt32(requestRect_.posX_) &&
-        parcel.WriteInt32(requestRect_.posY_) && parcel.WriteUint32(requestRect_.width_) &&
-        parcel.WriteUint32(requestRect_.height_) && parcel.WriteBool(decoStatus_) &&
-        parcel.WriteUint32(static_cast<uint32_t>(type_)) &&
-        parcel.WriteUint32(static_cast<uint32_t>(mode_)) && parcel.WriteUint32(static_cast<uint32_t>(lastMode_)) &&
-        parcel.WriteUint32(flags_) &&
-        parcel.WriteBool(isFullScreen_) && parcel.WriteBool(focusable_) && parcel.WriteBool(touchable_) &&
-        parcel.WriteBool(isPrivacyMode_) && parcel.WriteBool(isTransparent_) && parcel.WriteFloat(alpha_) &&
-        parcel.WriteFloat(brightness_) && parcel.WriteUint64(displayId_) && parcel.WriteUint32(windowId_) &&
-        parcel.WriteUint32(parentId_) && MapMarshalling(parcel) && parcel.WriteBool(isDecorEnable_) &&
-        parcel.WriteInt32(hitOffset_.x) && parcel.WriteInt32(hitOffset_.y) && parcel.WriteUint32(animationFlag_) &&
-        parcel.WriteUint32(static_cast<uint32_t>(windowSizeChangeReason_)) && parcel.WriteBool(tokenState_) &&
-        parcel.WriteUint32(callingWindow_) && parcel.WriteUint32(static_cast<uint32_t>(requestedOrientation_)) &&
-        parcel.WriteBool(turnScreenOn_) && parcel.WriteBool(keepScreenOn_) &&
-        parcel.WriteUint32(modeSupportInfo_) && parcel.WriteUint32(requestModeSupportInfo_) &&
-        parcel.WriteUint32(static_cast<uint32_t>(dragType_)) &&
-        parcel.WriteUint32(originRect_.width_) && parcel.WriteUint32(originRect_.height_) &&
-        parcel.WriteBool(isStretchable_) && MarshallingTouchHotAreas(parcel) && parcel.WriteUint32(accessTokenId_) &&
-        MarshallingTransform(parcel) && MarshallingWindowSizeLimits(parcel);
+    const WindowProperty& defaultProperty = GetDefaultProperty();
+    uint32_t presentBlocks = 0;
+    auto markIf = [&presentBlocks](bool isPresent, WindowPropertyBlock block) {
+        presentBlocks |= isPresent ? static_cast<uint32_t>(block) : 0;
+    };
+    markIf(!windowName_.empty(), WindowPropertyBlock::NAME);
+    markIf(windowRect_ != defaultProperty.windowRect_, WindowPropertyBlock::WINDOW_RECT);
+    markIf(requestRect_ != defaultProperty.requestRect_, WindowPropertyBlock::REQUEST_RECT);
+    markIf(originRect_ != defaultProperty.originRect_, WindowPropertyBlock::ORIGIN_RECT);
+    markIf(hitOffset_.x != 0 || hitOffset_.y != 0, WindowPropertyBlock::HIT_OFFSET);
+    markIf(sysBarPropMap_ != defaultProperty.sysBarPropMap_, WindowPropertyBlock::SYSTEM_BAR_PROPS);
+    markIf(!touchHotAreas_.empty(), WindowPropertyBlock::TOUCH_HOT_AREAS);
+    markIf(trans_ != defaultProperty.trans_, WindowPropertyBlock::TRANSFORM);
+    markIf(!IsSameSizeLimits(sizeLimits_, defaultProperty.sizeLimits_), WindowPropertyBlock::SIZE_LIMITS);
+
+    PackedWindowFields fields = {
+        displayId_, static_cast<uint32_t>(type_), static_cast<uint32_t>(mode_), static_cast<uint32_t>(lastMode_),
+        flags_, windowId_, parentId_, animationFlag_, static_cast<uint32_t>(windowSizeChangeReason_),
+        callingWindow_, static_cast<uint32_t>(requestedOrientation_), modeSupportInfo_, requestModeSupportInfo_,
+        static_cast<uint32_t>(dragType_), accessTokenId_, PackBoolFields(), alpha_, brightness_, 0,
+    };
+    if (!(parcel.WriteUint32(WINDOW_PROPERTY_PARCEL_VERSION) && parcel.WriteUint32(presentBlocks) &&
+        MarshallingHelper::MarshallingPodObj(parcel, fields))) {
+        return false;
+    }
+    auto isPresent = [presentBlocks](WindowPropertyBlock block) {
+        return (presentBlocks & static_cast<uint32_t>(block)) != 0;
+    };
+    return (!isPresent(WindowPropertyBlock::NAME) || parcel.WriteString(windowName_)) &&
+        (!isPresent(WindowPropertyBlock::WINDOW_RECT) ||
+            MarshallingHelper::MarshallingPodObj(parcel, windowRect_)) &&
+        (!isPresent(WindowPropertyBlock::REQUEST_RECT) ||
+            MarshallingHelper::MarshallingPodObj(parcel, requestRect_)) &&
+        (!isPresent(WindowPropertyBlock::ORIGIN_RECT) ||
+            MarshallingHelper::MarshallingPodObj(parcel, originRect_)) &&
+        (!isPresent(WindowPropertyBlock::HIT_OFFSET) ||
+            MarshallingHelper::MarshallingPodObj(parcel, hitOffset_)) &&
+        (!isPresent(WindowPropertyBlock::SYSTEM_BAR_PROPS) || MapMarshalling(parcel)) &&
+        (!isPresent(WindowPropertyBlock::TOUCH_HOT_AREAS) || MarshallingTouchHotAreas(parcel)) &&
+        (!isPresent(WindowPropertyBlock::TRANSFORM) || MarshallingTransform(parcel)) &&
+        (!isPresent(WindowPropertyBlock::SIZE_LIMITS) || MarshallingWindowSizeLimits(parcel));
 }
 
 WindowProperty* WindowProperty::Unmarshalling(Parcel& parcel)
 {
+    uint32_t version = parcel.ReadUint32();
+    if (version != WINDOW_PROPERTY_PARCEL_VERSION) {
+        WLOGFE("unsupported window property parcel version: %{public}u", version);
+        return nullptr;
+    }
+    uint32_t presentBlocks = parcel.ReadUint32();
+    PackedWindowFields fields;
+    if (!MarshallingHelper::UnmarshallingPodObj(parcel, fields)) {
+        WLOGFE("read packed window property fields failed");
+        return nullptr;
+    }
     WindowProperty* property = new(std::nothrow) WindowProperty();
     if (property == nullptr) {
         return nullptr;
     }
-    property->SetWindowName(parcel.ReadString());
-    Rect rect = { parcel.ReadInt32(), parcel.ReadInt32(), parcel.ReadUint32(), parcel.ReadUint32() };
-    property->SetWindowRect(rect);
-    Rect reqRect = { parcel.ReadInt32(), parcel.ReadInt32(), parcel.ReadUint32(), parcel.ReadUint32() };
-    property->SetRequestRect(reqRect);
-    property->SetDecoStatus(parcel.ReadBool());
-    property->SetWindowType(static_cast<WindowType>(parcel.ReadUint32()));
-    property->SetWindowMode(static_cast<WindowMode>(parcel.ReadUint32()));
-    property->SetLastWindowMode(static_cast<WindowMode>(parcel.ReadUint32()));
-    property->SetWindowFlags(parcel.ReadUint32());
-    property->SetFullScreen(parcel.ReadBool());
-    property->SetFocusable(parcel.ReadBool());
-    property->SetTouchable(parcel.ReadBool());
-    property->SetPrivacyMode(parcel.ReadBool());
-    property->SetTransparent(parcel.ReadBool());
-    property->SetAlpha(parcel.ReadFloat());
-    property->SetBrightness(parcel.ReadFloat());
-    property->SetDisplayId(parcel.ReadUint64());
-    property->SetWindowId(parcel.ReadUint32());
-    property->SetParentId(parcel.ReadUint32());
-    MapUnmarshalling(parcel, property);
-    property->SetDecorEnable(parcel.ReadBool());
-    PointInfo offset = {parcel.ReadInt32(), parcel.ReadInt32()};
-    property->SetHitOffset(offset);
-    property->SetAnimationFlag(parcel.ReadUint32());
-    property->SetWindowSizeChangeReason(static_cast<WindowSizeChangeReason>(parcel.ReadUint32()));
-    property->SetTokenState(parcel.ReadBool());
-    property->SetCallingWindow(parcel.ReadUint32());
-    property->SetRequestedOrientation(static_cast<Orientation>(parcel.ReadUint32()));
-    property->SetTurnScreenOn(parcel.ReadBool());
-    property->SetKeepScreenOn(parcel.ReadBool());
-    property->SetModeSupportInfo(parcel.ReadUint32());
-    property->SetRequestModeSupportInfo(parcel.ReadUint32());
-    property->SetDragType(static_cast<DragType>(parcel.ReadUint32()));
-    uint32_t w = parcel.ReadUint32();
-    uint32_t h = parcel.ReadUint32();
-    property->SetOriginRect(Rect { 0, 0, w, h });
-    property->SetStretchable(parcel.ReadBool());
-    UnmarshallingTouchHotAreas(parcel, property);
-    property->SetAccessTokenId(parcel.ReadUint32());
-    UnmarshallingTransform(parcel, property);
-    UnmarshallingWindowSizeLimits(parcel, property);
+    property->SetDisplayId(fields.displayId_);
+    property->SetWindowType(static_cast<WindowType>(fields.type_));
+    property->SetWindowMode(static_cast<WindowMode>(fields.mode_));
+    property->SetLastWindowMode(static_cast<WindowMode>(fields.lastMode_));
+    property->SetWindowFlags(fields.flags_);
+    property->SetWindowId(fields.windowId_);
+    property->SetParentId(fields.parentId_);
+    property->SetAnimationFlag(fields.animationFlag_);
+    property->SetWindowSizeChangeReason(static_cast<WindowSizeChangeReason>(fields.windowSizeChangeReason_));
+    property->SetCallingWindow(fields.callingWindow_);
+    property->SetRequestedOrientation(static_cast<Orientation>(fields.requestedOrientation_));
+    property->SetModeSupportInfo(fields.modeSupportInfo_);
+    property->SetRequestModeSupportInfo(fields.requestModeSupportInfo_);
+    property->SetDragType(static_cast<DragType>(fields.dragType_));
+    property->SetAccessTokenId(fields.accessTokenId_);
+    property->UnpackBoolFields(fields.boolFields_);
+    property->SetAlpha(fields.alpha_);
+    property->SetBrightness(fields.brightness_);
+    if (!property->UnmarshallingBlocks(parcel, presentBlocks)) {
+        WLOGFE("read window property blocks failed, blocks: %{public}u", presentBlocks);
+        delete property;
+        return nullptr;
+    }
     return property;
 }
 
+bool WindowProperty::UnmarshallingBlocks(Parcel& parcel, uint32_t presentBlocks)
+{
+    auto isPresent = [presentBlocks](WindowPropertyBlock block) {
+        return (presentBlocks & static_cast<uint32_t>(block)) != 0;
+    };
+    if (isPresent(WindowPropertyBlock::NAME)) {
+        std::string windowName;
+        if (!parcel.ReadString(windowName)) {
+            return false;
+        }
+        SetWindowName(windowName);
+    }
+    // blocks missing from the parcel keep their default values
+    bool ret = (!isPresent(WindowPropertyBlock::WINDOW_RECT) ||
+            MarshallingHelper::UnmarshallingPodObj(parcel, windowRect_)) &&
+        (!isPresent(WindowPropertyBlock::REQUEST_RECT) ||
+            MarshallingHelper::UnmarshallingPodObj(parcel, requestRect_)) &&
+        (!isPresent(WindowPropertyBlock::ORIGIN_RECT) ||
+            MarshallingHelper::UnmarshallingPodObj(parcel, originRect_)) &&
+        (!isPresent(WindowPropertyBlock::HIT_OFFSET) ||
+            MarshallingHelper::UnmarshallingPodObj(parcel, hitOffset_));
+    return ret && (!isPresent(WindowPropertyBlock::SYSTEM_BAR_PROPS) || MapUnmarshalling(parcel, this)) &&
+        (!isPresent(WindowPropertyBlock::TOUCH_HOT_AREAS) || UnmarshallingTouchHotAreas(parcel, this)) &&
+        (!isPresent(WindowPropertyBlock::TRANSFORM) || UnmarshallingTransform(parcel, this)) &&
+        (!isPresent(WindowPropertyBlock::SIZE_LIMITS) || UnmarshallingWindowSizeLimits(parcel, this));
+}
+
+uint32_t WindowProperty::PackBoolFields() const
+{
+    const bool boolFields[] = {
+        decoStatus_, isFullScreen_, focusable_, touchable_, isPrivacyMode_, isTransparent_, isDecorEnable_,
+        tokenState_, turnScreenOn_, keepScreenOn_, isStretchable_,
+    };
+    uint32_t packed = 0;
+    for (size_t i = 0; i < sizeof(boolFields) / sizeof(boolFields[0]); i++) {
+        packed |= boolFields[i] ? (1u << i) : 0;
+    }
+    return packed;
+}
+
+void WindowProperty::UnpackBoolFields(uint32_t packed)
+{
+    bool* boolFields[] = {
+        &decoStatus_, &isFullScreen_, &focusable_, &touchable_, &isPrivacyMode_, &isTransparent_, &isDecorEnable_,
+        &tokenState_, &turnScreenOn_, &keepScreenOn_, &isStretchable_,
+    };
+    for (size_t i = 0; i < sizeof(boolFields) / sizeof(boolFields[0]); i++) {
+        *boolFields[i] = (packed & (1u << i)) != 0;
+    }
+}
+
 bool WindowProperty::Write(Parcel& parcel, PropertyChangeAction action)
 {
     bool ret = parcel.WriteUint32(static_cast<uint32_t>(windowId_));
+    uint32_t actions = static_cast<uint32_t>(action);
+    for (uint32_t bit = 1; ret && bit != 0 && bit <= actions; bit <<= 1) {
+        if ((actions & bit) != 0) {
+            ret = WriteActionField(parcel, static_cast<PropertyChangeAction>(bit));
+        }
+    }
+    return ret;
+}
+
+bool WindowProperty::WriteActionField(Parcel& parcel, PropertyChangeAction action)
+{
+    bool ret = true;
     switch (action) {
         case PropertyChangeAction::ACTION_UPDATE_RECT:
             ret = ret && parcel.WriteBool(decoStatus_) && parcel.WriteUint32(static_cast<uint32_t>(dragType_)) &&
@@ -689,6 +825,16 @@ bool WindowProperty::Write(Parcel& parcel, PropertyChangeAction action)
 void WindowProperty::Read(Parcel& parcel, PropertyChangeAction action)
 {
     SetWindowId(parcel.ReadUint32());
+    uint32_t actions = static_cast<uint32_t>(action);
+    for (uint32_t bit = 1; bit != 0 && bit <= actions; bit <<= 1) {
+        if ((actions & bit) != 0) {
+            ReadActionField(parcel, static_cast<PropertyChangeAction>(bit));
+        }
+    }
+}
+
+void WindowProperty::ReadActionField(Parcel& parcel, PropertyChangeAction action)
+{
     switch (action) {
         case PropertyChangeAction::ACTION_UPDATE_RECT:
             SetDecoStatus(parcel.ReadBool());
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <mutex>
+
+#include "atomic_map.h"
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr uint32_t KEY_RANGE_PER_THREAD = 1024;
+    constexpr uint32_t LOOKUPS_PER_UPDATE = 4;
+
+    // the previous design for comparison, one lock around one map
+    class SingleLockMap {
+    public:
+        void insert(const std::pair<uint32_t, uint32_t>& kv)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            data_.insert(kv);
+        }
+        bool find(uint32_t key, uint32_t& value)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = data_.find(key);
+            if (iter == data_.end()) {
+                return false;
+            }
+            value = iter->second;
+            return true;
+        }
+        bool isExistAndRemove(uint32_t key, uint32_t value)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = data_.find(key);
+            if (iter == data_.end() || iter->second != value) {
+                return false;
+            }
+            data_.erase(iter);
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::map<uint32_t, uint32_t> data_;
+    };
+
+    AtomicMap<uint32_t, uint32_t> g_atomicMap;
+    SingleLockMap g_singleLockMap;
+
+    // the access pattern of the access token maps: an insert on create, lookups, a checked remove on destroy
+    template<class Map>
+    void RunCreateDestroyPattern(benchmark::State& state, Map& map)
+    {
+        uint32_t keyBase = static_cast<uint32_t>(state.thread_index) * KEY_RANGE_PER_THREAD;
+        uint32_t tokenId = static_cast<uint32_t>(state.thread_index);
+        uint32_t index = 0;
+        for (auto _ : state) {
+            uint32_t key = keyBase + (index++ % KEY_RANGE_PER_THREAD);
+            map.insert(std::make_pair(key, tokenId));
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < LOOKUPS_PER_UPDATE; i++) {
+                benchmark::DoNotOptimize(map.find(key, value));
+            }
+            benchmark::DoNotOptimize(map.isExistAndRemove(key, tokenId));
+        }
+    }
+}
+
+static void BM_AtomicMapContention(benchmark::State& state)
+{
+    RunCreateDestroyPattern(state, g_atomicMap);
+}
+BENCHMARK(BM_AtomicMapContention)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_SingleLockMapContention(benchmark::State& state)
+{
+    RunCreateDestroyPattern(state, g_singleLockMap);
+}
+BENCHMARK(BM_SingleLockMapContention)->ThreadRange(1, 16)->UseRealTime();
+} // namespace Rosen
+} // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <parcel.h>
+
+#include "window_property.h"
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    // the previous format for comparison, every field written on its own
+    bool LegacyMarshalling(const WindowProperty& property, Parcel& parcel)
+    {
+        auto writeRect = [&parcel](const Rect& rect) {
+            return parcel.WriteInt32(rect.posX_) && parcel.WriteInt32(rect.posY_) &&
+                parcel.WriteUint32(rect.width_) && parcel.WriteUint32(rect.height_);
+        };
+        bool ret = parcel.WriteString(property.GetWindowName()) && writeRect(property.GetWindowRect()) &&
+            writeRect(property.GetRequestRect()) && parcel.WriteBool(property.GetDecoStatus()) &&
+            parcel.WriteUint32(static_cast<uint32_t>(property.GetWindowType())) &&
+            parcel.WriteUint32(static_cast<uint32_t>(property.GetWindowMode())) &&
+            parcel.WriteUint32(static_cast<uint32_t>(property.GetLastWindowMode())) &&
+            parcel.WriteUint32(property.GetWindowFlags()) && parcel.WriteBool(property.GetFullScreen()) &&
+            parcel.WriteBool(property.GetFocusable()) && parcel.WriteBool(property.GetTouchable()) &&
+            parcel.WriteBool(property.GetPrivacyMode()) && parcel.WriteBool(property.GetTransparent()) &&
+            parcel.WriteFloat(property.GetAlpha()) && parcel.WriteFloat(property.GetBrightness()) &&
+            parcel.WriteUint64(property.GetDisplayId()) && parcel.WriteUint32(property.GetWindowId()) &&
+            parcel.WriteUint32(property.GetParentId());
+        const auto& sysBarPropMap = property.GetSystemBarProperty();
+        ret = ret && parcel.WriteUint32(static_cast<uint32_t>(sysBarPropMap.size()));
+        for (const auto& [type, prop] : sysBarPropMap) {
+            ret = ret && parcel.WriteUint32(static_cast<uint32_t>(type)) && parcel.WriteBool(prop.enable_) &&
+                parcel.WriteUint32(prop.backgroundColor_) && parcel.WriteUint32(prop.contentColor_);
+        }
+        ret = ret && parcel.WriteBool(property.GetDecorEnable()) && parcel.WriteInt32(property.GetHitOffset().x) &&
+            parcel.WriteInt32(property.GetHitOffset().y) && parcel.WriteUint32(property.GetAnimationFlag()) &&
+            parcel.WriteUint32(static_cast<uint32_t>(property.GetWindowSizeChangeReason())) &&
+            parcel.WriteBool(property.GetTokenState()) && parcel.WriteUint32(property.GetCallingWindow()) &&
+            parcel.WriteUint32(static_cast<uint32_t>(property.GetRequestedOrientation())) &&
+            parcel.WriteBool(property.IsTurnScreenOn()) && parcel.WriteBool(property.IsKeepScreenOn()) &&
+            parcel.WriteUint32(property.GetModeSupportInfo()) &&
+            parcel.WriteUint32(property.GetRequestModeSupportInfo()) &&
+            parcel.WriteUint32(static_cast<uint32_t>(property.GetDragType())) &&
+            parcel.WriteUint32(property.GetOriginRect().width_) &&
+            parcel.WriteUint32(property.GetOriginRect().height_) &&
+            parcel.WriteBool(property.GetStretchable());
+        std::vector<Rect> touchHotAreas;
+        property.GetTouchHotAreas(touchHotAreas);
+        ret = ret && parcel.WriteUint32(static_cast<uint32_t>(touchHotAreas.size()));
+        for (const auto& rect : touchHotAreas) {
+            ret = ret && writeRect(rect);
+        }
+        const Transform& trans = property.GetTransform();
+        WindowSizeLimits sizeLimits = property.GetSizeLimits();
+        return ret && parcel.WriteUint32(property.GetAccessTokenId()) && parcel.WriteFloat(trans.pivotX_) &&
+            parcel.WriteFloat(trans.pivotY_) && parcel.WriteFloat(trans.scaleX_) && parcel.WriteFloat(trans.scaleY_) &&
+            parcel.WriteFloat(trans.rotationX_) && parcel.WriteFloat(trans.rotationY_) &&
+            parcel.WriteFloat(trans.rotationZ_) && parcel.WriteFloat(trans.translateX_) &&
+            parcel.WriteFloat(trans.translateY_) && parcel.WriteFloat(trans.translateZ_) &&
+            parcel.WriteUint32(sizeLimits.maxWidth_) && parcel.WriteUint32(sizeLimits.maxHeight_) &&
+            parcel.WriteUint32(sizeLimits.minWidth_) && parcel.WriteUint32(sizeLimits.minHeight_) &&
+            parcel.WriteFloat(sizeLimits.maxRatio_) && parcel.WriteFloat(sizeLimits.minRatio_);
+    }
+
+    // what a main window sends with CreateWindow and AddWindow
+    sptr<WindowProperty> CreateAppWindowProperty()
+    {
+        sptr<WindowProperty> property = new WindowProperty();
+        property->SetWindowName("com.example.benchmark.MainAbility");
+        property->SetWindowRect({ 0, 0, 2560, 1600 });
+        property->SetRequestRect({ 0, 0, 2560, 1600 });
+        property->SetWindowId(42);
+        property->SetTokenState(true);
+        property->SetAccessTokenId(0x1234);
+        return property;
+    }
+}
+
+static void BM_MarshallingCompact(benchmark::State& state)
+{
+    sptr<WindowProperty> property = CreateAppWindowProperty();
+    size_t parcelSize = 0;
+    for (auto _ : state) {
+        Parcel parcel;
+        property->Marshalling(parcel);
+        parcelSize = parcel.GetDataSize();
+        benchmark::DoNotOptimize(parcelSize);
+    }
+    state.counters["bytes"] = static_cast<double>(parcelSize);
+}
+BENCHMARK(BM_MarshallingCompact);
+
+static void BM_MarshallingLegacy(benchmark::State& state)
+{
+    sptr<WindowProperty> property = CreateAppWindowProperty();
+    size_t parcelSize = 0;
+    for (auto _ : state) {
+        Parcel parcel;
+        LegacyMarshalling(*property, parcel);
+        parcelSize = parcel.GetDataSize();
+        benchmark::DoNotOptimize(parcelSize);
+    }
+    state.counters["bytes"] = static_cast<double>(parcelSize);
+}
+BENCHMARK(BM_MarshallingLegacy);
+
+static void BM_UnmarshallingCompact(benchmark::State& state)
+{
+    sptr<WindowProperty> property = CreateAppWindowProperty();
+    Parcel parcel;
+    property->Marshalling(parcel);
+    for (auto _ : state) {
+        parcel.RewindRead(0);
+        sptr<WindowProperty> result = WindowProperty::Unmarshalling(parcel);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_UnmarshallingCompact);
+
+// the drag path of UpdateProperty, only the rect action is sent
+static void BM_WriteRectAction(benchmark::State& state)
+{
+    sptr<WindowProperty> property = CreateAppWindowProperty();
+    size_t parcelSize = 0;
+    for (auto _ : state) {
+        Parcel parcel;
+        property->Write(parcel, PropertyChangeAction::ACTION_UPDATE_RECT);
+        parcelSize = parcel.GetDataSize();
+        benchmark::DoNotOptimize(parcelSize);
+    }
+    state.counters["bytes"] = static_cast<double>(parcelSize);
+}
+BENCHMARK(BM_WriteRectAction);
+} // namespace Rosen
+} // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "atomic_map.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr uint32_t THREAD_NUM = 8;
+    constexpr uint32_t KEYS_PER_THREAD = 2000;
+    constexpr uint32_t STRESS_ROUNDS = 4;
+}
+
+class AtomicMapTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+};
+
+void AtomicMapTest::SetUpTestCase()
+{
+}
+
+void AtomicMapTest::TearDownTestCase()
+{
+}
+
+void AtomicMapTest::SetUp()
+{
+}
+
+void AtomicMapTest::TearDown()
+{
+}
+
+namespace {
+/**
+ * @tc.name: InsertFindErase
+ * @tc.desc: single thread insert, value lookup, conditional remove and erase
+ * @tc.type: FUNC
+ */
+HWTEST_F(AtomicMapTest, InsertFindErase, Function | SmallTest | Level2)
+{
+    AtomicMap<uint32_t, uint32_t> map;
+    uint32_t value = 0;
+    ASSERT_FALSE(map.find(1, value));
+    map.insert(std::make_pair(1u, 100u));
+    map.insert(std::make_pair(1u, 200u)); // like std::map, an existing key is not overwritten
+    ASSERT_TRUE(map.find(1, value));
+    ASSERT_EQ(100u, value);
+    ASSERT_EQ(1, map.count(1));
+    ASSERT_TRUE(map.isExist(1, 100));
+    ASSERT_FALSE(map.isExist(1, 200));
+
+    ASSERT_FALSE(map.isExistAndRemove(1, 200));
+    ASSERT_TRUE(map.isExistAndRemove(1, 100));
+    ASSERT_EQ(0, map.count(1));
+
+    map.insert(std::make_pair(2u, 300u));
+    map.erase(2);
+    ASSERT_FALSE(map.find(2, value));
+}
+
+/**
+ * @tc.name: ConcurrentStress
+ * @tc.desc: threads insert, look up and remove their own keys while sharing the shards with the others
+ * @tc.type: FUNC
+ */
+HWTEST_F(AtomicMapTest, ConcurrentStress, Function | MediumTest | Level2)
+{
+    AtomicMap<uint32_t, uint32_t> map;
+    std::atomic<uint32_t> errorCount { 0 };
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREAD_NUM; t++) {
+        threads.emplace_back([&map, &errorCount, t]() {
+            for (uint32_t round = 0; round < STRESS_ROUNDS; round++) {
+                for (uint32_t i = 0; i < KEYS_PER_THREAD; i++) {
+                    map.insert(std::make_pair(t * KEYS_PER_THREAD + i, t));
+                }
+                for (uint32_t i = 0; i < KEYS_PER_THREAD; i++) {
+                    uint32_t value = 0;
+                    if (!map.find(t * KEYS_PER_THREAD + i, value) || value != t) {
+                        errorCount++;
+                    }
+                    // a key of another thread may or may not be there, but never with a foreign value
+                    uint32_t otherKey = ((t + 1) % THREAD_NUM) * KEYS_PER_THREAD + i;
+                    if (map.find(otherKey, value) && value != (t + 1) % THREAD_NUM) {
+                        errorCount++;
+                    }
+                }
+                for (uint32_t i = 0; i < KEYS_PER_THREAD; i++) {
+                    if (!map.isExistAndRemove(t * KEYS_PER_THREAD + i, t)) {
+                        errorCount++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(0u, errorCount.load());
+    for (uint32_t key = 0; key < THREAD_NUM * KEYS_PER_THREAD; key++) {
+        ASSERT_EQ(0, map.count(key));
+    }
+}
+}
+} // namespace Rosen
+} // namespace OHOS
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <iremote_broker.h>
+#include <iremote_stub.h>
+#include <thread>
+#include <vector>
+
+#include "client_agent_container.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr uint32_t AGENT_TYPE_A = 0;
+    constexpr uint32_t AGENT_TYPE_B = 1;
+    constexpr uint32_t AGENT_NUM = 64;
+    constexpr uint32_t READER_NUM = 4;
+}
+
+class ITestAgent : public IRemoteBroker {
+public:
+    DECLARE_INTERFACE_DESCRIPTOR(u"OHOS.Rosen.ITestAgent");
+};
+
+class TestAgent : public IRemoteStub<ITestAgent> {
+public:
+    int OnRemoteRequest(uint32_t code, MessageParcel& data, MessageParcel& reply, MessageOption& option) override
+    {
+        return 0;
+    }
+};
+
+class ClientAgentContainerTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+};
+
+void ClientAgentContainerTest::SetUpTestCase()
+{
+}
+
+void ClientAgentContainerTest::TearDownTestCase()
+{
+}
+
+void ClientAgentContainerTest::SetUp()
+{
+}
+
+void ClientAgentContainerTest::TearDown()
+{
+}
+
+namespace {
+/**
+ * @tc.name: RegisterAndUnregister
+ * @tc.desc: agents are kept per type, duplicated registration and unknown agents are rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(ClientAgentContainerTest, RegisterAndUnregister, Function | SmallTest | Level2)
+{
+    ClientAgentContainer<ITestAgent, uint32_t> container;
+    sptr<ITestAgent> agent = new TestAgent();
+    ASSERT_TRUE(container.GetAgentsByType(AGENT_TYPE_A).empty());
+    ASSERT_TRUE(container.RegisterAgent(agent, AGENT_TYPE_A));
+    ASSERT_FALSE(container.RegisterAgent(agent, AGENT_TYPE_A));
+    ASSERT_EQ(1u, container.GetAgentsByType(AGENT_TYPE_A).size());
+    ASSERT_TRUE(container.GetAgentsByType(AGENT_TYPE_B).empty());
+
+    ASSERT_FALSE(container.UnregisterAgent(agent, AGENT_TYPE_B));
+    ASSERT_TRUE(container.UnregisterAgent(agent, AGENT_TYPE_A));
+    ASSERT_FALSE(container.UnregisterAgent(agent, AGENT_TYPE_A));
+    ASSERT_TRUE(container.GetAgentsByType(AGENT_TYPE_A).empty());
+}
+
+/**
+ * @tc.name: SnapshotIsImmutable
+ * @tc.desc: a snapshot taken before a registration change keeps the agents it was taken with
+ * @tc.type: FUNC
+ */
+HWTEST_F(ClientAgentContainerTest, SnapshotIsImmutable, Function | SmallTest | Level2)
+{
+    ClientAgentContainer<ITestAgent, uint32_t> container;
+    sptr<ITestAgent> agent1 = new TestAgent();
+    sptr<ITestAgent> agent2 = new TestAgent();
+    ASSERT_TRUE(container.RegisterAgent(agent1, AGENT_TYPE_A));
+    auto snapshot = container.GetAgentsByType(AGENT_TYPE_A);
+
+    ASSERT_TRUE(container.RegisterAgent(agent2, AGENT_TYPE_A));
+    ASSERT_TRUE(container.UnregisterAgent(agent1, AGENT_TYPE_A));
+    ASSERT_EQ(1u, snapshot.size());
+    ASSERT_EQ(agent1, *snapshot.begin());
+    auto current = container.GetAgentsByType(AGENT_TYPE_A);
+    ASSERT_EQ(1u, current.size());
+    ASSERT_EQ(agent2, *current.begin());
+}
+
+/**
+ * @tc.name: ConcurrentReadAndRegister
+ * @tc.desc: readers iterate snapshots while agents are registered and unregistered on another thread
+ * @tc.type: FUNC
+ */
+HWTEST_F(ClientAgentContainerTest, ConcurrentReadAndRegister, Function | MediumTest | Level2)
+{
+    ClientAgentContainer<ITestAgent, uint32_t> container;
+    std::vector<sptr<ITestAgent>> agents;
+    for (uint32_t i = 0; i < AGENT_NUM; i++) {
+        agents.push_back(new TestAgent());
+    }
+    std::atomic<bool> isWriting { true };
+    std::atomic<uint32_t> invalidCount { 0 };
+    std::vector<std::thread> readers;
+    for (uint32_t i = 0; i < READER_NUM; i++) {
+        readers.emplace_back([&container, &isWriting, &invalidCount]() {
+            while (isWriting.load()) {
+                auto snapshot = container.GetAgentsByType(AGENT_TYPE_A);
+                size_t count = 0;
+                for (const auto& agent : snapshot) {
+                    count++;
+                    if (agent == nullptr || agent->AsObject() == nullptr) {
+                        invalidCount++;
+                    }
+                }
+                if (count != snapshot.size() || count > AGENT_NUM) {
+                    invalidCount++;
+                }
+            }
+        });
+    }
+    for (const auto& agent : agents) {
+        container.RegisterAgent(agent, AGENT_TYPE_A);
+    }
+    for (const auto& agent : agents) {
+        container.UnregisterAgent(agent, AGENT_TYPE_A);
+    }
+    isWriting.store(false);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(0u, invalidCount.load());
+    ASSERT_TRUE(container.GetAgentsByType(AGENT_TYPE_A).empty());
+}
+}
+} // namespace Rosen
+} // namespace OHOS
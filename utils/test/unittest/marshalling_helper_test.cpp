@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "marshalling_helper.h"
+#include "wm_common.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Rosen {
+class MarshallingHelperTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+};
+
+void MarshallingHelperTest::SetUpTestCase()
+{
+}
+
+void MarshallingHelperTest::TearDownTestCase()
+{
+}
+
+void MarshallingHelperTest::SetUp()
+{
+}
+
+void MarshallingHelperTest::TearDown()
+{
+}
+
+namespace {
+/**
+ * @tc.name: VectorPodObjRoundTrip
+ * @tc.desc: Rect and id vectors are read back as written
+ * @tc.type: FUNC
+ */
+HWTEST_F(MarshallingHelperTest, VectorPodObjRoundTrip, Function | SmallTest | Level2)
+{
+    std::vector<Rect> rects;
+    for (int32_t i = 0; i < 1000; i++) {
+        rects.push_back({ i, -i, static_cast<uint32_t>(i * 2), static_cast<uint32_t>(i * 3) });
+    }
+    std::vector<uint32_t> ids = { 1, 2, 3 };
+    std::vector<uint32_t> emptyIds;
+
+    Parcel parcel;
+    ASSERT_EQ(true, MarshallingHelper::MarshallingVectorPodObj<Rect>(parcel, rects));
+    ASSERT_EQ(true, MarshallingHelper::MarshallingVectorPodObj<uint32_t>(parcel, emptyIds));
+    ASSERT_EQ(true, MarshallingHelper::MarshallingVectorPodObj<uint32_t>(parcel, ids));
+
+    std::vector<Rect> rectsDst;
+    std::vector<uint32_t> emptyIdsDst = { 7 };
+    std::vector<uint32_t> idsDst;
+    ASSERT_EQ(true, MarshallingHelper::UnmarshallingVectorPodObj<Rect>(parcel, rectsDst));
+    ASSERT_EQ(true, MarshallingHelper::UnmarshallingVectorPodObj<uint32_t>(parcel, emptyIdsDst));
+    ASSERT_EQ(true, MarshallingHelper::UnmarshallingVectorPodObj<uint32_t>(parcel, idsDst));
+    ASSERT_EQ(rects, rectsDst);
+    ASSERT_EQ(true, emptyIdsDst.empty());
+    ASSERT_EQ(ids, idsDst);
+}
+
+/**
+ * @tc.name: VectorPodObjInvalidLength
+ * @tc.desc: Negative lengths and lengths beyond the parcel are rejected before anything is allocated
+ * @tc.type: FUNC
+ */
+HWTEST_F(MarshallingHelperTest, VectorPodObjInvalidLength, Function | SmallTest | Level2)
+{
+    Parcel negativeParcel;
+    negativeParcel.WriteInt32(-1);
+    std::vector<Rect> rects;
+    ASSERT_EQ(false, MarshallingHelper::UnmarshallingVectorPodObj<Rect>(negativeParcel, rects));
+
+    Parcel oversizedParcel;
+    oversizedParcel.WriteInt32(INT32_MAX);
+    oversizedParcel.WriteInt32(0);
+    ASSERT_EQ(false, MarshallingHelper::UnmarshallingVectorPodObj<Rect>(oversizedParcel, rects));
+    ASSERT_EQ(true, rects.empty());
+
+    // two rects announced, one written
+    Parcel truncatedParcel;
+    truncatedParcel.WriteInt32(2);
+    Rect rect = { 1, 2, 3, 4 };
+    ASSERT_EQ(true, MarshallingHelper::MarshallingPodObj(truncatedParcel, rect));
+    ASSERT_EQ(false, MarshallingHelper::UnmarshallingVectorPodObj<Rect>(truncatedParcel, rects));
+}
+
+/**
+ * @tc.name: PodObjRoundTrip
+ * @tc.desc: A single trivially copyable object is read back as written
+ * @tc.type: FUNC
+ */
+HWTEST_F(MarshallingHelperTest, PodObjRoundTrip, Function | SmallTest | Level2)
+{
+    Parcel parcel;
+    Rect rect = { -1, 2, 300, 400 };
+    ASSERT_EQ(true, MarshallingHelper::MarshallingPodObj(parcel, rect));
+    Rect rectDst = { 0, 0, 0, 0 };
+    ASSERT_EQ(true, MarshallingHelper::UnmarshallingPodObj(parcel, rectDst));
+    ASSERT_EQ(rect, rectDst);
+    ASSERT_EQ(false, MarshallingHelper::UnmarshallingPodObj(parcel, rectDst));
+}
+}
+} // namespace Rosen
+} // namespace OHOS
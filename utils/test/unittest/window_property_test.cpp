@@ -69,6 +69,133 @@ HWTEST_F(WindowPropertyTest, MarshallingUnmarshalling, Function | SmallTest | Le
     delete winPropDst;
 }
 
+/**
+ * @tc.name: MarshallingAllFields
+ * @tc.desc: Marshalling Unmarshalling round trip with every block present
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowPropertyTest, MarshallingAllFields, Function | SmallTest | Level2)
+{
+    WindowProperty winPropSrc;
+    winPropSrc.SetWindowName("round_trip");
+    winPropSrc.SetWindowRect({ 1, 2, 300, 400 });
+    winPropSrc.SetRequestRect({ 5, 6, 700, 800 });
+    winPropSrc.SetOriginRect({ 0, 0, 900, 1000 });
+    winPropSrc.SetHitOffset({ 11, 12 });
+    winPropSrc.SetWindowType(WindowType::WINDOW_TYPE_FLOAT);
+    winPropSrc.SetWindowMode(WindowMode::WINDOW_MODE_FLOATING);
+    winPropSrc.SetWindowFlags(static_cast<uint32_t>(WindowFlag::WINDOW_FLAG_NEED_AVOID));
+    winPropSrc.SetDisplayId(0x100000001);
+    winPropSrc.SetWindowId(13);
+    winPropSrc.SetParentId(14);
+    winPropSrc.SetFocusable(false);
+    winPropSrc.SetKeepScreenOn(true);
+    winPropSrc.SetStretchable(true);
+    winPropSrc.SetAlpha(0.5f);
+    winPropSrc.SetBrightness(0.25f);
+    winPropSrc.SetRequestedOrientation(Orientation::HORIZONTAL);
+    winPropSrc.SetSystemBarProperty(WindowType::WINDOW_TYPE_STATUS_BAR, SystemBarProperty(false, 0x1, 0x2));
+    winPropSrc.SetTouchHotAreas({ { 0, 0, 10, 10 }, { 20, 20, 30, 30 } });
+    Transform trans;
+    trans.scaleX_ = 0.5f;
+    winPropSrc.SetTransform(trans);
+    winPropSrc.SetSizeLimits(WindowSizeLimits(1000, 1000, 100, 100, 2.0f, 0.5f));
+
+    Parcel parcel;
+    ASSERT_EQ(true, winPropSrc.Marshalling(parcel));
+    WindowProperty* winPropDst = WindowProperty::Unmarshalling(parcel);
+    ASSERT_NE(nullptr, winPropDst);
+
+    ASSERT_EQ("round_trip", winPropDst->GetWindowName());
+    ASSERT_EQ(winPropSrc.GetWindowRect(), winPropDst->GetWindowRect());
+    ASSERT_EQ(winPropSrc.GetRequestRect(), winPropDst->GetRequestRect());
+    ASSERT_EQ(winPropSrc.GetOriginRect(), winPropDst->GetOriginRect());
+    ASSERT_EQ(11, winPropDst->GetHitOffset().x);
+    ASSERT_EQ(12, winPropDst->GetHitOffset().y);
+    ASSERT_EQ(WindowType::WINDOW_TYPE_FLOAT, winPropDst->GetWindowType());
+    ASSERT_EQ(WindowMode::WINDOW_MODE_FLOATING, winPropDst->GetWindowMode());
+    ASSERT_EQ(winPropSrc.GetWindowFlags(), winPropDst->GetWindowFlags());
+    ASSERT_EQ(winPropSrc.GetDisplayId(), winPropDst->GetDisplayId());
+    ASSERT_EQ(13u, winPropDst->GetWindowId());
+    ASSERT_EQ(14u, winPropDst->GetParentId());
+    ASSERT_EQ(false, winPropDst->GetFocusable());
+    ASSERT_EQ(true, winPropDst->GetTouchable());
+    ASSERT_EQ(true, winPropDst->IsKeepScreenOn());
+    ASSERT_EQ(true, winPropDst->GetStretchable());
+    ASSERT_EQ(0.5f, winPropDst->GetAlpha());
+    ASSERT_EQ(0.25f, winPropDst->GetBrightness());
+    ASSERT_EQ(Orientation::HORIZONTAL, winPropDst->GetRequestedOrientation());
+    ASSERT_EQ(winPropSrc.GetSystemBarProperty(), winPropDst->GetSystemBarProperty());
+    std::vector<Rect> hotAreas;
+    winPropDst->GetTouchHotAreas(hotAreas);
+    ASSERT_EQ(2u, hotAreas.size());
+    ASSERT_EQ((Rect { 20, 20, 30, 30 }), hotAreas[1]);
+    ASSERT_EQ(trans, winPropDst->GetTransform());
+    ASSERT_EQ(1000u, winPropDst->GetSizeLimits().maxWidth_);
+    ASSERT_EQ(0.5f, winPropDst->GetSizeLimits().minRatio_);
+    delete winPropDst;
+}
+
+/**
+ * @tc.name: MarshallingDefaultBlocks
+ * @tc.desc: Blocks equal to the defaults are left out of the parcel and restored on read
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowPropertyTest, MarshallingDefaultBlocks, Function | SmallTest | Level2)
+{
+    WindowProperty defaultProp;
+    Parcel defaultParcel;
+    ASSERT_EQ(true, defaultProp.Marshalling(defaultParcel));
+
+    WindowProperty namedProp;
+    namedProp.SetWindowName("named");
+    namedProp.SetTouchHotAreas({ { 0, 0, 10, 10 } });
+    Parcel namedParcel;
+    ASSERT_EQ(true, namedProp.Marshalling(namedParcel));
+    ASSERT_LT(defaultParcel.GetDataSize(), namedParcel.GetDataSize());
+
+    WindowProperty* winPropDst = WindowProperty::Unmarshalling(defaultParcel);
+    ASSERT_NE(nullptr, winPropDst);
+    ASSERT_EQ("", winPropDst->GetWindowName());
+    ASSERT_EQ(defaultProp.GetSystemBarProperty(), winPropDst->GetSystemBarProperty());
+    ASSERT_EQ(Transform::Identity(), winPropDst->GetTransform());
+    ASSERT_EQ(UINT32_MAX, winPropDst->GetSizeLimits().maxWidth_);
+    ASSERT_EQ(UNDEFINED_BRIGHTNESS, winPropDst->GetBrightness());
+    delete winPropDst;
+}
+
+/**
+ * @tc.name: UnmarshallingInvalidParcel
+ * @tc.desc: Unknown versions and truncated parcels are rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowPropertyTest, UnmarshallingInvalidParcel, Function | SmallTest | Level2)
+{
+    Parcel versionParcel;
+    versionParcel.WriteUint32(0);
+    versionParcel.WriteUint32(0);
+    ASSERT_EQ(nullptr, WindowProperty::Unmarshalling(versionParcel));
+
+    WindowProperty winPropSrc;
+    winPropSrc.SetWindowRect({ 1, 2, 300, 400 });
+    Parcel fullParcel;
+    ASSERT_EQ(true, winPropSrc.Marshalling(fullParcel));
+    // keep the header and the packed fields, drop the window rect block
+    Parcel truncatedParcel;
+    size_t truncatedSize = fullParcel.GetDataSize() - sizeof(Rect);
+    truncatedParcel.WriteBuffer(reinterpret_cast<const void*>(fullParcel.GetData()), truncatedSize);
+    ASSERT_EQ(nullptr, WindowProperty::Unmarshalling(truncatedParcel));
+
+    winPropSrc.SetSizeLimits(WindowSizeLimits(1000, 1000, 100, 100, 2.0f, 0.5f));
+    Parcel limitsParcel;
+    ASSERT_EQ(true, winPropSrc.Marshalling(limitsParcel));
+    // the size limits block is the last one, drop its min ratio
+    Parcel truncatedLimitsParcel;
+    truncatedSize = limitsParcel.GetDataSize() - sizeof(float);
+    truncatedLimitsParcel.WriteBuffer(reinterpret_cast<const void*>(limitsParcel.GetData()), truncatedSize);
+    ASSERT_EQ(nullptr, WindowProperty::Unmarshalling(truncatedLimitsParcel));
+}
+
 /**
  * @tc.name: CopyFrom
  * @tc.desc: CopyFrom test
@@ -148,6 +275,32 @@ HWTEST_F(WindowPropertyTest, Write, Function | SmallTest | Level2)
     ASSERT_EQ(true, winPropDst.Write(parcel, PropertyChangeAction::ACTION_UPDATE_TRANSFORM_PROPERTY));
     ASSERT_EQ(true, winPropDst.Write(parcel, PropertyChangeAction::ACTION_UPDATE_ANIMATION_FLAG));
 }
+
+/**
+ * @tc.name: WriteCombinedActions
+ * @tc.desc: Write and read several actions in one parcel
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowPropertyTest, WriteCombinedActions, Function | SmallTest | Level2)
+{
+    WindowProperty winPropSrc;
+    Rect rect = { 10, 20, 300, 400 };
+    winPropSrc.SetRequestRect(rect);
+    winPropSrc.SetWindowFlags(static_cast<uint32_t>(WindowFlag::WINDOW_FLAG_NEED_AVOID));
+    winPropSrc.SetTouchable(false);
+    uint32_t actions = static_cast<uint32_t>(PropertyChangeAction::ACTION_UPDATE_RECT) |
+        static_cast<uint32_t>(PropertyChangeAction::ACTION_UPDATE_FLAGS) |
+        static_cast<uint32_t>(PropertyChangeAction::ACTION_UPDATE_TOUCHABLE);
+
+    Parcel parcel;
+    ASSERT_EQ(true, winPropSrc.Write(parcel, static_cast<PropertyChangeAction>(actions)));
+
+    WindowProperty winPropDst;
+    winPropDst.Read(parcel, static_cast<PropertyChangeAction>(actions));
+    ASSERT_EQ(rect, winPropDst.GetRequestRect());
+    ASSERT_EQ(static_cast<uint32_t>(WindowFlag::WINDOW_FLAG_NEED_AVOID), winPropDst.GetWindowFlags());
+    ASSERT_EQ(false, winPropDst.GetTouchable());
+}
 }
 } // namespace Rosen
 } // namespace OHOS
\ No newline at end of file
@@ -16,6 +16,10 @@
 #ifndef OHOS_INPUT_TRANSFER_STATION_H
 #define OHOS_INPUT_TRANSFER_STATION_H
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "input_manager.h"
 #include "pointer_event.h"
 #include "window.h"
@@ -33,12 +37,16 @@ friend class InputEventListener;
 public:
     void AddInputWindow(const sptr<Window>& window);
     void RemoveInputWindow(uint32_t windowId);
+    void Dump(uint32_t windowId, std::vector<std::string>& info);
 
 private:
+    using InputChannelMap = std::unordered_map<uint32_t, sptr<WindowInputChannel>>;
     sptr<WindowInputChannel> GetInputChannel(uint32_t windowId);
 
+    // serializes writers; readers on the input thread only load the published map
     std::mutex mtx_;
-    std::unordered_map<uint32_t, sptr<WindowInputChannel>> windowInputChannels_;
+    // replaced as a whole when a window is added or removed, never modified after publishing
+    std::shared_ptr<const InputChannelMap> windowInputChannels_ = std::make_shared<const InputChannelMap>();
     std::shared_ptr<MMI::IInputEventConsumer> inputListener_ = nullptr;
     std::shared_ptr<AppExecFwk::EventHandler> eventHandler_ = nullptr;
     const std::string INPUT_AND_VSYNC_THREAD = "input_and_vsync_thread";
@@ -20,7 +20,9 @@
 #include <functional>
 #include <map>
 #include <memory>
-#include <unordered_set>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include <refbase.h>
 #include <event_handler.h>
@@ -31,11 +33,17 @@
 
 namespace OHOS {
 namespace Rosen {
+/*
+ * Requests are pushed onto a lock-free list by any thread and taken by the vsync thread in one exchange.
+ * Callbacks are grouped by their frame rate divisor, a group with divisor N fires on every Nth frame of
+ * a continuous animation, so a 30 Hz ui and a 120 Hz drag can share the same receiver.
+ */
 class VsyncStation {
 WM_DECLARE_SINGLE_INSTANCE_BASE(VsyncStation);
 public:
-    ~VsyncStation() = default;
-    void RequestVsync(const std::shared_ptr<VsyncCallback>& vsyncCallback);
+    ~VsyncStation();
+    // the callback is called on every frameRateDivisor-th frame, e.g. 4 for 30 Hz on a 120 Hz display
+    void RequestVsync(const std::shared_ptr<VsyncCallback>& vsyncCallback, uint32_t frameRateDivisor = 1);
     void RemoveCallback();
     void SetIsMainHandlerAvailable(bool available)
     {
@@ -44,28 +52,58 @@ public:
 
     void SetVsyncEventHandler(const std::shared_ptr<AppExecFwk::EventHandler>& eventHandler)
     {
+        std::lock_guard<std::mutex> lock(initMutex_);
         vsyncHandler_ = eventHandler;
     }
+    void Dump(std::vector<std::string>& info) const;
 
 private:
+    struct VsyncRequest {
+        std::shared_ptr<VsyncCallback> callback_;
+        uint32_t frameRateDivisor_ { 1 };
+        VsyncRequest* next_ { nullptr };
+    };
+    struct CallbackGroup {
+        std::vector<std::shared_ptr<VsyncCallback>> callbacks_;
+        int64_t lastFireTimestamp_ { 0 };
+    };
     VsyncStation() = default;
+    void InitVsyncReceiver();
+    void RequestNextVsync(bool checkTimeout);
     static void OnVsync(int64_t nanoTimestamp, void* client);
     void VsyncCallbackInner(int64_t nanoTimestamp);
-    void OnVsyncTimeOut();
+    void TakeRequests();
+    void UpdateFrameStatistics(int64_t nanoTimestamp);
+    bool IsGroupDue(uint32_t divisor, const CallbackGroup& group, int64_t nanoTimestamp) const;
+    static void DeleteRequests(VsyncRequest* head);
 
-    std::mutex mtx_;
-    bool hasRequestedVsync_ = false;
-    bool hasInitVsyncReceiver_ = false;
+    std::mutex initMutex_; // only taken until the receiver is ready
+    std::atomic<bool> hasInitVsyncReceiver_ { false };
     bool isMainHandlerAvailable_ = true;
     const std::string VSYNC_THREAD_ID = "vsync_thread";
     std::shared_ptr<OHOS::Rosen::VSyncReceiver> receiver_ = nullptr;
-    std::unordered_set<std::shared_ptr<VsyncCallback>> vsyncCallbacks_;
+    std::shared_ptr<AppExecFwk::EventHandler> vsyncHandler_ = nullptr;
     VSyncReceiver::FrameCallback frameCallback_ = {
         .userData_ = this,
         .callback_ = OnVsync,
     };
-    std::shared_ptr<AppExecFwk::EventHandler> vsyncHandler_ = nullptr;
-    AppExecFwk::EventHandler::Callback vsyncTimeoutCallback_ = std::bind(&VsyncStation::OnVsyncTimeOut, this);
+
+    std::atomic<VsyncRequest*> pendingRequests_ { nullptr };
+    std::atomic<bool> hasRequestedVsync_ { false };
+    std::atomic<int64_t> lastRequestTime_ { 0 };
+    std::atomic<uint32_t> removeGeneration_ { 0 };
+
+    // only touched on the vsync thread
+    std::map<uint32_t, CallbackGroup> callbackGroups_;
+    std::vector<std::shared_ptr<VsyncCallback>> firingCallbacks_;
+    uint32_t handledRemoveGeneration_ { 0 };
+    bool isContinuousFrame_ { false };
+    int64_t lastVsyncTimestamp_ { 0 };
+    int64_t vsyncPeriod_ { 0 }; // shortest interval seen between continuous frames, 0 until known
+
+    std::atomic<uint64_t> frameCount_ { 0 };
+    std::atomic<uint64_t> frameMissCount_ { 0 };
+    std::atomic<uint64_t> timeoutCount_ { 0 };
 };
 } // namespace Rosen
 } // namespace OHOS
@@ -371,6 +371,8 @@ private:
     void MapFloatingWindowToAppIfNeeded();
     void MapDialogWindowToAppIfNeeded();
     WMError UpdateProperty(PropertyChangeAction action);
+    void BeginPropertyUpdate();
+    WMError CommitPropertyUpdate();
     WMError Destroy(bool needNotifyServer);
     WMError SetBackgroundColor(uint32_t color);
     uint32_t GetBackgroundColor() const;
@@ -407,10 +409,6 @@ private:
     static ColorSpace GetColorSpaceFromSurfaceGamut(ColorGamut ColorGamut);
     static ColorGamut GetSurfaceGamutFromColorSpace(ColorSpace colorSpace);
 
-    static std::map<std::string, std::pair<uint32_t, sptr<Window>>> windowMap_;
-    static std::map<uint32_t, std::vector<sptr<WindowImpl>>> subWindowMap_;
-    static std::map<uint32_t, std::vector<sptr<WindowImpl>>> appFloatingWindowMap_;
-    static std::map<uint32_t, std::vector<sptr<WindowImpl>>> appDialogWindowMap_;
     sptr<WindowProperty> property_;
     WindowState state_ { WindowState::STATE_INITIAL };
     WindowTag windowTag_;
@@ -446,6 +444,9 @@ private:
     bool isMainHandlerAvailable_ = true;
     bool isAppFloatingWindow_ = false;
     bool isFocused_ = false;
+    // property updates between BeginPropertyUpdate and CommitPropertyUpdate are sent as one request
+    bool isPropertyUpdateDeferred_ = false;
+    uint32_t pendingPropertyActions_ = 0;
 };
 } // namespace Rosen
 } // namespace OHOS
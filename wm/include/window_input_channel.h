@@ -15,6 +15,12 @@
 #ifndef OHOS_WINDOW_INPUT_CHANNEL_H
 #define OHOS_WINDOW_INPUT_CHANNEL_H
 
+#include <array>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
 #include <i_input_event_consumer.h>
 #include <key_event.h>
 #include "refbase.h"
@@ -30,12 +36,50 @@ public:
     void HandlePointerEvent(std::shared_ptr<MMI::PointerEvent>& pointerEvent);
     void HandleKeyEvent(std::shared_ptr<MMI::KeyEvent>& keyEvent);
     void Destroy();
+    void Dump(std::vector<std::string>& info) const;
 private:
+    // raw position of the active pointer, kept across coalesced move events to resample the delivered one
+    struct PointerSample {
+        int64_t actionTime_ { 0 };
+        int32_t pointerId_ { 0 };
+        int32_t displayX_ { 0 };
+        int32_t displayY_ { 0 };
+        int32_t windowX_ { 0 };
+        int32_t windowY_ { 0 };
+    };
+    enum class InputEventKind : int32_t {
+        POINTER,
+        KEY,
+    };
+    // fields are written on the input thread and read by dump, a torn record only shows up in the dump
+    struct InputEventRecord {
+        std::atomic<int64_t> actionTime_ { 0 };
+        std::atomic<int32_t> kind_ { 0 };
+        std::atomic<int32_t> action_ { 0 };
+        std::atomic<int32_t> code_ { 0 }; // pointer id or key code
+    };
     bool IsKeyboardEvent(const std::shared_ptr<MMI::KeyEvent>& keyEvent) const;
+    void RecordInputEvent(InputEventKind kind, int64_t actionTime, int32_t action, int32_t code);
+    void AppendPointerHistory(const std::shared_ptr<MMI::PointerEvent>& pointerEvent);
+    std::shared_ptr<MMI::PointerEvent> TakePendingMoveEvent();
+    void RequestMoveEventVsync();
+    void OnVsync(int64_t timestamp);
+    bool ResamplePointerEvent(const std::shared_ptr<MMI::PointerEvent>& pointerEvent, int64_t sampleTime);
     std::mutex mtx_;
     sptr<Window> window_;
     bool isAvailable_;
     static const int32_t MAX_INPUT_NUM = 100;
+    static constexpr size_t INPUT_RECORD_NUM = 64;
+    std::array<InputEventRecord, INPUT_RECORD_NUM> inputRecords_;
+    std::atomic<uint64_t> inputRecordCount_ { 0 };
+    std::atomic<uint64_t> pointerEventCount_ { 0 };
+    std::atomic<uint64_t> keyEventCount_ { 0 };
+    // move events received since the last vsync, only the latest one is delivered
+    std::vector<std::shared_ptr<MMI::PointerEvent>> pendingMoveEvents_;
+    std::deque<PointerSample> pointerHistory_;
+    std::shared_ptr<VsyncCallback> moveEventVsyncCallback_;
+    std::atomic<uint64_t> coalescedEventCount_ { 0 };
+    std::atomic<uint64_t> resampledEventCount_ { 0 };
 };
 }
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_WINDOW_REGISTRY_H
+#define OHOS_WINDOW_REGISTRY_H
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <refbase.h>
+#include "wm_common.h"
+#include "wm_single_instance.h"
+
+namespace OHOS {
+namespace AbilityRuntime {
+class Context;
+}
+namespace Rosen {
+class WindowImpl;
+
+enum class WindowRelation : uint32_t {
+    SUB,
+    APP_FLOATING,
+    APP_DIALOG,
+    END,
+};
+
+/*
+ * Windows created by this process, indexed by name, id and the context of app main windows.
+ * Lookups and writers share one reader-writer lock. Results are copies, so callers may create or
+ * destroy windows while walking them without holding the lock.
+ */
+class WindowRegistry {
+WM_DECLARE_SINGLE_INSTANCE(WindowRegistry);
+public:
+    bool AddWindow(const sptr<WindowImpl>& window);
+    void RemoveWindow(const sptr<WindowImpl>& window);
+    sptr<WindowImpl> FindWindow(const std::string& name) const;
+    sptr<WindowImpl> FindWindow(uint32_t windowId) const;
+    sptr<WindowImpl> FindMainWindow(const AbilityRuntime::Context* context) const;
+    std::vector<sptr<WindowImpl>> GetAllWindows() const;
+    bool IsEmpty() const;
+
+    void AddRelatedWindow(WindowRelation relation, uint32_t parentId, const sptr<WindowImpl>& window);
+    void RemoveRelatedWindow(WindowRelation relation, uint32_t windowId);
+    std::vector<sptr<WindowImpl>> GetRelatedWindows(WindowRelation relation, uint32_t parentId) const;
+    // detaches every window related to parentId and returns them, e.g. to destroy them with the parent
+    std::vector<sptr<WindowImpl>> TakeRelatedWindows(WindowRelation relation, uint32_t parentId);
+
+private:
+    struct RelationIndex {
+        std::unordered_map<uint32_t, std::vector<sptr<WindowImpl>>> children_;
+        std::unordered_map<uint32_t, uint32_t> parentIds_;
+    };
+    RelationIndex& GetRelationIndex(WindowRelation relation);
+    const RelationIndex& GetRelationIndex(WindowRelation relation) const;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, sptr<WindowImpl>> nameMap_;
+    std::unordered_map<uint32_t, sptr<WindowImpl>> idMap_;
+    // app main window ids in creation order for every context
+    std::unordered_map<const AbilityRuntime::Context*, std::vector<uint32_t>> mainWindowIds_;
+    RelationIndex relations_[static_cast<uint32_t>(WindowRelation::END)];
+};
+} // namespace Rosen
+} // namespace OHOS
+#endif // OHOS_WINDOW_REGISTRY_H
@@ -34,7 +34,6 @@ void InputEventListener::OnInputEvent(std::shared_ptr<MMI::KeyEvent> keyEvent) c
         return;
     }
     uint32_t windowId = static_cast<uint32_t>(keyEvent->GetAgentWindowId());
-    WLOGFI("Receive keyEvent, windowId: %{public}u", windowId);
     auto channel = InputTransferStation::GetInstance().GetInputChannel(windowId);
     if (channel == nullptr) {
         WLOGFE("WindowInputChannel is nullptr");
@@ -49,7 +48,7 @@ void InputEventListener::OnInputEvent(std::shared_ptr<MMI::AxisEvent> axisEvent)
         WLOGFE("AxisEvent is nullptr");
         return;
     }
-    WLOGFI("Receive axisEvent, windowId: %{public}d", axisEvent->GetAgentWindowId());
+    WLOGFD("Receive axisEvent, windowId: %{public}d", axisEvent->GetAgentWindowId());
     axisEvent->MarkProcessed();
 }
 
@@ -62,7 +61,6 @@ void InputEventListener::OnInputEvent(std::shared_ptr<MMI::PointerEvent> pointer
     // If handling input event at server, client will receive pointEvent that the winId is -1, intercept log error
     uint32_t invalidId = static_cast<uint32_t>(-1);
     uint32_t windowId = static_cast<uint32_t>(pointerEvent->GetAgentWindowId());
-    WLOGFD("Receive pointerEvent, windowId: %{public}u", windowId);
     auto channel = InputTransferStation::GetInstance().GetInputChannel(windowId);
     if (channel == nullptr) {
         if (windowId != invalidId) {
@@ -79,7 +77,9 @@ void InputTransferStation::AddInputWindow(const sptr<Window>& window)
     WLOGFI("Add input window, windowId: %{public}u", windowId);
     sptr<WindowInputChannel> inputChannel = new WindowInputChannel(window);
     std::lock_guard<std::mutex> lock(mtx_);
-    windowInputChannels_.insert(std::make_pair(windowId, inputChannel));
+    auto inputChannels = std::make_shared<InputChannelMap>(*windowInputChannels_);
+    inputChannels->insert(std::make_pair(windowId, inputChannel));
+    std::atomic_store(&windowInputChannels_, std::shared_ptr<const InputChannelMap>(inputChannels));
     if (inputListener_ == nullptr) {
         WLOGFI("Init input listener, IsMainHandlerAvailable: %{public}u", window->IsMainHandlerAvailable());
         std::shared_ptr<MMI::IInputEventConsumer> listener = std::make_shared<InputEventListener>(InputEventListener());
@@ -110,10 +110,12 @@ void InputTransferStation::RemoveInputWindow(uint32_t windowId)
     sptr<WindowInputChannel> inputChannel = nullptr;
     {
         std::lock_guard<std::mutex> lock(mtx_);
-        auto iter = windowInputChannels_.find(windowId);
-        if (iter != windowInputChannels_.end()) {
+        auto iter = windowInputChannels_->find(windowId);
+        if (iter != windowInputChannels_->end()) {
             inputChannel = iter->second;
-            windowInputChannels_.erase(windowId);
+            auto inputChannels = std::make_shared<InputChannelMap>(*windowInputChannels_);
+            inputChannels->erase(windowId);
+            std::atomic_store(&windowInputChannels_, std::shared_ptr<const InputChannelMap>(inputChannels));
         }
     }
     if (inputChannel != nullptr) {
@@ -125,12 +127,20 @@ void InputTransferStation::RemoveInputWindow(uint32_t windowId)
 
 sptr<WindowInputChannel> InputTransferStation::GetInputChannel(uint32_t windowId)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    auto iter = windowInputChannels_.find(windowId);
-    if (iter == windowInputChannels_.end()) {
+    auto inputChannels = std::atomic_load(&windowInputChannels_);
+    auto iter = inputChannels->find(windowId);
+    if (iter == inputChannels->end()) {
         return nullptr;
     }
     return iter->second;
 }
+
+void InputTransferStation::Dump(uint32_t windowId, std::vector<std::string>& info)
+{
+    auto channel = GetInputChannel(windowId);
+    if (channel != nullptr) {
+        channel->Dump(info);
+    }
+}
 }
 }
@@ -15,6 +15,11 @@
 
 #include "vsync_station.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <sstream>
+
 #include "transaction/rs_interfaces.h"
 #include "window_manager_hilog.h"
 
@@ -22,66 +27,187 @@ namespace OHOS {
 namespace Rosen {
 namespace {
     constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "VsyncStation"};
-    const std::string VSYNC_TIME_OUT_TASK = "vsync_time_out_task";
-    constexpr int64_t VSYNC_TIME_OUT_MILLISECONDS = 600;
+    constexpr int64_t VSYNC_TIME_OUT_NANOSECONDS = 600 * 1000 * 1000; // 600ms
+    // a frame counts as missed once the interval exceeds one and a half periods
+    constexpr int64_t FRAME_MISS_THRESHOLD_NUMERATOR = 3;
+    constexpr int64_t FRAME_MISS_THRESHOLD_DENOMINATOR = 2;
+
+    int64_t GetSteadyTimeNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 }
 WM_IMPLEMENT_SINGLE_INSTANCE(VsyncStation)
 
-void VsyncStation::RequestVsync(const std::shared_ptr<VsyncCallback>& vsyncCallback)
+VsyncStation::~VsyncStation()
 {
-    {
-        std::lock_guard<std::mutex> lock(mtx_);
-        vsyncCallbacks_.insert(vsyncCallback);
-
-        if (!hasInitVsyncReceiver_ || !vsyncHandler_) {
-            auto mainEventRunner = AppExecFwk::EventRunner::GetMainEventRunner();
-            if (mainEventRunner != nullptr && isMainHandlerAvailable_) {
-                WLOGFI("MainEventRunner is available");
-                vsyncHandler_ = std::make_shared<AppExecFwk::EventHandler>(mainEventRunner);
-            } else {
-                WLOGFI("MainEventRunner is not available");
-                if (!vsyncHandler_) {
-                    vsyncHandler_ = std::make_shared<AppExecFwk::EventHandler>(
-                        AppExecFwk::EventRunner::Create(VSYNC_THREAD_ID));
-                }
-            }
-            auto& rsClient = OHOS::Rosen::RSInterfaces::GetInstance();
-            while (receiver_ == nullptr) {
-                receiver_ = rsClient.CreateVSyncReceiver("WM_" + std::to_string(::getpid()), vsyncHandler_);
-            }
-            receiver_->Init();
-            hasInitVsyncReceiver_ = true;
+    DeleteRequests(pendingRequests_.exchange(nullptr));
+}
+
+void VsyncStation::InitVsyncReceiver()
+{
+    if (hasInitVsyncReceiver_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(initMutex_);
+    if (hasInitVsyncReceiver_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto mainEventRunner = AppExecFwk::EventRunner::GetMainEventRunner();
+    if (mainEventRunner != nullptr && isMainHandlerAvailable_) {
+        WLOGFI("MainEventRunner is available");
+        vsyncHandler_ = std::make_shared<AppExecFwk::EventHandler>(mainEventRunner);
+    } else {
+        WLOGFI("MainEventRunner is not available");
+        if (!vsyncHandler_) {
+            vsyncHandler_ = std::make_shared<AppExecFwk::EventHandler>(
+                AppExecFwk::EventRunner::Create(VSYNC_THREAD_ID));
         }
-        if (hasRequestedVsync_) {
+    }
+    auto& rsClient = OHOS::Rosen::RSInterfaces::GetInstance();
+    while (receiver_ == nullptr) {
+        receiver_ = rsClient.CreateVSyncReceiver("WM_" + std::to_string(::getpid()), vsyncHandler_);
+    }
+    receiver_->Init();
+    hasInitVsyncReceiver_.store(true, std::memory_order_release);
+}
+
+void VsyncStation::RequestVsync(const std::shared_ptr<VsyncCallback>& vsyncCallback, uint32_t frameRateDivisor)
+{
+    if (vsyncCallback == nullptr) {
+        return;
+    }
+    InitVsyncReceiver();
+    auto request = new VsyncRequest { vsyncCallback, std::max(frameRateDivisor, 1u),
+        pendingRequests_.load(std::memory_order_relaxed) };
+    while (!pendingRequests_.compare_exchange_weak(request->next_, request,
+        std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    RequestNextVsync(true);
+}
+
+void VsyncStation::RequestNextVsync(bool checkTimeout)
+{
+    int64_t now = GetSteadyTimeNanoseconds();
+    if (hasRequestedVsync_.exchange(true, std::memory_order_acq_rel)) {
+        // no timeout task per frame, a request that stays unanswered is detected by the next one
+        if (!checkTimeout || now - lastRequestTime_.load(std::memory_order_relaxed) <= VSYNC_TIME_OUT_NANOSECONDS) {
             return;
         }
-        hasRequestedVsync_ = true;
-        vsyncHandler_->RemoveTask(VSYNC_TIME_OUT_TASK);
-        vsyncHandler_->PostTask(vsyncTimeoutCallback_, VSYNC_TIME_OUT_TASK, VSYNC_TIME_OUT_MILLISECONDS);
+        timeoutCount_.fetch_add(1, std::memory_order_relaxed);
+        WLOGFI("[WM] Vsync time out, request again");
     }
+    lastRequestTime_.store(now, std::memory_order_relaxed);
     receiver_->RequestNextVSync(frameCallback_);
 }
 
 void VsyncStation::RemoveCallback()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
     WLOGFI("[WM] Remove Vsync callback");
-    vsyncCallbacks_.clear();
+    // the groups belong to the vsync thread, they are dropped there on the next frame
+    removeGeneration_.fetch_add(1, std::memory_order_release);
+    DeleteRequests(pendingRequests_.exchange(nullptr, std::memory_order_acquire));
+}
+
+void VsyncStation::DeleteRequests(VsyncRequest* head)
+{
+    while (head != nullptr) {
+        VsyncRequest* next = head->next_;
+        delete head;
+        head = next;
+    }
+}
+
+void VsyncStation::TakeRequests()
+{
+    uint32_t removeGeneration = removeGeneration_.load(std::memory_order_acquire);
+    if (removeGeneration != handledRemoveGeneration_) {
+        handledRemoveGeneration_ = removeGeneration;
+        callbackGroups_.clear();
+    }
+    VsyncRequest* head = pendingRequests_.exchange(nullptr, std::memory_order_acquire);
+    // the list is in reverse submission order, reverse it so callbacks fire in the order they were requested
+    VsyncRequest* ordered = nullptr;
+    while (head != nullptr) {
+        VsyncRequest* next = head->next_;
+        head->next_ = ordered;
+        ordered = head;
+        head = next;
+    }
+    while (ordered != nullptr) {
+        VsyncRequest* next = ordered->next_;
+        auto& callbacks = callbackGroups_[ordered->frameRateDivisor_].callbacks_;
+        // a callback requested several times before its frame still fires once
+        if (std::find(callbacks.begin(), callbacks.end(), ordered->callback_) == callbacks.end()) {
+            callbacks.push_back(std::move(ordered->callback_));
+        }
+        delete ordered;
+        ordered = next;
+    }
+}
+
+void VsyncStation::UpdateFrameStatistics(int64_t nanoTimestamp)
+{
+    frameCount_.fetch_add(1, std::memory_order_relaxed);
+    if (!isContinuousFrame_ || lastVsyncTimestamp_ == 0 || nanoTimestamp <= lastVsyncTimestamp_) {
+        // intervals between animations are idle time, not missed frames
+        lastVsyncTimestamp_ = nanoTimestamp;
+        return;
+    }
+    int64_t interval = nanoTimestamp - lastVsyncTimestamp_;
+    lastVsyncTimestamp_ = nanoTimestamp;
+    if (vsyncPeriod_ == 0 || interval < vsyncPeriod_) {
+        vsyncPeriod_ = interval;
+        return;
+    }
+    if (interval * FRAME_MISS_THRESHOLD_DENOMINATOR > vsyncPeriod_ * FRAME_MISS_THRESHOLD_NUMERATOR) {
+        frameMissCount_.fetch_add(static_cast<uint64_t>((interval + vsyncPeriod_ / 2) / vsyncPeriod_ - 1),
+            std::memory_order_relaxed);
+    }
+}
+
+bool VsyncStation::IsGroupDue(uint32_t divisor, const CallbackGroup& group, int64_t nanoTimestamp) const
+{
+    if (divisor == 1 || vsyncPeriod_ == 0 || group.lastFireTimestamp_ == 0) {
+        return true;
+    }
+    // half a period of slack, so jitter in the timestamps does not push the group to the frame after
+    return nanoTimestamp - group.lastFireTimestamp_ >= static_cast<int64_t>(divisor) * vsyncPeriod_ - vsyncPeriod_ / 2;
 }
 
 void VsyncStation::VsyncCallbackInner(int64_t timestamp)
 {
-    std::unordered_set<std::shared_ptr<VsyncCallback>> vsyncCallbacks;
-    {
-        std::lock_guard<std::mutex> lock(mtx_);
-        hasRequestedVsync_ = false;
-        vsyncCallbacks = vsyncCallbacks_;
-        vsyncCallbacks_.clear();
-        vsyncHandler_->RemoveTask(VSYNC_TIME_OUT_TASK);
+    hasRequestedVsync_.store(false, std::memory_order_release);
+    UpdateFrameStatistics(timestamp);
+    TakeRequests();
+    firingCallbacks_.clear();
+    for (auto iter = callbackGroups_.begin(); iter != callbackGroups_.end();) {
+        auto& group = iter->second;
+        if (group.callbacks_.empty()) {
+            iter = callbackGroups_.erase(iter);
+            continue;
+        }
+        if (IsGroupDue(iter->first, group, timestamp)) {
+            group.lastFireTimestamp_ = timestamp;
+            std::move(group.callbacks_.begin(), group.callbacks_.end(), std::back_inserter(firingCallbacks_));
+            group.callbacks_.clear();
+        }
+        ++iter;
     }
-    for (const auto& callback: vsyncCallbacks) {
+    for (const auto& callback : firingCallbacks_) {
         callback->onCallback(timestamp);
     }
+    firingCallbacks_.clear();
+    // callbacks waiting for a later frame of their group, or requested again while firing, need the next vsync
+    bool hasPendingCallbacks = pendingRequests_.load(std::memory_order_acquire) != nullptr;
+    for (const auto& [divisor, group] : callbackGroups_) {
+        hasPendingCallbacks = hasPendingCallbacks || !group.callbacks_.empty();
+    }
+    isContinuousFrame_ = hasPendingCallbacks;
+    if (hasPendingCallbacks) {
+        RequestNextVsync(false);
+    }
 }
 
 void VsyncStation::OnVsync(int64_t timestamp, void* client)
@@ -94,11 +220,13 @@ void VsyncStation::OnVsync(int64_t timestamp, void* client)
     }
 }
 
-void VsyncStation::OnVsyncTimeOut()
+void VsyncStation::Dump(std::vector<std::string>& info) const
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    WLOGFI("[WM] Vsync time out");
-    hasRequestedVsync_ = false;
+    std::ostringstream oss;
+    oss << "VsyncStation: frames: " << frameCount_.load(std::memory_order_relaxed)
+        << ", missed frames: " << frameMissCount_.load(std::memory_order_relaxed)
+        << ", timeouts: " << timeoutCount_.load(std::memory_order_relaxed);
+    info.push_back(oss.str());
+}
 }
 }
-}
\ No newline at end of file
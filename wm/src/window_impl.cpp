@@ -32,6 +32,7 @@
 #include "window_agent.h"
 #include "window_helper.h"
 #include "window_manager_hilog.h"
+#include "window_registry.h"
 #include "wm_common.h"
 #include "wm_common_inner.h"
 #include "wm_math.h"
@@ -49,10 +50,6 @@ const WindowImpl::ColorSpaceConvertMap WindowImpl::colorSpaceConvertMap[] = {
     { ColorSpace::COLOR_SPACE_WIDE_GAMUT, ColorGamut::COLOR_GAMUT_DCI_P3 },
 };
 
-std::map<std::string, std::pair<uint32_t, sptr<Window>>> WindowImpl::windowMap_;
-std::map<uint32_t, std::vector<sptr<WindowImpl>>> WindowImpl::subWindowMap_;
-std::map<uint32_t, std::vector<sptr<WindowImpl>>> WindowImpl::appFloatingWindowMap_;
-std::map<uint32_t, std::vector<sptr<WindowImpl>>> WindowImpl::appDialogWindowMap_;
 static int constructorCnt = 0;
 static int deConstructorCnt = 0;
 WindowImpl::WindowImpl(const sptr<WindowOption>& option)
@@ -123,11 +120,7 @@ WindowImpl::~WindowImpl()
 
 sptr<Window> WindowImpl::Find(const std::string& name)
 {
-    auto iter = windowMap_.find(name);
-    if (iter == windowMap_.end()) {
-        return nullptr;
-    }
-    return iter->second.second;
+    return WindowRegistry::GetInstance().FindWindow(name);
 }
 
 const std::shared_ptr<AbilityRuntime::Context> WindowImpl::GetContext() const
@@ -137,18 +130,17 @@ const std::shared_ptr<AbilityRuntime::Context> WindowImpl::GetContext() const
 
 sptr<Window> WindowImpl::FindTopWindow(uint32_t topWinId)
 {
-    if (windowMap_.empty()) {
+    if (WindowRegistry::GetInstance().IsEmpty()) {
         WLOGFE("Please create mainWindow First!");
         return nullptr;
     }
-    for (auto iter = windowMap_.begin(); iter != windowMap_.end(); iter++) {
-        if (topWinId == iter->second.first) {
-            WLOGFI("FindTopWindow id: %{public}u", topWinId);
-            return iter->second.second;
-        }
+    sptr<WindowImpl> window = WindowRegistry::GetInstance().FindWindow(topWinId);
+    if (window == nullptr) {
+        WLOGFE("Cannot find topWindow!");
+        return nullptr;
     }
-    WLOGFE("Cannot find topWindow!");
-    return nullptr;
+    WLOGFI("FindTopWindow id: %{public}u", topWinId);
+    return window;
 }
 
 sptr<Window> WindowImpl::GetTopWindowWithId(uint32_t mainWinId)
@@ -164,18 +156,15 @@ sptr<Window> WindowImpl::GetTopWindowWithId(uint32_t mainWinId)
 
 sptr<Window> WindowImpl::GetTopWindowWithContext(const std::shared_ptr<AbilityRuntime::Context>& context)
 {
-    if (windowMap_.empty()) {
+    if (WindowRegistry::GetInstance().IsEmpty()) {
         WLOGFE("Please create mainWindow First!");
         return nullptr;
     }
     uint32_t mainWinId = INVALID_WINDOW_ID;
-    for (auto iter = windowMap_.begin(); iter != windowMap_.end(); iter++) {
-        auto win = iter->second.second;
-        if (context.get() == win->GetContext().get() && WindowHelper::IsMainWindow(win->GetType())) {
-            mainWinId = win->GetWindowId();
-            WLOGFI("GetTopWindow Find MainWinId:%{public}u.", mainWinId);
-            break;
-        }
+    sptr<WindowImpl> mainWindow = WindowRegistry::GetInstance().FindMainWindow(context.get());
+    if (mainWindow != nullptr) {
+        mainWinId = mainWindow->GetWindowId();
+        WLOGFI("GetTopWindow Find MainWinId:%{public}u.", mainWinId);
     }
     WLOGFI("GetTopWindowfinal MainWinId:%{public}u!", mainWinId);
     if (mainWinId == INVALID_WINDOW_ID) {
@@ -193,17 +182,17 @@ sptr<Window> WindowImpl::GetTopWindowWithContext(const std::shared_ptr<AbilityRu
 
 std::vector<sptr<Window>> WindowImpl::GetSubWindow(uint32_t parentId)
 {
-    if (subWindowMap_.find(parentId) == subWindowMap_.end()) {
+    auto subWindows = WindowRegistry::GetInstance().GetRelatedWindows(WindowRelation::SUB, parentId);
+    if (subWindows.empty()) {
         WLOGFE("Cannot parentWindow with id: %{public}u!", parentId);
         return std::vector<sptr<Window>>();
     }
-    return std::vector<sptr<Window>>(subWindowMap_[parentId].begin(), subWindowMap_[parentId].end());
+    return std::vector<sptr<Window>>(subWindows.begin(), subWindows.end());
 }
 
 void WindowImpl::UpdateConfigurationForAll(const std::shared_ptr<AppExecFwk::Configuration>& configuration)
 {
-    for (auto& winPair : windowMap_) {
-        auto window = winPair.second.second;
+    for (auto& window : WindowRegistry::GetInstance().GetAllWindows()) {
         window->UpdateConfiguration(configuration);
     }
 }
@@ -579,6 +568,8 @@ void WindowImpl::DumpInfo(const std::vector<std::string>& params, std::vector<st
     if (uiContent_ != nullptr) {
         uiContent_->DumpInfo(params, info);
     }
+    VsyncStation::GetInstance().Dump(info);
+    InputTransferStation::GetInstance().Dump(GetWindowId(), info);
 }
 
 WMError WindowImpl::SetSystemBarProperty(WindowType type, const SystemBarProperty& property)
@@ -656,6 +647,8 @@ WMError WindowImpl::SetFullScreen(bool status)
         statusProperty.enable_ = true;
         naviProperty.enable_ = true;
     }
+    // both system bars and the avoid flag reach the server in one request
+    BeginPropertyUpdate();
     WMError ret = SetSystemBarProperty(WindowType::WINDOW_TYPE_STATUS_BAR, statusProperty);
     if (ret != WMError::WM_OK) {
         WLOGFE("SetSystemBarProperty errCode:%{public}d winId:%{public}u",
@@ -671,6 +664,12 @@ WMError WindowImpl::SetFullScreen(bool status)
         WLOGFE("SetLayoutFullScreen errCode:%{public}d winId:%{public}u",
             static_cast<int32_t>(ret), property_->GetWindowId());
     }
+    WMError commitRet = CommitPropertyUpdate();
+    if (commitRet != WMError::WM_OK) {
+        WLOGFE("CommitPropertyUpdate errCode:%{public}d winId:%{public}u",
+            static_cast<int32_t>(commitRet), property_->GetWindowId());
+        ret = (ret == WMError::WM_OK) ? commitRet : ret;
+    }
     return ret;
 }
 
@@ -680,15 +679,11 @@ void WindowImpl::MapFloatingWindowToAppIfNeeded()
         return;
     }
 
-    for (auto& winPair : windowMap_) {
-        auto win = winPair.second.second;
-        if (win->GetType() == WindowType::WINDOW_TYPE_APP_MAIN_WINDOW &&
-            context_.get() == win->GetContext().get()) {
-            appFloatingWindowMap_[win->GetWindowId()].push_back(this);
-            WLOGFI("Map FloatingWindow %{public}u to AppMainWindow %{public}u, type is %{public}u",
-                GetWindowId(), win->GetWindowId(), GetType());
-            return;
-        }
+    sptr<WindowImpl> win = WindowRegistry::GetInstance().FindMainWindow(context_.get());
+    if (win != nullptr && win->GetType() == WindowType::WINDOW_TYPE_APP_MAIN_WINDOW) {
+        WindowRegistry::GetInstance().AddRelatedWindow(WindowRelation::APP_FLOATING, win->GetWindowId(), this);
+        WLOGFI("Map FloatingWindow %{public}u to AppMainWindow %{public}u, type is %{public}u",
+            GetWindowId(), win->GetWindowId(), GetType());
     }
 }
 
@@ -698,22 +693,42 @@ void WindowImpl::MapDialogWindowToAppIfNeeded()
         return;
     }
 
-    for (auto& winPair : windowMap_) {
-        auto win = winPair.second.second;
-        if (win->GetType() == WindowType::WINDOW_TYPE_APP_MAIN_WINDOW &&
-            context_.get() == win->GetContext().get()) {
-            appDialogWindowMap_[win->GetWindowId()].push_back(this);
-            WLOGFI("Map DialogWindow %{public}u to AppMainWindow %{public}u", GetWindowId(), win->GetWindowId());
-            return;
-        }
+    sptr<WindowImpl> win = WindowRegistry::GetInstance().FindMainWindow(context_.get());
+    if (win != nullptr && win->GetType() == WindowType::WINDOW_TYPE_APP_MAIN_WINDOW) {
+        WindowRegistry::GetInstance().AddRelatedWindow(WindowRelation::APP_DIALOG, win->GetWindowId(), this);
+        WLOGFI("Map DialogWindow %{public}u to AppMainWindow %{public}u", GetWindowId(), win->GetWindowId());
     }
 }
 
 WMError WindowImpl::UpdateProperty(PropertyChangeAction action)
 {
+    // mode is still sent at once, SetWindowMode rolls the client mode back when the server rejects it
+    if (isPropertyUpdateDeferred_ && action != PropertyChangeAction::ACTION_UPDATE_MODE) {
+        pendingPropertyActions_ |= static_cast<uint32_t>(action);
+        return WMError::WM_OK;
+    }
     return SingletonContainer::Get<WindowAdapter>().UpdateProperty(property_, action);
 }
 
+void WindowImpl::BeginPropertyUpdate()
+{
+    isPropertyUpdateDeferred_ = true;
+}
+
+WMError WindowImpl::CommitPropertyUpdate()
+{
+    isPropertyUpdateDeferred_ = false;
+    if (pendingPropertyActions_ == 0) {
+        return WMError::WM_OK;
+    }
+    auto action = static_cast<PropertyChangeAction>(pendingPropertyActions_);
+    pendingPropertyActions_ = 0;
+    if (!IsWindowValid()) {
+        return WMError::WM_ERROR_INVALID_WINDOW;
+    }
+    return UpdateProperty(action);
+}
+
 void WindowImpl::GetConfigurationFromAbilityInfo()
 {
     auto abilityContext = AbilityRuntime::Context::ConvertTo<AbilityRuntime::AbilityContext>(context_);
@@ -788,13 +803,10 @@ bool WindowImpl::IsAppMainOrSubOrFloatingWindow()
     }
 
     if (WindowHelper::IsAppFloatingWindow(GetType())) {
-        for (auto& winPair : windowMap_) {
-            auto win = winPair.second.second;
-            if (win != nullptr && win->GetType() == WindowType::WINDOW_TYPE_APP_MAIN_WINDOW &&
-                context_.get() == win->GetContext().get()) {
-                isAppFloatingWindow_ = true;
-                return true;
-            }
+        sptr<WindowImpl> win = WindowRegistry::GetInstance().FindMainWindow(context_.get());
+        if (win != nullptr && win->GetType() == WindowType::WINDOW_TYPE_APP_MAIN_WINDOW) {
+            isAppFloatingWindow_ = true;
+            return true;
         }
     }
     return false;
@@ -889,17 +901,18 @@ WMError WindowImpl::Create(const std::string& parentName, const std::shared_ptr<
 {
     WLOGFI("[Client] Window [name:%{public}s] Create", name_.c_str());
     // check window name, same window names are forbidden
-    if (windowMap_.find(name_) != windowMap_.end()) {
+    if (WindowRegistry::GetInstance().FindWindow(name_) != nullptr) {
         WLOGFE("WindowName(%{public}s) already exists.", name_.c_str());
         return WMError::WM_ERROR_INVALID_PARAM;
     }
     // check parent name, if create sub window and there is not exist parent Window, then return
     if (parentName != "") {
-        if (windowMap_.find(parentName) == windowMap_.end()) {
+        sptr<WindowImpl> parentWindow = WindowRegistry::GetInstance().FindWindow(parentName);
+        if (parentWindow == nullptr) {
             WLOGFE("ParentName is empty or valid. ParentName is %{public}s", parentName.c_str());
             return WMError::WM_ERROR_INVALID_PARAM;
         } else {
-            uint32_t parentId = windowMap_[parentName].first;
+            uint32_t parentId = parentWindow->GetWindowId();
             property_->SetParentId(parentId);
         }
     }
@@ -935,9 +948,14 @@ WMError WindowImpl::Create(const std::string& parentName, const std::shared_ptr<
         return ret;
     }
     property_->SetWindowId(windowId);
-    windowMap_.insert(std::make_pair(name_, std::pair<uint32_t, sptr<Window>>(windowId, this)));
-    if (parentName != "") { // add to subWindowMap_
-        subWindowMap_[property_->GetParentId()].push_back(this);
+    // a window of the same name created concurrently may have been added since the check above
+    if (!WindowRegistry::GetInstance().AddWindow(this)) {
+        WLOGFE("WindowName(%{public}s) already exists.", name_.c_str());
+        SingletonContainer::Get<WindowAdapter>().DestroyWindow(windowId);
+        return WMError::WM_ERROR_INVALID_PARAM;
+    }
+    if (parentName != "") { // add to sub windows of the parent
+        WindowRegistry::GetInstance().AddRelatedWindow(WindowRelation::SUB, property_->GetParentId(), this);
     }
 
     MapFloatingWindowToAppIfNeeded();
@@ -963,88 +981,29 @@ WMError WindowImpl::BindDialogTarget(sptr<IRemoteObject> targetToken)
 
 void WindowImpl::DestroyDialogWindow()
 {
-    // remove from appDialogWindowMap_
-    for (auto& dialogWindows: appDialogWindowMap_) {
-        for (auto iter = dialogWindows.second.begin(); iter != dialogWindows.second.end(); ++iter) {
-            if ((*iter) == nullptr) {
-                continue;
-            }
-            if ((*iter)->GetWindowId() == GetWindowId()) {
-                dialogWindows.second.erase(iter);
-                break;
-            }
-        }
-    }
-
+    WindowRegistry::GetInstance().RemoveRelatedWindow(WindowRelation::APP_DIALOG, GetWindowId());
     // Destroy app dialog window if exist
-    if (appDialogWindowMap_.count(GetWindowId()) > 0) {
-        auto& dialogWindows = appDialogWindowMap_.at(GetWindowId());
-        for (auto iter = dialogWindows.begin(); iter != dialogWindows.end(); iter = dialogWindows.begin()) {
-            if ((*iter) == nullptr) {
-                dialogWindows.erase(iter);
-                continue;
-            }
-            (*iter)->Destroy(false);
-        }
-        appDialogWindowMap_.erase(GetWindowId());
+    for (auto& dialogWindow : WindowRegistry::GetInstance().TakeRelatedWindows(WindowRelation::APP_DIALOG,
+        GetWindowId())) {
+        dialogWindow->Destroy(false);
     }
 }
 
 void WindowImpl::DestroyFloatingWindow()
 {
-    // remove from appFloatingWindowMap_
-    for (auto& floatingWindows: appFloatingWindowMap_) {
-        for (auto iter = floatingWindows.second.begin(); iter != floatingWindows.second.end(); ++iter) {
-            if ((*iter) == nullptr) {
-                continue;
-            }
-            if ((*iter)->GetWindowId() == GetWindowId()) {
-                floatingWindows.second.erase(iter);
-                break;
-            }
-        }
-    }
-
+    WindowRegistry::GetInstance().RemoveRelatedWindow(WindowRelation::APP_FLOATING, GetWindowId());
     // Destroy app floating window if exist
-    if (appFloatingWindowMap_.count(GetWindowId()) > 0) {
-        auto& floatingWindows = appFloatingWindowMap_.at(GetWindowId());
-        for (auto iter = floatingWindows.begin(); iter != floatingWindows.end(); iter = floatingWindows.begin()) {
-            if ((*iter) == nullptr) {
-                floatingWindows.erase(iter);
-                continue;
-            }
-            (*iter)->Destroy();
-        }
-        appFloatingWindowMap_.erase(GetWindowId());
+    for (auto& floatingWindow : WindowRegistry::GetInstance().TakeRelatedWindows(WindowRelation::APP_FLOATING,
+        GetWindowId())) {
+        floatingWindow->Destroy();
     }
 }
 
 void WindowImpl::DestroySubWindow()
 {
-    if (subWindowMap_.count(property_->GetParentId()) > 0) { // remove from subWindowMap_
-        std::vector<sptr<WindowImpl>>& subWindows = subWindowMap_.at(property_->GetParentId());
-        for (auto iter = subWindows.begin(); iter < subWindows.end(); ++iter) {
-            if ((*iter) == nullptr) {
-                continue;
-            }
-            if ((*iter)->GetWindowId() == GetWindowId()) {
-                subWindows.erase(iter);
-                break;
-            }
-        }
-    }
-
-    if (subWindowMap_.count(GetWindowId()) > 0) { // remove from subWindowMap_ and windowMap_
-        auto& subWindows = subWindowMap_.at(GetWindowId());
-        for (auto iter = subWindows.begin(); iter != subWindows.end(); iter = subWindows.begin()) {
-            if ((*iter) == nullptr) {
-                subWindows.erase(iter);
-                continue;
-            }
-            (*iter)->Destroy(false);
-        }
-        subWindowMap_[GetWindowId()].clear();
-        subWindowMap_.erase(GetWindowId());
+    WindowRegistry::GetInstance().RemoveRelatedWindow(WindowRelation::SUB, GetWindowId());
+    for (auto& subWindow : WindowRegistry::GetInstance().TakeRelatedWindows(WindowRelation::SUB, GetWindowId())) {
+        subWindow->Destroy(false);
     }
 }
 
@@ -1083,10 +1042,8 @@ WMError WindowImpl::Destroy(bool needNotifyServer)
     WMError ret = WMError::WM_OK;
     if (needNotifyServer) {
         NotifyBeforeDestroy(GetWindowName());
-        if (subWindowMap_.count(GetWindowId()) > 0) {
-            for (auto& subWindow : subWindowMap_.at(GetWindowId())) {
-                NotifyBeforeSubWindowDestroy(subWindow);
-            }
+        for (auto& subWindow : WindowRegistry::GetInstance().GetRelatedWindows(WindowRelation::SUB, GetWindowId())) {
+            NotifyBeforeSubWindowDestroy(subWindow);
         }
         ret = SingletonContainer::Get<WindowAdapter>().DestroyWindow(property_->GetWindowId());
         RecordLifeCycleExceptionEvent(LifeCycleEvent::DESTROY_EVENT, ret);
@@ -1101,7 +1058,7 @@ WMError WindowImpl::Destroy(bool needNotifyServer)
     if (needRemoveWindowInputChannel_) {
         InputTransferStation::GetInstance().RemoveInputWindow(property_->GetWindowId());
     }
-    windowMap_.erase(GetWindowName());
+    WindowRegistry::GetInstance().RemoveWindow(this);
     DestroySubWindow();
     DestroyFloatingWindow();
     DestroyDialogWindow();
@@ -2067,7 +2024,7 @@ void WindowImpl::ConsumeKeyEvent(std::shared_ptr<MMI::KeyEvent>& keyEvent)
 {
     int32_t keyCode = keyEvent->GetKeyCode();
     int32_t keyAction = keyEvent->GetKeyAction();
-    WLOGFI("KeyCode: %{public}d, action: %{public}d", keyCode, keyAction);
+    WLOGFD("KeyCode: %{public}d, action: %{public}d", keyCode, keyAction);
     if (keyCode == MMI::KeyEvent::KEYCODE_BACK && keyAction == MMI::KeyEvent::KEY_ACTION_UP) {
         HandleBackKeyPressedEvent(keyEvent);
     } else {
@@ -2077,10 +2034,8 @@ void WindowImpl::ConsumeKeyEvent(std::shared_ptr<MMI::KeyEvent>& keyEvent)
             inputEventConsumer = inputEventConsumer_;
         }
         if (inputEventConsumer != nullptr) {
-            WLOGFI("Transfer key event to inputEventConsumer");
             (void)inputEventConsumer->OnInputEvent(keyEvent);
         } else if (uiContent_ != nullptr) {
-            WLOGFI("Transfer key event to uiContent");
             (void)uiContent_->ProcessKeyEvent(keyEvent);
         } else {
             WLOGFE("There is no key event consumer");
@@ -2385,10 +2340,8 @@ void WindowImpl::ConsumePointerEvent(const std::shared_ptr<MMI::PointerEvent>& p
         inputEventConsumer = inputEventConsumer_;
     }
     if (inputEventConsumer != nullptr) {
-        WLOGFI("Transfer pointer event to inputEventConsumer");
         (void)inputEventConsumer->OnInputEvent(pointerEvent);
     } else if (uiContent_ != nullptr) {
-        WLOGFI("Transfer pointer event to uiContent");
         (void)uiContent_->ProcessPointerEvent(pointerEvent);
     } else {
         WLOGE("pointerEvent is not consumed, windowId: %{public}u", GetWindowId());
@@ -2424,10 +2377,7 @@ void WindowImpl::UpdateConfiguration(const std::shared_ptr<AppExecFwk::Configura
         WLOGFD("notify ace winId:%{public}u", GetWindowId());
         uiContent_->UpdateConfiguration(configuration);
     }
-    if (subWindowMap_.count(GetWindowId()) == 0) {
-        return;
-    }
-    for (auto& subWindow : subWindowMap_.at(GetWindowId())) {
+    for (auto& subWindow : WindowRegistry::GetInstance().GetRelatedWindows(WindowRelation::SUB, GetWindowId())) {
         subWindow->UpdateConfiguration(configuration);
     }
 }
@@ -2831,8 +2781,8 @@ bool WindowImpl::CheckCameraFloatingWindowMultiCreated(WindowType type)
         return false;
     }
 
-    for (auto& winPair : windowMap_) {
-        if (winPair.second.second->GetType() == WindowType::WINDOW_TYPE_FLOAT_CAMERA) {
+    for (auto& window : WindowRegistry::GetInstance().GetAllWindows()) {
+        if (window->GetType() == WindowType::WINDOW_TYPE_FLOAT_CAMERA) {
             return true;
         }
     }
@@ -14,13 +14,31 @@
  */
 
 #include "window_input_channel.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
 #include <input_method_controller.h>
+#include <sstream>
 #include "window_manager_hilog.h"
 
 namespace OHOS {
 namespace Rosen {
 namespace {
     constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WindowInputChannel"};
+    // one summary line per this many events instead of a line per event
+    constexpr uint64_t INPUT_LOG_SAMPLE_INTERVAL = 1024;
+    constexpr size_t POINTER_HISTORY_NUM = 32;
+    constexpr int64_t NS_PER_US = 1000;
+    // resample a little behind the frame time so that it usually falls between two real samples
+    constexpr int64_t RESAMPLE_LATENCY_US = 5000;
+    constexpr int64_t RESAMPLE_MIN_DELTA_US = 2000;
+    constexpr int64_t RESAMPLE_MAX_DELTA_US = 20000;
+    constexpr int64_t RESAMPLE_MAX_PREDICTION_US = 8000;
+
+    int32_t Lerp(int32_t from, int32_t to, double alpha)
+    {
+        return static_cast<int32_t>(std::lround(from + (to - from) * alpha));
+    }
 }
 WindowInputChannel::WindowInputChannel(const sptr<Window>& window): window_(window), isAvailable_(true)
 {
@@ -38,8 +56,12 @@ void WindowInputChannel::HandleKeyEvent(std::shared_ptr<MMI::KeyEvent>& keyEvent
         WLOGFE("keyEvent is nullptr");
         return;
     }
-    WLOGFI("Receive key event, windowId: %{public}u, keyCode: %{public}d",
-        window_->GetWindowId(), keyEvent->GetKeyCode());
+    uint64_t keyEventCount = keyEventCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    RecordInputEvent(InputEventKind::KEY, keyEvent->GetActionTime(), keyEvent->GetKeyAction(),
+        keyEvent->GetKeyCode());
+    if (keyEventCount % INPUT_LOG_SAMPLE_INTERVAL == 0) {
+        WLOGFI("windowId: %{public}u, key events: %{public}" PRIu64"", window_->GetWindowId(), keyEventCount);
+    }
     if (window_->GetType() == WindowType::WINDOW_TYPE_DIALOG) {
         if (keyEvent->GetAgentWindowId() != keyEvent->GetTargetWindowId()) {
             window_->NotifyTouchDialogTarget();
@@ -50,11 +72,9 @@ void WindowInputChannel::HandleKeyEvent(std::shared_ptr<MMI::KeyEvent>& keyEvent
     bool isKeyboardEvent = IsKeyboardEvent(keyEvent);
     bool inputMethodHasProcessed = false;
     if (isKeyboardEvent) {
-        WLOGFI("dispatch keyEvent to input method");
         inputMethodHasProcessed = MiscServices::InputMethodController::GetInstance()->dispatchKeyEvent(keyEvent);
     }
     if (!inputMethodHasProcessed) {
-        WLOGFI("dispatch keyEvent to ACE");
         window_->ConsumeKeyEvent(keyEvent);
     }
 }
@@ -65,8 +85,13 @@ void WindowInputChannel::HandlePointerEvent(std::shared_ptr<MMI::PointerEvent>&
         WLOGFE("pointerEvent is nullptr");
         return;
     }
-    WLOGFI("Receive pointer event, windowId: %{public}u, action: %{public}d",
-        window_->GetWindowId(), pointerEvent->GetPointerAction());
+    uint64_t pointerEventCount = pointerEventCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    RecordInputEvent(InputEventKind::POINTER, pointerEvent->GetActionTime(), pointerEvent->GetPointerAction(),
+        pointerEvent->GetPointerId());
+    if (pointerEventCount % INPUT_LOG_SAMPLE_INTERVAL == 0) {
+        WLOGFI("windowId: %{public}u, pointer events: %{public}" PRIu64"", window_->GetWindowId(),
+            pointerEventCount);
+    }
     if ((window_->GetType() == WindowType::WINDOW_TYPE_DIALOG) &&
         (pointerEvent->GetAgentWindowId() != pointerEvent->GetTargetWindowId())) {
         if (pointerEvent->GetPointerAction() == MMI::PointerEvent::POINTER_ACTION_DOWN ||
@@ -76,14 +101,168 @@ void WindowInputChannel::HandlePointerEvent(std::shared_ptr<MMI::PointerEvent>&
         pointerEvent->MarkProcessed();
         return;
     }
+    if (pointerEvent->GetPointerAction() == MMI::PointerEvent::POINTER_ACTION_MOVE) {
+        bool isFirstMove = false;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            AppendPointerHistory(pointerEvent);
+            pendingMoveEvents_.push_back(pointerEvent);
+            isFirstMove = (pendingMoveEvents_.size() == 1);
+        }
+        if (isFirstMove) {
+            RequestMoveEventVsync();
+        }
+        return;
+    }
+    // down, up and cancel are never delayed, but must not overtake the moves batched before them
+    std::shared_ptr<MMI::PointerEvent> pendingMoveEvent = TakePendingMoveEvent();
+    if (pendingMoveEvent != nullptr) {
+        window_->ConsumePointerEvent(pendingMoveEvent);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (pointerEvent->GetPointerAction() == MMI::PointerEvent::POINTER_ACTION_DOWN ||
+            pointerEvent->GetPointerAction() == MMI::PointerEvent::POINTER_ACTION_BUTTON_DOWN) {
+            pointerHistory_.clear();
+        }
+        AppendPointerHistory(pointerEvent);
+    }
     window_->ConsumePointerEvent(pointerEvent);
 }
 
+void WindowInputChannel::AppendPointerHistory(const std::shared_ptr<MMI::PointerEvent>& pointerEvent)
+{
+    MMI::PointerEvent::PointerItem pointerItem;
+    int32_t pointerId = pointerEvent->GetPointerId();
+    if (!pointerEvent->GetPointerItem(pointerId, pointerItem)) {
+        return;
+    }
+    if (!pointerHistory_.empty() && pointerHistory_.back().pointerId_ != pointerId) {
+        pointerHistory_.clear();
+    }
+    PointerSample sample;
+    sample.actionTime_ = pointerEvent->GetActionTime();
+    sample.pointerId_ = pointerId;
+    sample.displayX_ = pointerItem.GetDisplayX();
+    sample.displayY_ = pointerItem.GetDisplayY();
+    sample.windowX_ = pointerItem.GetWindowX();
+    sample.windowY_ = pointerItem.GetWindowY();
+    pointerHistory_.push_back(sample);
+    if (pointerHistory_.size() > POINTER_HISTORY_NUM) {
+        pointerHistory_.pop_front();
+    }
+}
+
+std::shared_ptr<MMI::PointerEvent> WindowInputChannel::TakePendingMoveEvent()
+{
+    std::vector<std::shared_ptr<MMI::PointerEvent>> pendingMoveEvents;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pendingMoveEvents.swap(pendingMoveEvents_);
+    }
+    if (pendingMoveEvents.empty()) {
+        return nullptr;
+    }
+    // input waits for every event to be marked processed, including the ones coalesced away
+    for (size_t i = 0; i + 1 < pendingMoveEvents.size(); i++) {
+        pendingMoveEvents[i]->MarkProcessed();
+    }
+    coalescedEventCount_.fetch_add(pendingMoveEvents.size() - 1, std::memory_order_relaxed);
+    return pendingMoveEvents.back();
+}
+
+void WindowInputChannel::RequestMoveEventVsync()
+{
+    if (moveEventVsyncCallback_ == nullptr) {
+        wptr<WindowInputChannel> weakThis(this);
+        moveEventVsyncCallback_ = std::make_shared<VsyncCallback>();
+        moveEventVsyncCallback_->onCallback = [weakThis](int64_t timestamp) {
+            auto inputChannel = weakThis.promote();
+            if (inputChannel != nullptr) {
+                inputChannel->OnVsync(timestamp);
+            }
+        };
+    }
+    VsyncStation::GetInstance().RequestVsync(moveEventVsyncCallback_);
+}
+
+void WindowInputChannel::OnVsync(int64_t timestamp)
+{
+    std::shared_ptr<MMI::PointerEvent> pointerEvent = TakePendingMoveEvent();
+    if (pointerEvent == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!isAvailable_) {
+            pointerEvent->MarkProcessed();
+            return;
+        }
+        if (ResamplePointerEvent(pointerEvent, timestamp / NS_PER_US - RESAMPLE_LATENCY_US)) {
+            resampledEventCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    window_->ConsumePointerEvent(pointerEvent);
+}
+
+bool WindowInputChannel::ResamplePointerEvent(const std::shared_ptr<MMI::PointerEvent>& pointerEvent,
+    int64_t sampleTime)
+{
+    // multi-finger gestures are delivered as received, the fingers are not sampled at the same time
+    if (pointerEvent->GetPointerIds().size() != 1 || pointerHistory_.size() < 2) { // 2: need two samples
+        return false;
+    }
+    const PointerSample& latest = pointerHistory_.back();
+    if (latest.actionTime_ != pointerEvent->GetActionTime() ||
+        std::abs(sampleTime - latest.actionTime_) > RESAMPLE_MAX_DELTA_US) {
+        return false;
+    }
+    auto after = pointerHistory_.rbegin();
+    auto before = std::next(after);
+    if (sampleTime < latest.actionTime_) {
+        // interpolate between the two samples around the sample time
+        while (before != pointerHistory_.rend() && before->actionTime_ > sampleTime) {
+            after = before++;
+        }
+        if (before == pointerHistory_.rend()) {
+            return false;
+        }
+    } else {
+        // extrapolate from the last two samples, predicting no further than half their distance
+        int64_t lastDelta = latest.actionTime_ - before->actionTime_;
+        sampleTime = std::min(sampleTime, latest.actionTime_ + std::min(lastDelta / 2, RESAMPLE_MAX_PREDICTION_US));
+    }
+    int64_t delta = after->actionTime_ - before->actionTime_;
+    if (delta < RESAMPLE_MIN_DELTA_US) {
+        return false;
+    }
+    double alpha = static_cast<double>(sampleTime - before->actionTime_) / delta;
+    MMI::PointerEvent::PointerItem pointerItem;
+    if (!pointerEvent->GetPointerItem(latest.pointerId_, pointerItem)) {
+        return false;
+    }
+    pointerItem.SetDisplayX(Lerp(before->displayX_, after->displayX_, alpha));
+    pointerItem.SetDisplayY(Lerp(before->displayY_, after->displayY_, alpha));
+    pointerItem.SetWindowX(Lerp(before->windowX_, after->windowX_, alpha));
+    pointerItem.SetWindowY(Lerp(before->windowY_, after->windowY_, alpha));
+    pointerEvent->UpdatePointerItem(latest.pointerId_, pointerItem);
+    pointerEvent->SetActionTime(sampleTime);
+    return true;
+}
+
 void WindowInputChannel::Destroy()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    WLOGFI("Destroy WindowInputChannel, windowId:%{public}u", window_->GetWindowId());
-    isAvailable_ = false;
+    std::vector<std::shared_ptr<MMI::PointerEvent>> pendingMoveEvents;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        WLOGFI("Destroy WindowInputChannel, windowId:%{public}u", window_->GetWindowId());
+        isAvailable_ = false;
+        pendingMoveEvents.swap(pendingMoveEvents_);
+        pointerHistory_.clear();
+    }
+    for (auto& pointerEvent : pendingMoveEvents) {
+        pointerEvent->MarkProcessed();
+    }
 }
 
 bool WindowInputChannel::IsKeyboardEvent(const std::shared_ptr<MMI::KeyEvent>& keyEvent) const
@@ -91,8 +270,39 @@ bool WindowInputChannel::IsKeyboardEvent(const std::shared_ptr<MMI::KeyEvent>& k
     int32_t keyCode = keyEvent->GetKeyCode();
     bool isKeyFN = (keyCode == MMI::KeyEvent::KEYCODE_FN);
     bool isKeyboard = (keyCode >= MMI::KeyEvent::KEYCODE_0 && keyCode <= MMI::KeyEvent::KEYCODE_NUMPAD_RIGHT_PAREN);
-    WLOGFI("isKeyFN: %{public}d, isKeyboard: %{public}d", isKeyFN, isKeyboard);
     return (isKeyFN || isKeyboard);
 }
+
+void WindowInputChannel::RecordInputEvent(InputEventKind kind, int64_t actionTime, int32_t action, int32_t code)
+{
+    auto& record = inputRecords_[inputRecordCount_.fetch_add(1, std::memory_order_relaxed) % INPUT_RECORD_NUM];
+    record.actionTime_.store(actionTime, std::memory_order_relaxed);
+    record.kind_.store(static_cast<int32_t>(kind), std::memory_order_relaxed);
+    record.action_.store(action, std::memory_order_relaxed);
+    record.code_.store(code, std::memory_order_relaxed);
+}
+
+void WindowInputChannel::Dump(std::vector<std::string>& info) const
+{
+    std::ostringstream oss;
+    oss << "WindowInputChannel windowId: " << window_->GetWindowId()
+        << ", pointer events: " << pointerEventCount_.load(std::memory_order_relaxed)
+        << ", key events: " << keyEventCount_.load(std::memory_order_relaxed)
+        << ", coalesced moves: " << coalescedEventCount_.load(std::memory_order_relaxed)
+        << ", resampled moves: " << resampledEventCount_.load(std::memory_order_relaxed);
+    info.push_back(oss.str());
+    // the most recent events, oldest first
+    uint64_t recordCount = inputRecordCount_.load(std::memory_order_relaxed);
+    uint64_t first = (recordCount > INPUT_RECORD_NUM) ? recordCount - INPUT_RECORD_NUM : 0;
+    for (uint64_t i = first; i < recordCount; i++) {
+        const auto& record = inputRecords_[i % INPUT_RECORD_NUM];
+        bool isKey = record.kind_.load(std::memory_order_relaxed) == static_cast<int32_t>(InputEventKind::KEY);
+        std::ostringstream line;
+        line << "  [" << record.actionTime_.load(std::memory_order_relaxed) << "] "
+            << (isKey ? "key action: " : "pointer action: ") << record.action_.load(std::memory_order_relaxed)
+            << (isKey ? ", keyCode: " : ", pointerId: ") << record.code_.load(std::memory_order_relaxed);
+        info.push_back(line.str());
+    }
+}
 }
 }
\ No newline at end of file
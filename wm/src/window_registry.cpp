@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "window_registry.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "window_helper.h"
+#include "window_impl.h"
+#include "window_manager_hilog.h"
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WindowRegistry"};
+}
+WM_IMPLEMENT_SINGLE_INSTANCE(WindowRegistry)
+
+bool WindowRegistry::AddWindow(const sptr<WindowImpl>& window)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!nameMap_.emplace(window->GetWindowName(), window).second) {
+        WLOGFE("WindowName(%{public}s) already exists.", window->GetWindowName().c_str());
+        return false;
+    }
+    idMap_[window->GetWindowId()] = window;
+    if (WindowHelper::IsMainWindow(window->GetType())) {
+        mainWindowIds_[window->GetContext().get()].push_back(window->GetWindowId());
+    }
+    return true;
+}
+
+void WindowRegistry::RemoveWindow(const sptr<WindowImpl>& window)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto iter = nameMap_.find(window->GetWindowName());
+    if (iter == nameMap_.end() || iter->second.GetRefPtr() != window.GetRefPtr()) {
+        return;
+    }
+    nameMap_.erase(iter);
+    idMap_.erase(window->GetWindowId());
+    auto mainIter = mainWindowIds_.find(window->GetContext().get());
+    if (mainIter != mainWindowIds_.end()) {
+        auto& windowIds = mainIter->second;
+        windowIds.erase(std::remove(windowIds.begin(), windowIds.end(), window->GetWindowId()), windowIds.end());
+        if (windowIds.empty()) {
+            mainWindowIds_.erase(mainIter);
+        }
+    }
+}
+
+sptr<WindowImpl> WindowRegistry::FindWindow(const std::string& name) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = nameMap_.find(name);
+    return (iter == nameMap_.end()) ? nullptr : iter->second;
+}
+
+sptr<WindowImpl> WindowRegistry::FindWindow(uint32_t windowId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = idMap_.find(windowId);
+    return (iter == idMap_.end()) ? nullptr : iter->second;
+}
+
+sptr<WindowImpl> WindowRegistry::FindMainWindow(const AbilityRuntime::Context* context) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = mainWindowIds_.find(context);
+    if (iter == mainWindowIds_.end() || iter->second.empty()) {
+        return nullptr;
+    }
+    auto windowIter = idMap_.find(iter->second.front());
+    return (windowIter == idMap_.end()) ? nullptr : windowIter->second;
+}
+
+std::vector<sptr<WindowImpl>> WindowRegistry::GetAllWindows() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<sptr<WindowImpl>> windows;
+    windows.reserve(idMap_.size());
+    for (const auto& pair : idMap_) {
+        windows.push_back(pair.second);
+    }
+    return windows;
+}
+
+bool WindowRegistry::IsEmpty() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return nameMap_.empty();
+}
+
+WindowRegistry::RelationIndex& WindowRegistry::GetRelationIndex(WindowRelation relation)
+{
+    return relations_[static_cast<uint32_t>(relation)];
+}
+
+const WindowRegistry::RelationIndex& WindowRegistry::GetRelationIndex(WindowRelation relation) const
+{
+    return relations_[static_cast<uint32_t>(relation)];
+}
+
+void WindowRegistry::AddRelatedWindow(WindowRelation relation, uint32_t parentId, const sptr<WindowImpl>& window)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& index = GetRelationIndex(relation);
+    index.children_[parentId].push_back(window);
+    index.parentIds_[window->GetWindowId()] = parentId;
+}
+
+void WindowRegistry::RemoveRelatedWindow(WindowRelation relation, uint32_t windowId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& index = GetRelationIndex(relation);
+    auto parentIter = index.parentIds_.find(windowId);
+    if (parentIter == index.parentIds_.end()) {
+        return;
+    }
+    auto childrenIter = index.children_.find(parentIter->second);
+    index.parentIds_.erase(parentIter);
+    if (childrenIter == index.children_.end()) {
+        return;
+    }
+    auto& children = childrenIter->second;
+    auto iter = std::find_if(children.begin(), children.end(),
+        [windowId](const sptr<WindowImpl>& child) { return child->GetWindowId() == windowId; });
+    if (iter != children.end()) {
+        children.erase(iter);
+    }
+}
+
+std::vector<sptr<WindowImpl>> WindowRegistry::GetRelatedWindows(WindowRelation relation, uint32_t parentId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto& index = GetRelationIndex(relation);
+    auto iter = index.children_.find(parentId);
+    if (iter == index.children_.end()) {
+        return {};
+    }
+    return iter->second;
+}
+
+std::vector<sptr<WindowImpl>> WindowRegistry::TakeRelatedWindows(WindowRelation relation, uint32_t parentId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& index = GetRelationIndex(relation);
+    auto iter = index.children_.find(parentId);
+    if (iter == index.children_.end()) {
+        return {};
+    }
+    std::vector<sptr<WindowImpl>> children;
+    children.swap(iter->second);
+    index.children_.erase(iter);
+    for (const auto& child : children) {
+        index.parentIds_.erase(child->GetWindowId());
+    }
+    return children;
+}
+} // namespace Rosen
+} // namespace OHOS
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vsync_station_test.h"
+
+#include <chrono>
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr int64_t VSYNC_PERIOD = 8333333; // 120 Hz in nanoseconds
+    constexpr int64_t VSYNC_TIME_OUT = 700LL * 1000 * 1000; // beyond the 600 ms timeout of the station
+}
+
+void VsyncStationTest::SetUpTestCase()
+{
+}
+
+void VsyncStationTest::TearDownTestCase()
+{
+}
+
+void VsyncStationTest::SetUp()
+{
+    auto& station = VsyncStation::GetInstance();
+    receiver_ = std::make_shared<MockVSyncReceiver>();
+    station.receiver_ = receiver_;
+    station.hasInitVsyncReceiver_ = true;
+    station.DeleteRequests(station.pendingRequests_.exchange(nullptr));
+    station.callbackGroups_.clear();
+    station.handledRemoveGeneration_ = station.removeGeneration_.load();
+    station.hasRequestedVsync_ = false;
+    station.isContinuousFrame_ = false;
+    station.lastVsyncTimestamp_ = 0;
+    station.vsyncPeriod_ = 0;
+    station.timeoutCount_ = 0;
+}
+
+void VsyncStationTest::TearDown()
+{
+    auto& station = VsyncStation::GetInstance();
+    station.RemoveCallback();
+    station.receiver_ = nullptr;
+    station.hasInitVsyncReceiver_ = false;
+    receiver_ = nullptr;
+}
+
+namespace {
+/**
+ * @tc.name: DivisorGroups
+ * @tc.desc: a callback with divisor 4 fires on every 4th frame of a continuous animation, one with divisor 1
+ *           on every frame, both on the same receiver
+ * @tc.type: FUNC
+ */
+HWTEST_F(VsyncStationTest, DivisorGroups, Function | SmallTest | Level2)
+{
+    auto& station = VsyncStation::GetInstance();
+    uint32_t fullRateCount = 0;
+    uint32_t quarterRateCount = 0;
+    auto fullRateCallback = std::make_shared<VsyncCallback>();
+    auto quarterRateCallback = std::make_shared<VsyncCallback>();
+    // both keep animating, so they request the next frame from their callback
+    fullRateCallback->onCallback = [&](int64_t timestamp) {
+        fullRateCount++;
+        station.RequestVsync(fullRateCallback);
+    };
+    quarterRateCallback->onCallback = [&](int64_t timestamp) {
+        quarterRateCount++;
+        station.RequestVsync(quarterRateCallback, 4); // 4: 30 Hz on a 120 Hz display
+    };
+    station.RequestVsync(fullRateCallback);
+    station.RequestVsync(quarterRateCallback, 4); // 4: 30 Hz on a 120 Hz display
+    ASSERT_EQ(1u, receiver_->requestCount_);
+
+    constexpr int64_t frameNum = 9;
+    for (int64_t frame = 1; frame <= frameNum; frame++) {
+        station.VsyncCallbackInner(frame * VSYNC_PERIOD);
+    }
+    ASSERT_EQ(9u, fullRateCount);
+    // frames 1, 5 and 9
+    ASSERT_EQ(3u, quarterRateCount);
+    // one receiver request per frame, no matter how many callbacks asked for it
+    ASSERT_EQ(1u + frameNum, receiver_->requestCount_);
+}
+
+/**
+ * @tc.name: SameCallbackFiresOnce
+ * @tc.desc: a callback requested several times before its frame fires once
+ * @tc.type: FUNC
+ */
+HWTEST_F(VsyncStationTest, SameCallbackFiresOnce, Function | SmallTest | Level2)
+{
+    auto& station = VsyncStation::GetInstance();
+    uint32_t count = 0;
+    auto callback = std::make_shared<VsyncCallback>();
+    callback->onCallback = [&count](int64_t timestamp) { count++; };
+    station.RequestVsync(callback);
+    station.RequestVsync(callback);
+    station.VsyncCallbackInner(VSYNC_PERIOD);
+    ASSERT_EQ(1u, count);
+    // nothing is pending, so no further frame is requested
+    ASSERT_EQ(1u, receiver_->requestCount_);
+}
+
+/**
+ * @tc.name: RemoveCallback
+ * @tc.desc: pending and grouped callbacks are dropped by RemoveCallback, later requests fire again
+ * @tc.type: FUNC
+ */
+HWTEST_F(VsyncStationTest, RemoveCallback, Function | SmallTest | Level2)
+{
+    auto& station = VsyncStation::GetInstance();
+    uint32_t count = 0;
+    uint32_t quarterRateCount = 0;
+    auto callback = std::make_shared<VsyncCallback>();
+    callback->onCallback = [&count](int64_t timestamp) { count++; };
+    auto quarterRateCallback = std::make_shared<VsyncCallback>();
+    quarterRateCallback->onCallback = [&](int64_t timestamp) {
+        quarterRateCount++;
+        station.RequestVsync(quarterRateCallback, 4); // 4: 30 Hz on a 120 Hz display
+    };
+
+    // the quarter rate callback fires on the first frame and then waits in its group for the fifth
+    station.RequestVsync(quarterRateCallback, 4); // 4: 30 Hz on a 120 Hz display
+    station.VsyncCallbackInner(VSYNC_PERIOD);
+    station.VsyncCallbackInner(VSYNC_PERIOD * 2); // 2: second frame
+    ASSERT_EQ(1u, quarterRateCount);
+
+    station.RequestVsync(callback);
+    station.RemoveCallback();
+    station.VsyncCallbackInner(VSYNC_PERIOD * 5); // 5: the quarter rate group would be due again
+    ASSERT_EQ(0u, count);
+    ASSERT_EQ(1u, quarterRateCount);
+
+    station.RequestVsync(callback);
+    station.VsyncCallbackInner(VSYNC_PERIOD * 6); // 6: next frame
+    ASSERT_EQ(1u, count);
+}
+
+/**
+ * @tc.name: RequestAgainAfterTimeout
+ * @tc.desc: a vsync request left unanswered is issued again by the next request once the timeout passed
+ * @tc.type: FUNC
+ */
+HWTEST_F(VsyncStationTest, RequestAgainAfterTimeout, Function | SmallTest | Level2)
+{
+    auto& station = VsyncStation::GetInstance();
+    auto callback = std::make_shared<VsyncCallback>();
+    callback->onCallback = [](int64_t timestamp) {};
+    station.RequestVsync(callback);
+    ASSERT_EQ(1u, receiver_->requestCount_);
+    // still within the timeout, the pending request is reused
+    station.RequestVsync(callback);
+    ASSERT_EQ(1u, receiver_->requestCount_);
+    ASSERT_EQ(0u, station.timeoutCount_.load());
+
+    station.lastRequestTime_ = station.lastRequestTime_.load() - VSYNC_TIME_OUT;
+    station.RequestVsync(callback);
+    ASSERT_EQ(2u, receiver_->requestCount_);
+    ASSERT_EQ(1u, station.timeoutCount_.load());
+
+    std::vector<std::string> info;
+    station.Dump(info);
+    ASSERT_EQ(1u, info.size());
+    ASSERT_NE(std::string::npos, info[0].find("timeouts: 1"));
+}
+}
+} // namespace Rosen
+} // namespace OHOS
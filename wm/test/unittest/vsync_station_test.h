@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_WM_TEST_UT_VSYNC_STATION_TEST_H
+#define FRAMEWORKS_WM_TEST_UT_VSYNC_STATION_TEST_H
+
+#include <gtest/gtest.h>
+#include <vsync_receiver.h>
+#include "vsync_station.h"
+
+namespace OHOS {
+namespace Rosen {
+// counts the requests instead of asking the render service, frames are delivered by the test
+class MockVSyncReceiver : public VSyncReceiver {
+public:
+    MockVSyncReceiver() : VSyncReceiver(nullptr) {}
+    VsyncError Init() override
+    {
+        return VSYNC_ERROR_OK;
+    }
+    VsyncError RequestNextVSync(FrameCallback callback) override
+    {
+        requestCount_++;
+        return VSYNC_ERROR_OK;
+    }
+    uint32_t requestCount_ = 0;
+};
+
+class VsyncStationTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+    std::shared_ptr<MockVSyncReceiver> receiver_;
+};
+} // namespace ROSEN
+} // namespace OHOS
+
+#endif // FRAMEWORKS_WM_TEST_UT_VSYNC_STATION_TEST_H
@@ -252,6 +252,33 @@ HWTEST_F(WindowImplTest, FindWindow05, Function | SmallTest | Level2)
     ASSERT_EQ(nullptr, WindowImpl::Find("FindWindow05"));
 }
 
+/**
+ * @tc.name: GetSubWindow01
+ * @tc.desc: Sub windows are found by parent id and destroyed with the parent
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowImplTest, GetSubWindow01, Function | SmallTest | Level2)
+{
+    std::unique_ptr<Mocker> m = std::make_unique<Mocker>();
+    sptr<WindowOption> option = new WindowOption();
+    option->SetWindowName("GetSubWindow01");
+    sptr<WindowImpl> window = new WindowImpl(option);
+    EXPECT_CALL(m->Mock(), CreateWindow(_, _, _, _, _)).Times(1).WillOnce(Return(WMError::WM_OK));
+    ASSERT_EQ(WMError::WM_OK, window->Create(""));
+
+    option->SetWindowName("GetSubWindow01_sub");
+    option->SetWindowType(WindowType::WINDOW_TYPE_APP_SUB_WINDOW);
+    sptr<WindowImpl> subWindow = new WindowImpl(option);
+    EXPECT_CALL(m->Mock(), CreateWindow(_, _, _, _, _)).Times(1).WillOnce(Return(WMError::WM_OK));
+    ASSERT_EQ(WMError::WM_OK, subWindow->Create("GetSubWindow01"));
+    ASSERT_EQ(1u, WindowImpl::GetSubWindow(window->GetWindowId()).size());
+
+    EXPECT_CALL(m->Mock(), DestroyWindow(_)).Times(1).WillOnce(Return(WMError::WM_OK));
+    ASSERT_EQ(WMError::WM_OK, window->Destroy());
+    ASSERT_EQ(nullptr, WindowImpl::Find("GetSubWindow01_sub"));
+    ASSERT_TRUE(WindowImpl::GetSubWindow(window->GetWindowId()).empty());
+}
+
 /**
  * @tc.name: FindTopWindow01
  * @tc.desc: Find one top window
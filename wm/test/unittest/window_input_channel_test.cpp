@@ -46,6 +46,42 @@ void WindowInputChannelTest::TearDown()
 }
 
 namespace {
+constexpr int64_t SAMPLE_INTERVAL = 8000; // 8000: 8ms between samples
+constexpr int32_t SAMPLE_STEP = 80; // 80: pixels moved between samples
+
+std::shared_ptr<MMI::PointerEvent> CreatePointerEvent(int32_t action, int64_t actionTime, int32_t x)
+{
+    auto pointerEvent = MMI::PointerEvent::Create();
+    MMI::PointerEvent::PointerItem pointerItem;
+    pointerItem.SetPointerId(0);
+    pointerItem.SetDisplayX(x);
+    pointerItem.SetWindowX(x);
+    pointerEvent->AddPointerItem(pointerItem);
+    pointerEvent->SetPointerId(0);
+    pointerEvent->SetPointerAction(action);
+    pointerEvent->SetActionTime(actionTime);
+    return pointerEvent;
+}
+
+// a down followed by moveNum moves of SAMPLE_STEP pixels every SAMPLE_INTERVAL
+void HandleMoves(const sptr<WindowInputChannel>& inputChannel, int32_t moveNum)
+{
+    auto pointerEvent = CreatePointerEvent(MMI::PointerEvent::POINTER_ACTION_DOWN, 0, 0);
+    inputChannel->HandlePointerEvent(pointerEvent);
+    for (int32_t i = 1; i <= moveNum; i++) {
+        pointerEvent = CreatePointerEvent(MMI::PointerEvent::POINTER_ACTION_MOVE, i * SAMPLE_INTERVAL,
+            i * SAMPLE_STEP);
+        inputChannel->HandlePointerEvent(pointerEvent);
+    }
+}
+
+int32_t GetDisplayX(const std::shared_ptr<MMI::PointerEvent>& pointerEvent)
+{
+    MMI::PointerEvent::PointerItem pointerItem;
+    pointerEvent->GetPointerItem(0, pointerItem);
+    return pointerItem.GetDisplayX();
+}
+
 /**
  * @tc.name: HandlePointerEvent
  * @tc.desc: consume pointer event when receive callback from input
@@ -71,6 +107,116 @@ HWTEST_F(WindowInputChannelTest, HandleKeyEvent, Function | SmallTest | Level2)
     window_->ConsumeKeyEvent(keyEvent);
     inputChannel->HandleKeyEvent(keyEvent);
 }
+
+/**
+ * @tc.name: DumpRecentEvents
+ * @tc.desc: the dump holds the event counters and at most the last 64 events
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowInputChannelTest, DumpRecentEvents, Function | SmallTest | Level2)
+{
+    sptr<WindowInputChannel> inputChannel = new WindowInputChannel(window_);
+    auto keyEvent = MMI::KeyEvent::Create();
+    inputChannel->HandleKeyEvent(keyEvent);
+    std::vector<std::string> info;
+    inputChannel->Dump(info);
+    ASSERT_EQ(2u, info.size()); // 2: counters and one key event
+    ASSERT_NE(std::string::npos, info[0].find("key events: 1"));
+
+    constexpr uint32_t eventNum = 100;
+    for (uint32_t i = 0; i < eventNum; i++) {
+        auto pointerEvent = MMI::PointerEvent::Create();
+        inputChannel->HandlePointerEvent(pointerEvent);
+    }
+    info.clear();
+    inputChannel->Dump(info);
+    ASSERT_EQ(65u, info.size()); // 65: counters and the 64 most recent events
+    ASSERT_NE(std::string::npos, info[0].find("pointer events: 100"));
+    ASSERT_NE(std::string::npos, info.back().find("pointer action"));
+}
+
+/**
+ * @tc.name: CoalesceMoveEvents
+ * @tc.desc: moves wait for vsync and are coalesced, down and up are delivered at once behind them
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowInputChannelTest, CoalesceMoveEvents, Function | SmallTest | Level2)
+{
+    sptr<WindowInputChannel> inputChannel = new WindowInputChannel(window_);
+    constexpr int32_t moveNum = 3;
+    HandleMoves(inputChannel, moveNum);
+    ASSERT_EQ(static_cast<size_t>(moveNum), inputChannel->pendingMoveEvents_.size());
+    auto pointerEvent = CreatePointerEvent(MMI::PointerEvent::POINTER_ACTION_UP, (moveNum + 1) * SAMPLE_INTERVAL,
+        moveNum * SAMPLE_STEP);
+    inputChannel->HandlePointerEvent(pointerEvent);
+
+    ASSERT_TRUE(inputChannel->pendingMoveEvents_.empty());
+    ASSERT_EQ(static_cast<size_t>(moveNum + 2), inputChannel->pointerHistory_.size()); // 2: down and up
+    ASSERT_EQ(moveNum * SAMPLE_STEP, inputChannel->pointerHistory_[moveNum].displayX_);
+    std::vector<std::string> info;
+    inputChannel->Dump(info);
+    ASSERT_NE(std::string::npos, info[0].find("coalesced moves: 2"));
+}
+
+/**
+ * @tc.name: InterpolateMoveEvent
+ * @tc.desc: a sample time between two samples is interpolated between them
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowInputChannelTest, InterpolateMoveEvent, Function | SmallTest | Level2)
+{
+    sptr<WindowInputChannel> inputChannel = new WindowInputChannel(window_);
+    HandleMoves(inputChannel, 2); // 2: moves at 8ms and 16ms
+    auto pointerEvent = inputChannel->pendingMoveEvents_.back();
+    constexpr int64_t sampleTime = SAMPLE_INTERVAL + SAMPLE_INTERVAL / 2;
+    ASSERT_TRUE(inputChannel->ResamplePointerEvent(pointerEvent, sampleTime));
+    ASSERT_EQ(SAMPLE_STEP + SAMPLE_STEP / 2, GetDisplayX(pointerEvent));
+    ASSERT_EQ(sampleTime, pointerEvent->GetActionTime());
+}
+
+/**
+ * @tc.name: ExtrapolateMoveEvent
+ * @tc.desc: a sample time after the last sample is extrapolated, by at most half the last interval
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowInputChannelTest, ExtrapolateMoveEvent, Function | SmallTest | Level2)
+{
+    sptr<WindowInputChannel> inputChannel = new WindowInputChannel(window_);
+    HandleMoves(inputChannel, 2); // 2: moves at 8ms and 16ms
+    auto pointerEvent = inputChannel->pendingMoveEvents_.back();
+    constexpr int64_t lastTime = SAMPLE_INTERVAL * 2;
+    ASSERT_TRUE(inputChannel->ResamplePointerEvent(pointerEvent, lastTime + SAMPLE_INTERVAL / 4));
+    ASSERT_EQ(SAMPLE_STEP * 2 + SAMPLE_STEP / 4, GetDisplayX(pointerEvent));
+
+    // the prediction is clamped to half the last interval
+    pointerEvent = CreatePointerEvent(MMI::PointerEvent::POINTER_ACTION_MOVE, lastTime, SAMPLE_STEP * 2);
+    ASSERT_TRUE(inputChannel->ResamplePointerEvent(pointerEvent, lastTime + SAMPLE_INTERVAL * 2));
+    ASSERT_EQ(SAMPLE_STEP * 2 + SAMPLE_STEP / 2, GetDisplayX(pointerEvent));
+    ASSERT_EQ(lastTime + SAMPLE_INTERVAL / 2, pointerEvent->GetActionTime());
+
+    // too far from the last sample, the event is delivered as received
+    pointerEvent = CreatePointerEvent(MMI::PointerEvent::POINTER_ACTION_MOVE, lastTime, SAMPLE_STEP * 2);
+    ASSERT_FALSE(inputChannel->ResamplePointerEvent(pointerEvent, lastTime + SAMPLE_INTERVAL * 4));
+    ASSERT_EQ(SAMPLE_STEP * 2, GetDisplayX(pointerEvent));
+}
+
+/**
+ * @tc.name: ResampleOnVsync
+ * @tc.desc: the move delivered on vsync is resampled to 5ms before the frame time
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowInputChannelTest, ResampleOnVsync, Function | SmallTest | Level2)
+{
+    sptr<WindowInputChannel> inputChannel = new WindowInputChannel(window_);
+    HandleMoves(inputChannel, 2); // 2: moves at 8ms and 16ms
+    constexpr int64_t frameTimeUs = 17000; // 17000: 5ms latency puts the sample time at 12ms
+    inputChannel->OnVsync(frameTimeUs * 1000); // 1000: vsync timestamps are in nanoseconds
+    ASSERT_TRUE(inputChannel->pendingMoveEvents_.empty());
+    std::vector<std::string> info;
+    inputChannel->Dump(info);
+    ASSERT_NE(std::string::npos, info[0].find("coalesced moves: 1"));
+    ASSERT_NE(std::string::npos, info[0].find("resampled moves: 1"));
+}
 }
 } // namespace Rosen
 } // namespace OHOS
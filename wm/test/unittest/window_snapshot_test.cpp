@@ -14,6 +14,11 @@
  */
 
 #include "window_snapshot_test.h"
+
+#include <chrono>
+#include <thread>
+#include <ipc_object_stub.h>
+#include <ui/rs_surface_node.h>
 #include "wm_common.h"
 
 using namespace testing;
@@ -38,6 +43,26 @@ void WindowSnapshotTest::TearDown()
 }
 
 namespace {
+constexpr int64_t TIMEOUT_MS = 50;
+constexpr std::chrono::milliseconds WAIT_TIMEOUT { 200 };
+
+// keeps the lookup tasks instead of running them on a wms handler
+struct PendingTasks {
+    bool Post(const std::function<void()>& task)
+    {
+        tasks_.push_back(task);
+        return true;
+    }
+    void RunAll()
+    {
+        for (auto& task : tasks_) {
+            task();
+        }
+        tasks_.clear();
+    }
+    std::vector<std::function<void()>> tasks_;
+};
+
 /**
  * @tc.name: GetSnapshot
  * @tc.desc: GetSnapshot when parameter abilityToken is nullptr
@@ -49,6 +74,152 @@ HWTEST_F(WindowSnapshotTest, GetSnapshot, Function | SmallTest | Level3)
     AAFwk::Snapshot snapshot_;
     ASSERT_EQ(static_cast<int32_t>(WMError::WM_ERROR_NULLPTR), snapshotController_->GetSnapshot(nullptr, snapshot_));
 }
+
+/**
+ * @tc.name: GetSnapshotAsync
+ * @tc.desc: GetSnapshotAsync issues no request and never calls back when abilityToken is nullptr
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowSnapshotTest, GetSnapshotAsync, Function | SmallTest | Level3)
+{
+    sptr<SnapshotController> snapshotController_ = new SnapshotController();
+    bool isCalledBack = false;
+    auto request = snapshotController_->GetSnapshotAsync(nullptr,
+        [&isCalledBack](WMError, const std::shared_ptr<Media::PixelMap>&) { isCalledBack = true; }, 100); // 100ms
+    ASSERT_EQ(nullptr, request);
+    ASSERT_FALSE(isCalledBack);
+}
+
+/**
+ * @tc.name: SnapshotRequest
+ * @tc.desc: a request completes once, and a cancelled request never calls back
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowSnapshotTest, SnapshotRequest, Function | SmallTest | Level3)
+{
+    int32_t callbackTimes = 0;
+    auto callback = [&callbackTimes](WMError, const std::shared_ptr<Media::PixelMap>&) { callbackTimes++; };
+    SnapshotRequest request(callback);
+    ASSERT_TRUE(request.Complete(WMError::WM_ERROR_NULLPTR, nullptr));
+    ASSERT_FALSE(request.Complete(WMError::WM_OK, nullptr));
+    ASSERT_EQ(1, callbackTimes);
+
+    SnapshotRequest cancelledRequest(callback);
+    cancelledRequest.Cancel();
+    ASSERT_TRUE(cancelledRequest.IsFinished());
+    ASSERT_FALSE(cancelledRequest.Complete(WMError::WM_OK, nullptr));
+    ASSERT_EQ(1, callbackTimes);
+}
+
+/**
+ * @tc.name: CompleteSharedCapture
+ * @tc.desc: an identical request joins the capture in flight, both complete with it and the capture leaves the cache
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowSnapshotTest, CompleteSharedCapture, Function | SmallTest | Level3)
+{
+    sptr<SnapshotController> snapshotController = new SnapshotController();
+    RSSurfaceNodeConfig config;
+    config.SurfaceNodeName = "CompleteSharedCapture";
+    auto surfaceNode = RSSurfaceNode::Create(config);
+    ASSERT_NE(nullptr, surfaceNode);
+    int32_t okTimes = 0;
+    auto callback = [&okTimes](WMError ret, const std::shared_ptr<Media::PixelMap>& pixelMap) {
+        if (ret == WMError::WM_OK && pixelMap != nullptr) {
+            okTimes++;
+        }
+    };
+    auto deadline = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+    auto request = std::make_shared<SnapshotRequest>(callback);
+    snapshotController->TakeSnapshot(surfaceNode, 0, request, deadline);
+    auto otherRequest = std::make_shared<SnapshotRequest>(callback);
+    snapshotController->TakeSnapshot(surfaceNode, 0, otherRequest, deadline);
+    ASSERT_EQ(1u, snapshotController->snapshotCache_.size());
+
+    auto capture = snapshotController->snapshotCache_.begin()->second.capture_;
+    capture->OnSurfaceCapture(std::make_shared<Media::PixelMap>());
+    ASSERT_EQ(2, okTimes); // 2: both requests
+    ASSERT_TRUE(request->IsFinished());
+    ASSERT_TRUE(otherRequest->IsFinished());
+    ASSERT_TRUE(snapshotController->snapshotCache_.empty());
+}
+
+/**
+ * @tc.name: GetSnapshotAsyncTimeout
+ * @tc.desc: a request whose lookup never runs times out off the wms handler and its capture is evicted
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowSnapshotTest, GetSnapshotAsyncTimeout, Function | SmallTest | Level3)
+{
+    PendingTasks pendingTasks;
+    sptr<WindowRoot> root = nullptr;
+    sptr<SnapshotController> snapshotController = new SnapshotController(root,
+        [&pendingTasks](const std::function<void()>& task) { return pendingTasks.Post(task); });
+    SnapshotController::SnapshotCacheKey key = { 0, 0.5f, 0.5f, 0 }; // 0.5f: default scale
+    bool isNewCapture = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TIMEOUT_MS);
+    snapshotController->GetOrCreateCapture(key, deadline, isNewCapture);
+    ASSERT_TRUE(isNewCapture);
+
+    std::atomic<int32_t> callbackTimes { 0 };
+    std::atomic<WMError> result { WMError::WM_OK };
+    sptr<IRemoteObject> token = new IPCObjectStub(u"GetSnapshotAsyncTimeout");
+    auto request = snapshotController->GetSnapshotAsync(token,
+        [&callbackTimes, &result](WMError ret, const std::shared_ptr<Media::PixelMap>&) {
+            result = ret;
+            callbackTimes++;
+        }, TIMEOUT_MS);
+    ASSERT_NE(nullptr, request);
+    std::this_thread::sleep_for(WAIT_TIMEOUT);
+    ASSERT_EQ(1, callbackTimes.load());
+    ASSERT_EQ(WMError::WM_ERROR_NULLPTR, result.load());
+    ASSERT_TRUE(snapshotController->snapshotCache_.empty());
+
+    // the late lookup does nothing for a finished request
+    pendingTasks.RunAll();
+    ASSERT_EQ(1, callbackTimes.load());
+}
+
+/**
+ * @tc.name: GetSnapshotAsyncCancel
+ * @tc.desc: a cancelled request never calls back, neither from its lookup nor from its timeout
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowSnapshotTest, GetSnapshotAsyncCancel, Function | SmallTest | Level3)
+{
+    PendingTasks pendingTasks;
+    sptr<WindowRoot> root = nullptr;
+    sptr<SnapshotController> snapshotController = new SnapshotController(root,
+        [&pendingTasks](const std::function<void()>& task) { return pendingTasks.Post(task); });
+    std::atomic<int32_t> callbackTimes { 0 };
+    sptr<IRemoteObject> token = new IPCObjectStub(u"GetSnapshotAsyncCancel");
+    auto request = snapshotController->GetSnapshotAsync(token,
+        [&callbackTimes](WMError, const std::shared_ptr<Media::PixelMap>&) { callbackTimes++; }, TIMEOUT_MS);
+    ASSERT_NE(nullptr, request);
+    request->Cancel();
+    pendingTasks.RunAll();
+    std::this_thread::sleep_for(WAIT_TIMEOUT);
+    ASSERT_EQ(0, callbackTimes.load());
+}
+
+/**
+ * @tc.name: GetSnapshotAsyncPostFailed
+ * @tc.desc: no request is returned and no callback runs when the lookup task cannot be posted
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowSnapshotTest, GetSnapshotAsyncPostFailed, Function | SmallTest | Level3)
+{
+    sptr<WindowRoot> root = nullptr;
+    sptr<SnapshotController> snapshotController = new SnapshotController(root,
+        [](const std::function<void()>&) { return false; });
+    std::atomic<int32_t> callbackTimes { 0 };
+    sptr<IRemoteObject> token = new IPCObjectStub(u"GetSnapshotAsyncPostFailed");
+    auto request = snapshotController->GetSnapshotAsync(token,
+        [&callbackTimes](WMError, const std::shared_ptr<Media::PixelMap>&) { callbackTimes++; }, TIMEOUT_MS);
+    ASSERT_EQ(nullptr, request);
+    std::this_thread::sleep_for(WAIT_TIMEOUT);
+    ASSERT_EQ(0, callbackTimes.load());
+}
 }
 } // namespace Rosen
 } // namespace OHOS
@@ -32,6 +32,8 @@ public:
     ~AccessibilityConnection() = default;
     void NotifyAccessibilityInfo(const sptr<WindowNode>& node, WindowUpdateType type);
     void GetAccessibilityWindowInfo(sptr<AccessibilityWindowInfo>& windowInfo) const;
+    // refreshes the entry of windowId in a list built by GetAccessibilityWindowInfo
+    void UpdateAccessibilityWindowInfo(uint32_t windowId, std::vector<sptr<WindowInfo>>& windowList) const;
 
 private:
     sptr<WindowRoot> windowRoot_;
@@ -83,14 +83,16 @@ private:
     Rect GetHotZoneRect();
 
     void HandlePointerEvent(const std::shared_ptr<MMI::PointerEvent>& pointerEvent);
-    void HandleDragEvent(int32_t posX, int32_t posY, int32_t pointId);
-    void HandleMoveEvent(int32_t posX, int32_t posY, int32_t pointId);
+    void HandleDragEvent(int32_t posX, int32_t posY, int32_t pointId, int64_t pointerTime);
+    void HandleMoveEvent(int32_t posX, int32_t posY, int32_t pointId, int64_t pointerTime);
     void OnReceiveVsync(int64_t timeStamp);
+    void DropPendingMoveEvent();
     void ResetMoveOrDragState();
 
     sptr<WindowProperty> windowProperty_;
     sptr<MoveDragProperty> moveDragProperty_;
     uint32_t activeWindowId_ = INVALID_WINDOW_ID;
+    // only touched on the input handler
     std::shared_ptr<MMI::PointerEvent> moveEvent_ = nullptr;
     std::shared_ptr<MMI::IInputEventConsumer> inputListener_ = nullptr;
     std::shared_ptr<VsyncCallback> vsyncCallback_ = std::make_shared<VsyncCallback>(VsyncCallback());
@@ -16,6 +16,8 @@
 #ifndef OHOS_INPUT_WINDOW_MONITOR_H
 #define OHOS_INPUT_WINDOW_MONITOR_H
 
+#include <functional>
+#include <unordered_map>
 #include <unordered_set>
 #include <input_manager.h>
 #include <refbase.h>
@@ -28,21 +30,41 @@ namespace OHOS {
 namespace Rosen {
 class InputWindowMonitor : public RefBase {
 public:
+    using DisplayGroupInfoSink = std::function<void(const MMI::DisplayGroupInfo&)>;
     explicit InputWindowMonitor(sptr<WindowRoot>& root) : windowRoot_(root) {}
     ~InputWindowMonitor() = default;
     void UpdateInputWindow(uint32_t windowId);
     void UpdateInputWindowByDisplayId(DisplayId displayId);
+    void FlushPendingInputWindow();
+    void RemoveDisplayInfo(DisplayId displayId);
+    // replaces the push to MMI, for running WMS without the input service, e.g. in benchmarks
+    void SetDisplayGroupInfoSink(const DisplayGroupInfoSink& sink);
 
 private:
+    struct WindowInfoCacheItem {
+        // input window info of the node itself, dialog callers are applied on top of it by every update
+        MMI::WindowInfo windowInfo;
+        uint64_t updateSeq = 0;
+    };
     sptr<WindowRoot> windowRoot_;
+    DisplayGroupInfoSink displayGroupInfoSink_;
+    // last display group info pushed to MMI, patched in place by the next update
     MMI::DisplayGroupInfo displayGroupInfo_;
+    std::map<DisplayId, MMI::DisplayInfo> displayInfoCache_;
+    std::unordered_map<uint32_t, WindowInfoCacheItem> windowInfoCache_;
+    uint64_t updateSeq_ = 0;
+    DisplayId pendingDisplayId_ = DISPLAY_ID_INVALID;
     std::unordered_set<WindowType> windowTypeSkipped_ { WindowType::WINDOW_TYPE_POINTER,
         WindowType::WINDOW_TYPE_DRAGGING_EFFECT, WindowType::WINDOW_TYPE_FREEZE_DISPLAY};
-    void TraverseWindowNodes(const std::vector<sptr<WindowNode>>& windowNodes,
+    bool UpdateInputWindowInfo(DisplayId displayId);
+    bool TraverseWindowNodes(const std::vector<sptr<WindowNode>>& windowNodes,
                              std::vector<MMI::WindowInfo>& windowsInfo);
-    void UpdateDisplayGroupInfo(const sptr<WindowNodeContainer>& windowNodeContainer,
+    const MMI::WindowInfo& GetCachedWindowInfo(const sptr<WindowNode>& windowNode, bool& isRebuilt);
+    void BuildWindowInfo(const sptr<WindowNode>& windowNode, MMI::WindowInfo& windowInfo);
+    void PruneWindowInfoCache();
+    bool UpdateDisplayGroupInfo(const sptr<WindowNodeContainer>& windowNodeContainer,
                                 MMI::DisplayGroupInfo& displayGroupInfo);
-    void UpdateDisplayInfo(const sptr<DisplayInfo>& displayInfo,
+    bool UpdateDisplayInfo(const sptr<DisplayInfo>& displayInfo,
                            std::vector<MMI::DisplayInfo>& displayInfoVector);
     MMI::Direction GetDisplayDirectionForMmi(Rotation rotation);
 };
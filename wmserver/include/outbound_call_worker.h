@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_ROSEN_OUTBOUND_CALL_WORKER_H
+#define OHOS_ROSEN_OUTBOUND_CALL_WORKER_H
+
+#include <chrono>
+#include <event_handler.h>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "wm_single_instance.h"
+
+namespace OHOS {
+namespace Rosen {
+enum class OutboundCallTarget : uint32_t {
+    BRIGHTNESS,
+    RUNNING_LOCK,
+    POWER_STATE,
+    INPUT_DISPLAY_INFO,
+    DISPLAY_ORIENTATION,
+    END,
+};
+
+/*
+ * Runs the synchronous calls WMS makes into other system services (power manager, MMI, DMS) on one
+ * worker thread, in the order they were posted, so a slow service no longer blocks the WMS handler.
+ * A call for the same target and key as a pending one replaces it: only the latest value is sent.
+ */
+class OutboundCallWorker {
+WM_DECLARE_SINGLE_INSTANCE_BASE(OutboundCallWorker)
+public:
+    void PostCall(OutboundCallTarget target, uint64_t key, std::function<void()>&& call);
+    void Dump(std::string& dumpInfo);
+
+private:
+    OutboundCallWorker() = default;
+    virtual ~OutboundCallWorker() = default;
+
+    struct PendingCall {
+        OutboundCallTarget target_;
+        uint64_t key_;
+        std::function<void()> call_;
+        std::chrono::steady_clock::time_point postTime_;
+    };
+    struct TargetStatistics {
+        uint64_t callCount_ { 0 };
+        uint64_t coalescedCount_ { 0 };
+        int64_t totalWaitTime_ { 0 };
+        int64_t maxWaitTime_ { 0 };
+        int64_t totalCallTime_ { 0 };
+        int64_t maxCallTime_ { 0 };
+    };
+    void Drain();
+
+    std::mutex mutex_;
+    std::shared_ptr<AppExecFwk::EventHandler> handler_;
+    std::list<PendingCall> pendingCalls_;
+    std::map<std::pair<OutboundCallTarget, uint64_t>, std::list<PendingCall>::iterator> pendingIndex_;
+    std::map<OutboundCallTarget, TargetStatistics> statistics_;
+    bool isDraining_ { false };
+};
+} // namespace Rosen
+} // namespace OHOS
+#endif // OHOS_ROSEN_OUTBOUND_CALL_WORKER_H
@@ -16,8 +16,12 @@
 #ifndef OHOS_ROSEN_WINDOW_CONTROLLER_H
 #define OHOS_ROSEN_WINDOW_CONTROLLER_H
 
+#include <event_handler.h>
+#include <functional>
 #include <refbase.h>
 #include <rs_iwindow_animation_controller.h>
+#include <unordered_set>
+#include <vector>
 
 #include "accessibility_connection.h"
 #include "input_window_monitor.h"
@@ -67,15 +71,25 @@ public:
     Orientation GetWindowPreferredOrientation(DisplayId displayId);
     void OnScreenshot(DisplayId displayId);
     WMError GetAccessibilityWindowInfo(sptr<AccessibilityWindowInfo>& windowInfo) const;
+    std::shared_ptr<const WindowReadModel> CreateReadModel(const ModeChangeHotZonesConfig& config);
+    // copies readModel and refreshes only the given windows, falls back to a full rebuild when needed
+    std::shared_ptr<const WindowReadModel> UpdateReadModel(const std::shared_ptr<const WindowReadModel>& readModel,
+        const std::unordered_set<uint32_t>& windowIds, const ModeChangeHotZonesConfig& config);
     WMError BindDialogTarget(uint32_t& windowId, sptr<IRemoteObject> targetToken);
     WMError InterceptInputEventToServer(uint32_t windowId);
     WMError RecoverInputEventToClient(uint32_t windowId);
     WMError NotifyWindowClientPointUp(uint32_t windowId, const std::shared_ptr<MMI::PointerEvent>& pointerEvent);
+    WMError UpdateMoveOrDragRect(const sptr<WindowProperty>& property, int64_t pointerTime);
+    void SetEventHandler(const std::shared_ptr<AppExecFwk::EventHandler>& handler);
+    // replaces the RS transaction flush of the commit stage, for running WMS without RS, e.g. in benchmarks
+    void SetRsTransactionFlusher(const std::function<void()>& flusher);
+    void CommitPendingChanges();
 
 private:
     uint32_t GenWindowId();
-    void FlushWindowInfo(uint32_t windowId);
-    void FlushWindowInfoWithDisplayId(DisplayId displayId);
+    void FlushWindowInfo(uint32_t windowId, bool isSync = false);
+    void FlushWindowInfoWithDisplayId(DisplayId displayId, bool isSync = false);
+    void RequestCommit(bool isSync);
     void UpdateWindowAnimation(const sptr<WindowNode>& node);
     void ProcessDisplayChange(DisplayId defaultDisplayId, sptr<DisplayInfo> displayInfo,
         const std::map<DisplayId, sptr<DisplayInfo>>& displayInfoMap, DisplayStateChangeType type);
@@ -93,6 +107,12 @@ private:
     void ProcessSystemBarChange(const sptr<DisplayInfo>& displayInfo);
     WMError UpdateTouchHotAreas(const sptr<WindowNode>& node, const std::vector<Rect>& rects);
     WMError UpdateTransform(uint32_t windowId);
+    WMError UpdatePropertyByAction(const sptr<WindowNode>& node, const sptr<WindowProperty>& property,
+        PropertyChangeAction action);
+    WMError UpdateWindowNodeLayout(uint32_t windowId, WindowUpdateReason reason);
+    void UpdateCallingWindowRestoringRect(const sptr<WindowNode>& node, WindowSizeChangeReason reason);
+    void FinishMoveOrDrag(uint32_t windowId);
+    void RecordMoveDragLatencyEvent(int64_t latency);
     void NotifyTouchOutside(const sptr<WindowNode>& node);
     uint32_t GetEmbedNodeId(const std::vector<sptr<WindowNode>>& windowNodes, const sptr<WindowNode>& node);
     void NotifyWindowPropertyChanged(const sptr<WindowNode>& node);
@@ -110,6 +130,20 @@ private:
     bool isScreenLocked_ { false };
     Rect callingWindowRestoringRect_ { 0, 0, 0, 0 };
     uint32_t callingWindowId_ = 0u;
+    // RS transaction and input updates requested during one handler turn are committed together
+    std::shared_ptr<AppExecFwk::EventHandler> handler_;
+    bool isCommitTaskPosted_ = false;
+    std::function<void()> rsTransactionFlusher_;
+    // while UpdateProperty applies its actions, relayouts of that window are merged into a single one
+    uint32_t deferredLayoutWindowId_ = INVALID_WINDOW_ID;
+    bool hasDeferredLayout_ = false;
+    WindowUpdateReason deferredLayoutReason_ = WindowUpdateReason::UPDATE_ALL;
+    // window moved or dragged by the server, moving only updates its bounds until the full layout at the end
+    uint32_t moveDragWindowId_ = INVALID_WINDOW_ID;
+    bool isMoveLayoutDeferred_ = false;
+    // pointer timestamps of the move or drag frames waiting for the next commit
+    std::vector<int64_t> pendingMoveDragPointerTimes_;
+    MoveDragLatencyConfig moveDragLatencyConfig_ = { 0, 0, 0, 0, 0, 0 };
 };
 } // Rosen
 } // OHOS
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_ROSEN_WINDOW_HIT_TEST_INDEX_H
+#define OHOS_ROSEN_WINDOW_HIT_TEST_INDEX_H
+
+#include <functional>
+#include <refbase.h>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "window_node.h"
+#include "wm_common.h"
+#include "wm_math.h"
+
+namespace OHOS {
+namespace Rosen {
+using HitTestFilterFunc = std::function<bool(const sptr<WindowNode>&)>; // return true if node can be hit
+/*
+ * Uniform grid over the display group coordinates of one window node container.
+ * Each window is bucketed by the bounding rect of its (possibly transformed) window rect,
+ * so a point query only checks the windows sharing its cell instead of the whole window tree.
+ */
+class WindowHitTestIndex : public RefBase {
+public:
+    WindowHitTestIndex() = default;
+    ~WindowHitTestIndex() = default;
+
+    void AddWindowNode(const sptr<WindowNode>& node);
+    void RemoveWindowNode(const sptr<WindowNode>& node);
+    // only refreshes windows already in the index, layout may run for windows outside the window tree
+    void UpdateWindowNode(const sptr<WindowNode>& node);
+    // return the window with the highest z-order whose rect contains the point and which passes the filter
+    sptr<WindowNode> HitTest(const PointInfo& point, const HitTestFilterFunc& filter) const;
+
+private:
+    struct HitTestEntry {
+        sptr<WindowNode> node_;
+        Rect rect_ { 0, 0, 0, 0 };
+        Rect bounds_ { 0, 0, 0, 0 };
+        Transform transform_;
+        bool isTransformed_ { false };
+        TransformHelper::Matrix4 invertMat_ = TransformHelper::Matrix4::Identity;
+        TransformHelper::Plane plane_;
+        bool isOversized_ { false };
+        int32_t cellLeft_ { 0 };
+        int32_t cellTop_ { 0 };
+        int32_t cellRight_ { -1 };
+        int32_t cellBottom_ { -1 };
+    };
+    void RefreshEntry(const sptr<WindowNode>& node, HitTestEntry& entry);
+    void InsertIntoCells(uint32_t windowId, HitTestEntry& entry);
+    void RemoveFromCells(uint32_t windowId, const HitTestEntry& entry);
+    static bool IsPointInEntry(const HitTestEntry& entry, const PointInfo& point);
+    static int32_t GetCellIndex(int64_t pos);
+    static uint64_t GetCellKey(int32_t cellX, int32_t cellY);
+
+    std::unordered_map<uint32_t, HitTestEntry> entries_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+    // windows covering too many cells, e.g. with huge transformed bounds, are checked on every query instead
+    std::set<uint32_t> oversizedWindowIds_;
+};
+} // namespace Rosen
+} // namespace OHOS
+#endif // OHOS_ROSEN_WINDOW_HIT_TEST_INDEX_H
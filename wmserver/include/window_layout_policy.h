@@ -22,6 +22,7 @@
 
 #include "display_group_info.h"
 #include "display_info.h"
+#include "window_hit_test_index.h"
 #include "window_node.h"
 #include "wm_common.h"
 
@@ -50,6 +51,8 @@ public:
     virtual void LayoutWindowTree(DisplayId displayId);
     virtual void RemoveWindowNode(const sptr<WindowNode>& node);
     virtual void UpdateWindowNode(const sptr<WindowNode>& node, bool isAddWindow = false);
+    // only moves the surface and hot areas of a main floating window, return false if a full layout is needed
+    bool MoveWindowNode(const sptr<WindowNode>& node, const Rect& requestRect);
     virtual void UpdateLayoutRect(const sptr<WindowNode>& node) = 0;
     virtual void SetSplitDividerWindowRects(std::map<DisplayId, Rect> dividerWindowRects) {};
     virtual Rect GetDividerRect(DisplayId displayId) const;
@@ -63,6 +66,7 @@ public:
     void ProcessDisplaySizeChangeOrRotation(DisplayId displayId, const std::map<DisplayId, Rect>& displayRectMap);
     void SetSplitRatioConfig(const SplitRatioConfig& splitRatioConfig);
     virtual bool IsTileRectSatisfiedWithSizeLimits(const sptr<WindowNode>& node);
+    void SetHitTestIndex(const sptr<WindowHitTestIndex>& hitTestIndex);
 
 protected:
     void UpdateFloatingLayoutRect(Rect& limitRect, Rect& winRect);
@@ -123,6 +127,7 @@ protected:
     Rect displayGroupLimitRect_;
     bool isMultiDisplay_ = false;
     SplitRatioConfig splitRatioConfig_;
+    sptr<WindowHitTestIndex> hitTestIndex_;
 };
 }
 }
@@ -18,6 +18,7 @@
 
 #include <mutex>
 #include "client_agent_container.h"
+#include "window_manager_agent_dispatcher.h"
 #include "wm_single_instance.h"
 #include "zidl/window_manager_agent_interface.h"
 
@@ -36,12 +37,14 @@ public:
     void NotifyAccessibilityWindowInfo(const sptr<AccessibilityWindowInfo>& windowInfo, WindowUpdateType type);
     void UpdateWindowVisibilityInfo(const std::vector<sptr<WindowVisibilityInfo>>& windowVisibilityInfos);
     void UpdateCameraFloatWindowStatus(uint32_t accessTokenId, bool isShowing);
+    void DumpAgentInfo(std::string& dumpInfo);
 
 private:
-    WindowManagerAgentController() {}
+    WindowManagerAgentController();
     virtual ~WindowManagerAgentController() = default;
 
     ClientAgentContainer<IWindowManagerAgent, WindowManagerAgentType> wmAgentContainer_;
+    WindowManagerAgentDispatcher dispatcher_;
 };
 }
 }
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_ROSEN_WINDOW_MANAGER_AGENT_DISPATCHER_H
+#define OHOS_ROSEN_WINDOW_MANAGER_AGENT_DISPATCHER_H
+
+#include <chrono>
+#include <deque>
+#include <event_handler.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "agent_death_recipient.h"
+#include "zidl/window_manager_agent_interface.h"
+
+namespace OHOS {
+namespace Rosen {
+struct AgentNotification {
+    WindowManagerAgentType type_;
+    // a pending notification of the same type and key is superseded if its sub keys are covered by the new one
+    bool isCoalescable_ { false };
+    uint64_t key_ { 0 };
+    std::set<uint32_t> subKeys_;
+    std::function<void(const sptr<IWindowManagerAgent>&)> deliver_;
+    // undoes the latest pending notification of the same type and key if that has the same sub keys and is no
+    // undo itself, e.g. the unfocus of a window whose focus was not delivered yet, then both are dropped
+    bool isUndo_ { false };
+};
+
+/*
+ * Delivers notifications to window manager agents on a small worker pool instead of the WMS handler.
+ * Every agent has its own bounded queue drained in order by one worker at a time, so a slow listener
+ * only delays itself; an agent whose queue overflows is dropped through the drop callback.
+ */
+class WindowManagerAgentDispatcher {
+public:
+    using AgentDropCallback = std::function<void(const sptr<IWindowManagerAgent>&,
+        const std::set<WindowManagerAgentType>&)>;
+    explicit WindowManagerAgentDispatcher(AgentDropCallback dropCallback);
+    ~WindowManagerAgentDispatcher() = default;
+
+    void Dispatch(const sptr<IWindowManagerAgent>& agent, AgentNotification&& notification);
+    // forget the queue and the dropped flag of an agent, e.g. when it registers again
+    void ResetAgent(const sptr<IWindowManagerAgent>& agent);
+    // discard the pending notifications of type, the queue is released once the agent has no type left
+    void RemoveAgentType(const sptr<IWindowManagerAgent>& agent, WindowManagerAgentType type);
+    void Dump(std::string& dumpInfo);
+
+private:
+    struct AgentQueue {
+        sptr<IWindowManagerAgent> agent_;
+        std::shared_ptr<AppExecFwk::EventHandler> worker_;
+        std::deque<std::pair<AgentNotification, std::chrono::steady_clock::time_point>> notifications_;
+        std::set<WindowManagerAgentType> types_;
+        bool isDraining_ { false };
+        bool isDropped_ { false };
+        // released by the running drain task once it finishes
+        bool isRemoved_ { false };
+        size_t maxDepth_ { 0 };
+        uint64_t deliveredCount_ { 0 };
+        uint64_t coalescedCount_ { 0 };
+        int64_t totalLatency_ { 0 };
+        int64_t maxLatency_ { 0 };
+    };
+    std::shared_ptr<AppExecFwk::EventHandler> GetWorker();
+    void Drain(const sptr<IRemoteObject>& remoteObject);
+    void OnAgentDied(const sptr<IRemoteObject>& remoteObject);
+    void RemoveQueueLocked(std::map<sptr<IRemoteObject>, AgentQueue>::iterator iter);
+    static bool Supersedes(const AgentNotification& newer, const AgentNotification& older);
+    static bool UndoPendingLocked(AgentQueue& queue, const AgentNotification& notification);
+
+    std::mutex mutex_;
+    std::map<sptr<IRemoteObject>, AgentQueue> agentQueues_;
+    std::vector<std::shared_ptr<AppExecFwk::EventHandler>> workers_;
+    uint32_t nextWorker_ { 0 };
+    AgentDropCallback dropCallback_;
+    sptr<AgentDeathRecipient> deathRecipient_;
+};
+} // namespace Rosen
+} // namespace OHOS
+#endif // OHOS_ROSEN_WINDOW_MANAGER_AGENT_DISPATCHER_H
@@ -16,8 +16,14 @@
 #ifndef OHOS_WINDOW_MANAGER_SERVICE_H
 #define OHOS_WINDOW_MANAGER_SERVICE_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <set>
+#include <unordered_set>
 #include "event_handler.h"
 
 #include <input_window_monitor.h>
@@ -66,6 +72,14 @@ public:
     virtual void CancelStartingWindow(sptr<IRemoteObject> abilityToken) override;
 };
 
+// latency classes of the tasks run on the WMS handler, from the most to the least latency sensitive
+enum class WmsTaskClass : uint32_t {
+    INTERACTIVE, // input driven: focus, pointer, move and drag, animation callbacks
+    LIFECYCLE,   // window creation, removal, layout and state changes
+    BOOKKEEPING, // dump, lookups, agent registration
+    END,
+};
+
 class RSUIDirector;
 class WindowManagerService : public SystemAbility, public WindowManagerStub {
 friend class DisplayChangeListener;
@@ -123,6 +137,8 @@ public:
     WMError BindDialogTarget(uint32_t& windowId, sptr<IRemoteObject> targetToken) override;
     void HasPrivateWindow(DisplayId displayId, bool& hasPrivateWindow);
     void NotifyWindowClientPointUp(uint32_t windowId, const std::shared_ptr<MMI::PointerEvent>& pointerEvent);
+    void UpdateMoveOrDragRect(const sptr<WindowProperty>& windowProperty, int64_t pointerTime);
+    void DumpTaskClassInfo(std::string& dumpInfo) const;
 
 protected:
     WindowManagerService();
@@ -140,18 +156,26 @@ private:
         const std::map<DisplayId, sptr<DisplayInfo>>& displayInfoMap, DisplayStateChangeType type);
     WMError GetFocusWindowInfo(sptr<IRemoteObject>& abilityToken);
     void ConfigureWindowManagerService();
-    void PostAsyncTask(Task task);
-    void PostVoidSyncTask(Task task);
+    bool PostAsyncTask(Task task, WmsTaskClass taskClass = WmsTaskClass::LIFECYCLE);
+    void PostVoidSyncTask(Task task, WmsTaskClass taskClass = WmsTaskClass::LIFECYCLE);
     template<typename SyncTask, typename Return = std::invoke_result_t<SyncTask>>
-    Return PostSyncTask(SyncTask&& task)
+    Return PostSyncTask(SyncTask&& task, WmsTaskClass taskClass = WmsTaskClass::LIFECYCLE)
     {
         Return ret;
-        std::function<void()> syncTask([&ret, &task]() {ret = task();});
-        if (handler_) {
-            handler_->PostSyncTask(syncTask, AppExecFwk::EventQueue::Priority::IMMEDIATE);
-        }
+        PostVoidSyncTask([&ret, &task]() { ret = task(); }, taskClass);
         return ret;
     }
+    void RunTask(const Task& task, WmsTaskClass taskClass, WmsTaskClass lane,
+        std::chrono::steady_clock::time_point postTime);
+    WmsTaskClass AcquireTaskLane(WmsTaskClass taskClass, std::chrono::steady_clock::time_point postTime);
+    void ReleaseTaskLane(WmsTaskClass taskClass, WmsTaskClass lane, std::chrono::steady_clock::time_point postTime);
+    // state changing entry points mark the read model, read-only tasks leave it alone
+    void MarkReadModelStale();
+    void MarkReadModelWindowStale(uint32_t windowId);
+    void MarkReadModelStale(const sptr<WindowProperty>& windowProperty, PropertyChangeAction action);
+    void PostReadModelPublish();
+    std::shared_ptr<const WindowReadModel> PublishReadModel();
+    std::shared_ptr<const WindowReadModel> GetReadModel();
     void ConfigHotZones(const std::vector<int>& hotZones);
     void ConfigWindowAnimation(const WindowManagerConfig::ConfigItem& animeConfig);
     void ConfigKeyboardAnimation(const WindowManagerConfig::ConfigItem& animeConfig);
@@ -180,6 +204,29 @@ private:
     bool startingOpen_ = true;
     std::shared_ptr<RSUIDirector> rsUiDirector_;
     ShowWindowTimeConfig showWindowTimeConfig_ = { 0, 0, 0, 0, 0 };
+    // replaced as a whole on the handler, read with atomic_load from binder threads
+    std::shared_ptr<const WindowReadModel> readModel_;
+    // bumped on the handler by every change, a model published at an older sequence is not served
+    std::atomic<uint64_t> readModelChangeSeq_ { 0 };
+    std::atomic<uint64_t> readModelPublishedSeq_ { 0 };
+    // only touched on the handler
+    bool isReadModelStale_ = true;
+    std::unordered_set<uint32_t> readModelStaleWindows_;
+    bool isReadModelPublishPosted_ = false;
+    struct TaskClassStatistics {
+        uint64_t taskCount_ { 0 };
+        uint64_t yieldCount_ { 0 };
+        int64_t totalWaitTime_ { 0 };
+        int64_t maxWaitTime_ { 0 };
+    };
+    // post times of the tasks queued in each lane, a lane is a task class run at that class's priority
+    std::mutex taskLaneMutex_;
+    std::array<std::multiset<std::chrono::steady_clock::time_point>,
+        static_cast<size_t>(WmsTaskClass::END)> pendingTaskPostTimes_;
+    // lifecycle tasks queued in the bookkeeping lane
+    uint32_t demotedLifecycleTaskCount_ { 0 };
+    // only touched on the handler
+    std::array<TaskClassStatistics, static_cast<size_t>(WmsTaskClass::END)> taskClassStatistics_;
 };
 } // namespace Rosen
 } // namespace OHOS
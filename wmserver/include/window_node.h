@@ -16,6 +16,7 @@
 #ifndef OHOS_ROSEN_WINDOW_NODE_H
 #define OHOS_ROSEN_WINDOW_NODE_H
 
+#include <array>
 #include <ipc_skeleton.h>
 #include <refbase.h>
 #include <running_lock.h>
@@ -76,6 +77,7 @@ public:
     void SetWindowUpdatedSizeLimits(const WindowSizeLimits& sizeLimits);
     void ComputeTransform();
     void SetTransform(const Transform& trans);
+    void SetZOrder(uint32_t zOrder);
 
     const sptr<IWindow>& GetWindowToken() const;
     uint32_t GetWindowId() const;
@@ -110,6 +112,10 @@ public:
     uint32_t GetAccessTokenId() const;
     WindowSizeLimits GetWindowSizeLimits() const;
     WindowSizeLimits GetWindowUpdatedSizeLimits() const;
+    uint32_t GetZOrder() const;
+    // bumped whenever the window content is known to change, cached snapshots of an older generation are stale
+    void UpdateContentGeneration();
+    uint32_t GetContentGeneration() const;
 
     bool EnableDefaultAnimation(bool propertyEnabled, bool animationPlayed);
     sptr<WindowNode> parent_;
@@ -129,17 +135,23 @@ public:
     bool isPlayAnimationHide_ { false };
     bool startingWindowShown_ { false };
     bool isShowingOnMultiDisplays_ { false };
+    // set whenever a field reported to MMI changes, cleared once InputWindowMonitor rebuilt the window's info
+    bool isInputInfoDirty_ { true };
     std::vector<DisplayId> showingDisplays_;
 
 private:
     sptr<WindowProperty> property_ = nullptr;
     sptr<IWindow> windowToken_ = nullptr;
     Rect fullWindowHotArea_ { 0, 0, 0, 0 };
+    uint32_t contentGeneration_ { 0 };
     std::vector<Rect> touchHotAreas_; // coordinates relative to display.
     int32_t callingPid_ = { 0 };
     int32_t inputCallingPid_ = { 0 };
     int32_t callingUid_ = { 0 };
     WindowSizeChangeReason windowSizeChangeReason_ {WindowSizeChangeReason::UNDEFINED};
+    // z-order last written to RS, with the ids of the leash, main and starting surface nodes it was written to
+    uint32_t zOrder_ { 0 };
+    std::array<uint64_t, 3> zOrderSurfaceIds_ { 0, 0, 0 };
 };
 } // Rosen
 } // OHOS
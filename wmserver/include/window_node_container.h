@@ -22,6 +22,7 @@
 #include "minimize_app.h"
 #include "display_group_controller.h"
 #include "display_group_info.h"
+#include "window_hit_test_index.h"
 #include "window_layout_policy.h"
 #include "window_manager.h"
 #include "window_node.h"
@@ -42,6 +43,7 @@ public:
     WMError RemoveWindowNode(sptr<WindowNode>& node);
     WMError HandleRemoveWindow(sptr<WindowNode>& node);
     WMError UpdateWindowNode(sptr<WindowNode>& node, WindowUpdateReason reason);
+    bool MoveWindowNode(sptr<WindowNode>& node, const Rect& requestRect);
     WMError DestroyWindowNode(sptr<WindowNode>& node, std::vector<uint32_t>& windowIds);
     const std::vector<uint32_t>& Destroy();
     void AssignZOrder();
@@ -59,6 +61,9 @@ public:
     AvoidArea GetAvoidAreaByType(const sptr<WindowNode>& node, AvoidAreaType avoidAreaType) const;
     WMError MinimizeStructuredAppWindowsExceptSelf(const sptr<WindowNode>& node);
     void TraverseContainer(std::vector<sptr<WindowNode>>& windowNodes) const;
+    std::shared_ptr<const std::vector<sptr<WindowNode>>> GetZOrderedWindowNodes() const;
+    void MarkWindowTreeChanged();
+    sptr<WindowNode> HitTest(const PointInfo& point, const HitTestFilterFunc& filter) const;
     uint64_t GetScreenId(DisplayId displayId) const;
     Rect GetDisplayRect(DisplayId displayId) const;
     std::unordered_map<WindowType, SystemBarProperty> GetExpectImmersiveProperty() const;
@@ -113,7 +118,6 @@ public:
     bool HasPrivateWindow();
     static AnimationConfig& GetAnimationConfigRef();
 private:
-    void TraverseWindowNode(sptr<WindowNode>& root, std::vector<sptr<WindowNode>>& windowNodes) const;
     sptr<WindowNode> FindRoot(WindowType type) const;
     sptr<WindowNode> FindWindowNodeById(uint32_t id) const;
     void UpdateFocusStatus(uint32_t id, bool focused) const;
@@ -133,8 +137,6 @@ private:
     void ResetLayoutPolicy();
     bool IsAboveSystemBarNode(sptr<WindowNode> node) const;
     bool IsSplitImmersiveNode(sptr<WindowNode> node) const;
-    bool TraverseFromTopToBottom(sptr<WindowNode> node, const WindowNodeOperationFunc& func) const;
-    bool TraverseFromBottomToTop(sptr<WindowNode> node, const WindowNodeOperationFunc& func) const;
     void RecoverScreenDefaultOrientationIfNeed(DisplayId displayId);
     void RaiseOrderedWindowToTop(std::vector<sptr<WindowNode>>& orderedNodes,
         std::vector<sptr<WindowNode>>& windowNodes);
@@ -152,10 +154,21 @@ private:
                                                const std::vector<DisplayId>& curShowingDisplays);
     bool CheckWindowNodeWhetherInWindowTree(const sptr<WindowNode>& node) const;
     void UpdateModeSupportInfoWhenKeyguardChange(const sptr<WindowNode>& node, bool up);
+    void AddWindowNodeIndex(const sptr<WindowNode>& node);
+    void RemoveWindowNodeIndex(const sptr<WindowNode>& node);
+    void AppendZOrderedWindowNode(const sptr<WindowNode>& node, std::vector<sptr<WindowNode>>& windowNodes) const;
 
     float displayBrightness_ = UNDEFINED_BRIGHTNESS;
     uint32_t brightnessWindow_ = INVALID_WINDOW_ID;
     uint32_t zOrder_ { 0 };
+    // flat bottom-to-top copy of the window tree, rebuilt lazily once per window tree generation
+    mutable std::shared_ptr<const std::vector<sptr<WindowNode>>> zOrderedWindowNodes_;
+    mutable uint64_t zOrderedWindowNodesGeneration_ { 0 };
+    uint64_t windowTreeGeneration_ { 1 };
+    uint64_t displayGroupWindowTreeGeneration_ { 0 };
+    // windows reachable from the root nodes, including sub windows, indexed by id
+    std::unordered_map<uint32_t, sptr<WindowNode>> windowNodeMap_;
+    sptr<WindowHitTestIndex> hitTestIndex_ = new WindowHitTestIndex();
     uint32_t focusedWindow_ { INVALID_WINDOW_ID };
     uint32_t activeWindow_ = INVALID_WINDOW_ID;
     bool isScreenLocked_ = false;
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_ROSEN_WINDOW_READ_MODEL_H
+#define OHOS_ROSEN_WINDOW_READ_MODEL_H
+
+#include <map>
+#include <refbase.h>
+#include <unordered_map>
+#include <vector>
+
+#include "window_manager.h"
+#include "wm_common.h"
+#include "wm_common_inner.h"
+
+namespace OHOS {
+namespace Rosen {
+struct WindowReadInfo {
+    uint32_t topWindowId_ { INVALID_WINDOW_ID };
+    std::map<AvoidAreaType, AvoidArea> avoidAreas_;
+};
+
+/*
+ * Answers of the read-only WMS requests, built on the WMS handler after the window state changed
+ * and never modified once published, so binder threads can read it without posting to the handler.
+ */
+class WindowReadModel {
+public:
+    WindowReadModel() = default;
+    ~WindowReadModel() = default;
+
+    AvoidArea GetAvoidAreaByType(uint32_t windowId, AvoidAreaType avoidAreaType) const;
+    WMError GetTopWindowId(uint32_t mainWinId, uint32_t& topWinId) const;
+    WMError GetModeChangeHotZones(DisplayId displayId, ModeChangeHotZones& hotZones) const;
+    void GetAccessibilityWindowInfo(sptr<AccessibilityWindowInfo>& windowInfo) const;
+
+    // visible windows only, others answer as if they do not exist
+    std::unordered_map<uint32_t, WindowReadInfo> windowInfos_;
+    std::map<DisplayId, ModeChangeHotZones> hotZones_;
+    std::vector<sptr<WindowInfo>> accessibilityWindowList_;
+};
+} // namespace Rosen
+} // namespace OHOS
+#endif // OHOS_ROSEN_WINDOW_READ_MODEL_H
@@ -15,6 +15,8 @@
 #ifndef OHOS_ROSEN_WINDOW_ROOT_H
 #define OHOS_ROSEN_WINDOW_ROOT_H
 
+#include <set>
+#include <unordered_map>
 #include <refbase.h>
 #include <iremote_object.h>
 #include <transaction/rs_interfaces.h>
@@ -22,6 +24,7 @@
 #include "agent_death_recipient.h"
 #include "display_manager_service_inner.h"
 #include "window_node_container.h"
+#include "window_read_model.h"
 #include "zidl/window_manager_agent_interface.h"
 
 namespace OHOS {
@@ -50,10 +53,17 @@ public:
     WMError RemoveWindowNode(uint32_t windowId);
     WMError DestroyWindow(uint32_t windowId, bool onlySelf);
     WMError UpdateWindowNode(uint32_t windowId, WindowUpdateReason reason);
+    WMError MoveWindowNode(uint32_t windowId, const Rect& requestRect);
     bool isVerticalDisplay(sptr<WindowNode>& node) const;
     bool IsForbidDockSliceMove(DisplayId displayId) const;
     bool IsDockSliceInExitSplitModeArea(DisplayId displayId) const;
     void ExitSplitMode(DisplayId displayId);
+    /*
+     * Topmost window under the point that passes the filter, looked up through the container's grid index.
+     * Only drag targets are resolved here: mode change hot zones are fixed display areas from the config and
+     * touch outside notifies every other window, neither of them looks up the window under a point.
+     */
+    sptr<WindowNode> HitTest(DisplayId displayId, const PointInfo& point, const HitTestFilterFunc& filter);
     void NotifyWindowVisibilityChange(std::shared_ptr<RSOcclusionData> occlusionData);
     void AddSurfaceNodeIdWindowNodePair(uint64_t surfaceNodeId, sptr<WindowNode> node);
 
@@ -63,7 +73,10 @@ public:
     AvoidArea GetAvoidAreaByType(uint32_t windowId, AvoidAreaType avoidAreaType);
     WMError SetWindowMode(sptr<WindowNode>& node, WindowMode dstMode);
     std::shared_ptr<RSSurfaceNode> GetSurfaceNodeByAbilityToken(const sptr<IRemoteObject>& abilityToken) const;
+    sptr<WindowNode> GetWindowNodeByAbilityToken(const sptr<IRemoteObject>& abilityToken) const;
     WMError GetTopWindowId(uint32_t mainWinId, uint32_t& topWinId);
+    void GetWindowReadInfos(std::unordered_map<uint32_t, WindowReadInfo>& windowInfos);
+    void UpdateWindowReadInfo(uint32_t windowId, std::unordered_map<uint32_t, WindowReadInfo>& windowInfos);
     void MinimizeAllAppWindows(DisplayId displayId);
     WMError ToggleShownStateForAllAppWindows();
     WMError SetWindowLayoutMode(DisplayId displayId, WindowLayoutMode mode);
@@ -100,9 +113,12 @@ public:
     void RemoveSingleUserWindowNodes(int accountId);
     sptr<WindowNode> FindDialogCallerNode(WindowType type, sptr<IRemoteObject> token);
     bool CheckMultiDialogWindows(WindowType type, sptr<IRemoteObject> token);
+    void BindDialogTarget(const sptr<WindowNode>& node, sptr<IRemoteObject> targetToken);
     bool HasPrivateWindow(DisplayId displayId);
+    void SetOrientationFromWindow(const sptr<WindowNode>& node);
 
 private:
+    void FillWindowReadInfo(const sptr<WindowNode>& node, WindowReadInfo& info);
     void OnRemoteDied(const sptr<IRemoteObject>& remoteObject);
     WMError DestroyWindowInner(sptr<WindowNode>& node);
     void UpdateFocusWindowWithWindowRemoved(const sptr<WindowNode>& node,
@@ -125,10 +141,16 @@ private:
     std::vector<std::pair<uint64_t, bool>> GetWindowVisibilityChangeInfo(
         std::shared_ptr<RSOcclusionData> occlusionData);
     bool NeedToStopAddingNode(sptr<WindowNode>& node, const sptr<WindowNodeContainer>& container);
+    void AddWindowNodeIndex(const sptr<WindowNode>& node);
+    void RemoveWindowNodeIndex(const sptr<WindowNode>& node);
 
     std::map<uint32_t, sptr<WindowNode>> windowNodeMap_;
     std::map<sptr<IRemoteObject>, uint32_t> windowIdMap_;
     std::map<uint64_t, sptr<WindowNode>> surfaceIdWindowNodeMap_;
+    // secondary indexes of windowNodeMap_, kept in sync by SaveWindow and DestroyWindowInner
+    std::map<sptr<IRemoteObject>, std::set<uint32_t>> abilityTokenWindowIdMap_;
+    std::map<sptr<IRemoteObject>, std::set<uint32_t>> dialogTargetWindowIdMap_;
+    std::unordered_map<uint32_t, std::vector<uint64_t>> windowIdSurfaceIdMap_;
     std::shared_ptr<RSOcclusionData> lastOcclusionData_ = std::make_shared<RSOcclusionData>();
     std::map<ScreenId, sptr<WindowNodeContainer>> windowNodeContainerMap_;
     std::map<ScreenId, std::vector<DisplayId>> displayIdMap_;
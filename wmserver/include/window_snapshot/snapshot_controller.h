@@ -16,38 +16,122 @@
 #ifndef OHOS_ROSEN_SNAPSHOT_CONTROLLER_H
 #define OHOS_ROSEN_SNAPSHOT_CONTROLLER_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <snapshot.h>
+#include <tuple>
+#include <vector>
 #include <transaction/rs_interfaces.h>
 
 #include "event_handler.h"
 #include "future.h"
+#include "pixel_map.h"
 #include "snapshot_stub.h"
+#include "transaction/rs_render_service_client.h"
 #include "wm_common_inner.h"
 #include "window_root.h"
 #include "window_manager_hilog.h"
 
 namespace OHOS {
 namespace Rosen {
+using SnapshotCallback = std::function<void(WMError, const std::shared_ptr<Media::PixelMap>&)>;
+// posts a task to the WMS handler in the lane of its task class, returns false when it could not be posted
+using SnapshotTaskPoster = std::function<bool(const std::function<void()>&)>;
+
+// handle of one asynchronous snapshot request, the callback runs exactly once unless the request is cancelled
+class SnapshotRequest {
+public:
+    explicit SnapshotRequest(SnapshotCallback callback) : callback_(std::move(callback)),
+        startTime_(std::chrono::steady_clock::now()) {};
+    ~SnapshotRequest() = default;
+    void Cancel();
+    bool IsFinished() const;
+    // returns false when the request was already completed or cancelled
+    bool Complete(WMError ret, const std::shared_ptr<Media::PixelMap>& pixelMap);
+    int64_t GetElapsedTime() const;
+
+private:
+    std::atomic<bool> isFinished_ { false };
+    SnapshotCallback callback_;
+    std::chrono::steady_clock::time_point startTime_;
+};
+
+// one render service capture, listeners added after it finished are called at once
+class SnapshotCapture : public SurfaceCaptureCallback {
+public:
+    using CaptureListener = std::function<void(const std::shared_ptr<Media::PixelMap>&)>;
+    void OnSurfaceCapture(std::shared_ptr<Media::PixelMap> pixelMap) override;
+    void AddListener(CaptureListener listener);
+
+private:
+    std::mutex mutex_;
+    bool isFinished_ { false };
+    std::shared_ptr<Media::PixelMap> pixelMap_;
+    std::vector<CaptureListener> listeners_;
+};
+
 class SnapshotController : public SnapshotStub {
 public:
-    SnapshotController(sptr<WindowRoot>& root, std::shared_ptr<AppExecFwk::EventHandler>& handler) : windowRoot_(root),
-        handler_(handler), rsInterface_(RSInterfaces::GetInstance()) {};
-    SnapshotController() : windowRoot_(nullptr), handler_(nullptr), rsInterface_(RSInterfaces::GetInstance()) {};
+    SnapshotController(sptr<WindowRoot>& root, SnapshotTaskPoster taskPoster) : windowRoot_(root),
+        taskPoster_(std::move(taskPoster)), timeoutHandler_(CreateTimeoutHandler()),
+        rsInterface_(RSInterfaces::GetInstance()) {};
+    SnapshotController() : windowRoot_(nullptr), rsInterface_(RSInterfaces::GetInstance()) {};
     ~SnapshotController() = default;
     void Init(sptr<WindowRoot>& root);
+    // the snapshot handler interface is synchronous, the binder thread waits at most SNAPSHOT_TIMEOUT_MS in total
     int32_t GetSnapshot(const sptr<IRemoteObject> &token, AAFwk::Snapshot& snapshot) override;
+    /*
+     * Returns at once, the callback runs on the render service or timeout thread when the capture completes or
+     * the timeout expires. Returns nullptr and never calls back when the request cannot be issued.
+     */
+    std::shared_ptr<SnapshotRequest> GetSnapshotAsync(const sptr<IRemoteObject>& token, SnapshotCallback callback,
+        int64_t timeoutMs);
 
 private:
-    WMError TakeSnapshot(const std::shared_ptr<RSSurfaceNode>& surfaceNode, AAFwk::Snapshot& snapshot);
+    struct SnapshotCacheKey {
+        NodeId nodeId_;
+        float scaleW_;
+        float scaleH_;
+        uint32_t contentGeneration_;
+        bool operator<(const SnapshotCacheKey& right) const
+        {
+            return std::tie(nodeId_, scaleW_, scaleH_, contentGeneration_) <
+                std::tie(right.nodeId_, right.scaleW_, right.scaleH_, right.contentGeneration_);
+        }
+    };
+    // a capture still in flight is shared by every identical request that arrives meanwhile
+    struct SnapshotCacheEntry {
+        std::shared_ptr<SnapshotCapture> capture_;
+        std::chrono::steady_clock::time_point requestTime_;
+        // the latest deadline of the requests sharing the capture, it is given up once that passed
+        std::chrono::steady_clock::time_point deadline_;
+    };
+    static std::shared_ptr<AppExecFwk::EventHandler> CreateTimeoutHandler();
+    void TakeSnapshot(const std::shared_ptr<RSSurfaceNode>& surfaceNode, uint32_t contentGeneration,
+        const std::shared_ptr<SnapshotRequest>& request, std::chrono::steady_clock::time_point deadline);
+    void FinishRequest(const std::shared_ptr<SnapshotRequest>& request, WMError ret,
+        const std::shared_ptr<Media::PixelMap>& pixelMap);
+    std::shared_ptr<SnapshotCapture> GetOrCreateCapture(const SnapshotCacheKey& key,
+        std::chrono::steady_clock::time_point deadline, bool& isNewCapture);
+    void RemoveCapture(const SnapshotCacheKey& key, const std::shared_ptr<SnapshotCapture>& capture);
+    void RemoveExpiredCapturesLocked(std::chrono::steady_clock::time_point now);
+    void RemoveExpiredCaptures();
     void RecordGetSnapshotEvent(int64_t costTime);
 
 private:
     float scaleW = 0.5f; // width scaling ratio(0.5)
     float scaleH = 0.5f; // height scaling ratio(0.5)
     sptr<WindowRoot> windowRoot_;
-    std::shared_ptr<AppExecFwk::EventHandler> handler_;
+    SnapshotTaskPoster taskPoster_;
+    // deadlines are enforced on a thread of their own, a busy wms handler must not delay them
+    std::shared_ptr<AppExecFwk::EventHandler> timeoutHandler_;
     RSInterfaces& rsInterface_;
     GetSnapshotTimeConfig getSnapshotTimeConfig_ = { 0, 0, 0, 0, 0, 0 };
+    std::mutex snapshotCacheMutex_;
+    std::map<SnapshotCacheKey, SnapshotCacheEntry> snapshotCache_;
 };
 } // Rosen
 } // OHOS
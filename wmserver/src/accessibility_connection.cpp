@@ -15,6 +15,8 @@
 
 #include "accessibility_connection.h"
 
+#include <algorithm>
+
 #include "display_manager_service_inner.h"
 #include "window_manager.h"
 #include "window_manager_agent_controller.h"
@@ -133,4 +135,29 @@ void AccessibilityConnection::GetAccessibilityWindowInfo(sptr<AccessibilityWindo
         }
     }
 }
+
+void AccessibilityConnection::UpdateAccessibilityWindowInfo(uint32_t windowId,
+    std::vector<sptr<WindowInfo>>& windowList) const
+{
+    auto iter = std::find_if(windowList.begin(), windowList.end(), [windowId](const sptr<WindowInfo>& info) {
+        return info != nullptr && static_cast<uint32_t>(info->wid_) == windowId;
+    });
+    if (iter == windowList.end()) {
+        return;
+    }
+    auto node = windowRoot_->GetWindowNode(windowId);
+    auto container = (node == nullptr) ? nullptr : windowRoot_->GetOrCreateWindowNodeContainer(node->GetDisplayId());
+    if (container == nullptr) {
+        windowList.erase(iter);
+        return;
+    }
+    // entries are shared with the published list, replace instead of modifying in place
+    sptr<WindowInfo> windowInfo = new (std::nothrow) WindowInfo();
+    if (windowInfo == nullptr) {
+        windowList.erase(iter);
+        return;
+    }
+    FillWindowInfo(node, container->GetFocusWindow(), windowInfo);
+    *iter = windowInfo;
+}
 }
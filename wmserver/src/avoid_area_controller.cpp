@@ -267,7 +267,7 @@ void AvoidAreaController::SetAvoidAreaRect(AvoidArea& avoidArea, const Rect& rec
 
 AvoidArea AvoidAreaController::GetAvoidAreaByType(const sptr<WindowNode>& node, AvoidAreaType avoidAreaType) const
 {
-    WLOGFI("avoidAreaType: %{public}u", avoidAreaType);
+    WLOGFD("avoidAreaType: %{public}u", avoidAreaType);
     if (node == nullptr) {
         WLOGFE("invalid WindowNode.");
         return {};
@@ -277,7 +277,7 @@ AvoidArea AvoidAreaController::GetAvoidAreaByType(const sptr<WindowNode>& node,
         windowMode != WindowMode::WINDOW_MODE_FULLSCREEN &&
         windowMode != WindowMode::WINDOW_MODE_SPLIT_PRIMARY &&
         windowMode != WindowMode::WINDOW_MODE_SPLIT_SECONDARY) {
-        WLOGFI("avoidAreaType: %{public}u, windowMode: %{public}u, return default avoid area.",
+        WLOGFD("avoidAreaType: %{public}u, windowMode: %{public}u, return default avoid area.",
             avoidAreaType, windowMode);
         return {};
     }
@@ -81,11 +81,10 @@ void DisplayGroupController::AddWindowNodeOnWindowTree(sptr<WindowNode>& node, W
 
 void DisplayGroupController::UpdateDisplayGroupWindowTree()
 {
-    // clear ori window tree of displayGroup
+    // clear ori window tree of displayGroup, keep the capacity since it is refilled right away
     for (auto& elem : displayGroupWindowTree_) {
         for (auto& nodeVec : elem.second) {
-            auto emptyVector = std::vector<sptr<WindowNode>>();
-            nodeVec.second->swap(emptyVector);
+            nodeVec.second->clear();
         }
     }
     std::vector<WindowRootNodeType> rootNodeType = {
@@ -273,6 +272,8 @@ void DisplayGroupController::UpdateWindowDisplayId(const sptr<WindowNode>& node,
         node->GetWindowToken()->UpdateDisplayId(node->GetDisplayId(), newDisplayId);
     }
     node->SetDisplayId(newDisplayId);
+    // the window tree of displayGroup is grouped by displayId, so it needs to be rebuilt
+    windowNodeContainer_->MarkWindowTreeChanged();
 }
 
 void DisplayGroupController::MoveCrossNodeToTargetDisplay(const sptr<WindowNode>& node, DisplayId targetDisplayId)
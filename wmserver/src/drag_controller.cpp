@@ -109,23 +109,9 @@ sptr<WindowNode> DragController::GetHitWindow(DisplayId id, PointInfo point)
         WLOGFE("Get invalid display");
         return nullptr;
     }
-    sptr<WindowNodeContainer> container = windowRoot_->GetOrCreateWindowNodeContainer(id);
-    if (container == nullptr) {
-        WLOGFE("get container failed %{public}" PRIu64"", id);
-        return nullptr;
-    }
-
-    std::vector<sptr<WindowNode>> windowNodes;
-    container->TraverseContainer(windowNodes);
-    for (auto windowNode : windowNodes) {
-        if (windowNode->GetWindowType() >= WindowType::WINDOW_TYPE_PANEL) {
-            continue;
-        }
-        if (WindowHelper::IsPointInTargetRect(point.x, point.y, windowNode->GetWindowRect())) {
-            return windowNode;
-        }
-    }
-    return nullptr;
+    return windowRoot_->HitTest(id, point, [](const sptr<WindowNode>& windowNode) {
+        return windowNode->GetWindowType() < WindowType::WINDOW_TYPE_PANEL;
+    });
 }
 
 bool DragController::GetHitPoint(uint32_t windowId, PointInfo& point)
@@ -221,10 +207,22 @@ void MoveDragController::HandleWindowRemovedOrDestroyed(uint32_t windowId)
     if (!(GetMoveDragProperty()->startMoveFlag_ || GetMoveDragProperty()->startDragFlag_)) {
         return;
     }
-    VsyncStation::GetInstance().RemoveCallback();
+    // the pending move belongs to the input handler, it is dropped there instead of removing every vsync callback
+    if (inputEventHandler_ != nullptr) {
+        inputEventHandler_->PostTask([this]() { DropPendingMoveEvent(); },
+            AppExecFwk::EventQueue::Priority::IMMEDIATE);
+    }
     ResetMoveOrDragState();
 }
 
+void MoveDragController::DropPendingMoveEvent()
+{
+    if (moveEvent_ != nullptr) {
+        moveEvent_->MarkProcessed();
+        moveEvent_ = nullptr;
+    }
+}
+
 void MoveDragController::ConsumePointerEvent(const std::shared_ptr<MMI::PointerEvent>& pointerEvent)
 {
     if (pointerEvent == nullptr) {
@@ -232,10 +230,20 @@ void MoveDragController::ConsumePointerEvent(const std::shared_ptr<MMI::PointerE
         return;
     }
     if (pointerEvent->GetPointerAction() == MMI::PointerEvent::POINTER_ACTION_MOVE) {
+        // only the latest move of a frame is handled, the replaced one is done as well
+        bool hasPendingMove = (moveEvent_ != nullptr);
+        DropPendingMoveEvent();
         moveEvent_ = pointerEvent;
-        VsyncStation::GetInstance().RequestVsync(vsyncCallback_);
+        if (!hasPendingMove) {
+            VsyncStation::GetInstance().RequestVsync(vsyncCallback_);
+        }
     } else {
         WLOGFI("[WMS] Dispatch non-move event, action: %{public}d", pointerEvent->GetPointerAction());
+        // the move batched before must not be overtaken by the up
+        if (moveEvent_ != nullptr) {
+            HandlePointerEvent(moveEvent_);
+            DropPendingMoveEvent();
+        }
         HandlePointerEvent(pointerEvent);
         pointerEvent->MarkProcessed();
     }
@@ -243,13 +251,20 @@ void MoveDragController::ConsumePointerEvent(const std::shared_ptr<MMI::PointerE
 
 void MoveDragController::OnReceiveVsync(int64_t timeStamp)
 {
+    // the vsync receiver keeps the handler it was created with, which is not the input handler if another
+    // module of the service requested vsync before Init, so the move is handed over to the input handler
+    if (inputEventHandler_ != nullptr && inputEventHandler_->GetEventRunner() != EventRunner::Current()) {
+        inputEventHandler_->PostTask([this, timeStamp]() { OnReceiveVsync(timeStamp); },
+            AppExecFwk::EventQueue::Priority::IMMEDIATE);
+        return;
+    }
     if (moveEvent_ == nullptr) {
-        WLOGFE("moveEvent is nullptr");
+        // dropped by an up event or the removal of the window after the vsync was requested
         return;
     }
     WLOGFD("[OnReceiveVsync] receive move event, action: %{public}d", moveEvent_->GetPointerAction());
     HandlePointerEvent(moveEvent_);
-    moveEvent_->MarkProcessed();
+    DropPendingMoveEvent();
 }
 
 Rect MoveDragController::GetHotZoneRect()
@@ -270,7 +285,7 @@ Rect MoveDragController::GetHotZoneRect()
     return hotZoneRect;
 }
 
-void MoveDragController::HandleDragEvent(int32_t posX, int32_t posY, int32_t pointId)
+void MoveDragController::HandleDragEvent(int32_t posX, int32_t posY, int32_t pointId, int64_t pointerTime)
 {
     if (moveDragProperty_ == nullptr) {
         return;
@@ -310,15 +325,16 @@ void MoveDragController::HandleDragEvent(int32_t posX, int32_t posY, int32_t poi
         }
         newRect.height_ = static_cast<uint32_t>(static_cast<int32_t>(newRect.height_) + diffY);
     }
-    WLOGFI("[WMS] HandleDragEvent, id: %{public}u, newRect: [%{public}d, %{public}d, %{public}d, %{public}d]",
+    WLOGFD("[WMS] HandleDragEvent, id: %{public}u, newRect: [%{public}d, %{public}d, %{public}d, %{public}d]",
         windowProperty_->GetWindowId(), newRect.posX_, newRect.posY_, newRect.width_, newRect.height_);
     windowProperty_->SetRequestRect(newRect);
     windowProperty_->SetWindowSizeChangeReason(WindowSizeChangeReason::DRAG);
     windowProperty_->SetDragType(moveDragProperty_->dragType_);
-    WindowManagerService::GetInstance().UpdateProperty(windowProperty_, PropertyChangeAction::ACTION_UPDATE_RECT, true);
+    // the handler works on a copy, windowProperty_ keeps changing with the next pointer events
+    WindowManagerService::GetInstance().UpdateMoveOrDragRect(new WindowProperty(windowProperty_), pointerTime);
 }
 
-void MoveDragController::HandleMoveEvent(int32_t posX, int32_t posY, int32_t pointId)
+void MoveDragController::HandleMoveEvent(int32_t posX, int32_t posY, int32_t pointId, int64_t pointerTime)
 {
     if (moveDragProperty_ == nullptr) {
         return;
@@ -331,11 +347,11 @@ void MoveDragController::HandleMoveEvent(int32_t posX, int32_t posY, int32_t poi
 
     const Rect& oriRect = windowProperty_->GetRequestRect();
     Rect newRect = { targetX, targetY, oriRect.width_, oriRect.height_ };
-    WLOGFI("[WMS] HandleMoveEvent, id: %{public}u, newRect: [%{public}d, %{public}d, %{public}d, %{public}d]",
+    WLOGFD("[WMS] HandleMoveEvent, id: %{public}u, newRect: [%{public}d, %{public}d, %{public}d, %{public}d]",
         windowProperty_->GetWindowId(), newRect.posX_, newRect.posY_, newRect.width_, newRect.height_);
     windowProperty_->SetRequestRect(newRect);
     windowProperty_->SetWindowSizeChangeReason(WindowSizeChangeReason::MOVE);
-    WindowManagerService::GetInstance().UpdateProperty(windowProperty_, PropertyChangeAction::ACTION_UPDATE_RECT, true);
+    WindowManagerService::GetInstance().UpdateMoveOrDragRect(new WindowProperty(windowProperty_), pointerTime);
 }
 
 void MoveDragController::HandlePointerEvent(const std::shared_ptr<MMI::PointerEvent>& pointerEvent)
@@ -353,8 +369,8 @@ void MoveDragController::HandlePointerEvent(const std::shared_ptr<MMI::PointerEv
     switch (action) {
         // ready to move or drag
         case MMI::PointerEvent::POINTER_ACTION_MOVE: {
-            HandleMoveEvent(pointPosX, pointPosY, pointId);
-            HandleDragEvent(pointPosX, pointPosY, pointId);
+            HandleMoveEvent(pointPosX, pointPosY, pointId, pointerEvent->GetActionTime());
+            HandleDragEvent(pointPosX, pointPosY, pointId, pointerEvent->GetActionTime());
             break;
         }
         // End move or drag
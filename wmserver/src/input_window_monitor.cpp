@@ -20,6 +20,7 @@
 
 #include "display_manager_service_inner.h"
 #include "dm_common.h"
+#include "outbound_call_worker.h"
 #include "window_helper.h"
 #include "window_manager_hilog.h"
 
@@ -36,6 +37,38 @@ static inline void convertRectsToMmiRects(const std::vector<Rect>& rects, std::v
     }
 }
 
+static inline bool IsSameMmiRect(const MMI::Rect& lhs, const MMI::Rect& rhs)
+{
+    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.width == rhs.width && lhs.height == rhs.height;
+}
+
+static bool IsSameMmiRects(const std::vector<MMI::Rect>& lhs, const std::vector<MMI::Rect>& rhs)
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); i++) {
+        if (!IsSameMmiRect(lhs[i], rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool IsSameWindowInfo(const MMI::WindowInfo& lhs, const MMI::WindowInfo& rhs)
+{
+    return lhs.id == rhs.id && lhs.pid == rhs.pid && lhs.uid == rhs.uid && IsSameMmiRect(lhs.area, rhs.area) &&
+        lhs.agentWindowId == rhs.agentWindowId && lhs.flags == rhs.flags &&
+        IsSameMmiRects(lhs.defaultHotAreas, rhs.defaultHotAreas) &&
+        IsSameMmiRects(lhs.pointerHotAreas, rhs.pointerHotAreas);
+}
+
+static bool IsSameDisplayInfo(const MMI::DisplayInfo& lhs, const MMI::DisplayInfo& rhs)
+{
+    return lhs.id == rhs.id && lhs.x == rhs.x && lhs.y == rhs.y && lhs.width == rhs.width &&
+        lhs.height == rhs.height && lhs.direction == rhs.direction;
+}
+
 void InputWindowMonitor::UpdateInputWindow(uint32_t windowId)
 {
     if (windowRoot_ == nullptr) {
@@ -50,6 +83,8 @@ void InputWindowMonitor::UpdateInputWindow(uint32_t windowId)
     if (windowTypeSkipped_.find(windowNode->GetWindowProperty()->GetWindowType()) != windowTypeSkipped_.end()) {
         return;
     }
+    // properties may have been changed through the window property directly, so rebuild this window's info
+    windowNode->isInputInfoDirty_ = true;
     DisplayId displayId = windowNode->GetDisplayId();
     UpdateInputWindowByDisplayId(displayId);
 }
@@ -59,38 +94,81 @@ void InputWindowMonitor::UpdateInputWindowByDisplayId(DisplayId displayId)
     if (displayId == DISPLAY_ID_INVALID) {
         return;
     }
+    // every push replaces the whole display group info in MMI, so only the latest request before a flush matters
+    pendingDisplayId_ = displayId;
+}
+
+void InputWindowMonitor::FlushPendingInputWindow()
+{
+    DisplayId displayId = pendingDisplayId_;
+    pendingDisplayId_ = DISPLAY_ID_INVALID;
+    if (displayId == DISPLAY_ID_INVALID) {
+        return;
+    }
+    if (!UpdateInputWindowInfo(displayId)) {
+        WLOGFD("input window info unchanged, skip update, displayId: %{public}" PRIu64"", displayId);
+        return;
+    }
+    WLOGFI("update display info to IMS, displayId: %{public}" PRIu64"", displayId);
+    if (displayGroupInfoSink_ != nullptr) {
+        displayGroupInfoSink_(displayGroupInfo_);
+        return;
+    }
+    // the info is complete, a newer one supersedes a pending one
+    OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::INPUT_DISPLAY_INFO, 0,
+        [displayGroupInfo = displayGroupInfo_]() {
+            MMI::InputManager::GetInstance()->UpdateDisplayInfo(displayGroupInfo);
+        });
+}
+
+void InputWindowMonitor::RemoveDisplayInfo(DisplayId displayId)
+{
+    displayInfoCache_.erase(displayId);
+}
+
+void InputWindowMonitor::SetDisplayGroupInfoSink(const DisplayGroupInfoSink& sink)
+{
+    displayGroupInfoSink_ = sink;
+}
+
+bool InputWindowMonitor::UpdateInputWindowInfo(DisplayId displayId)
+{
     auto container = windowRoot_->GetOrCreateWindowNodeContainer(displayId);
     if (container == nullptr) {
         WLOGFE("can not get window node container.");
-        return;
+        return false;
     }
 
     auto displayInfo = container->GetDisplayInfo(displayId);
     if (displayInfo == nullptr) {
-        return;
+        return false;
     }
 
-    UpdateDisplayGroupInfo(container, displayGroupInfo_);
-    UpdateDisplayInfo(displayInfo, displayGroupInfo_.displaysInfo);
-    std::vector<sptr<WindowNode>> windowNodes;
-    container->TraverseContainer(windowNodes);
-    TraverseWindowNodes(windowNodes, displayGroupInfo_.windowsInfo);
-    WLOGFI("update display info to IMS, displayId: %{public}" PRIu64"", displayId);
-    MMI::InputManager::GetInstance()->UpdateDisplayInfo(displayGroupInfo_);
+    bool isChanged = UpdateDisplayGroupInfo(container, displayGroupInfo_);
+    isChanged = UpdateDisplayInfo(displayInfo, displayGroupInfo_.displaysInfo) || isChanged;
+    auto windowNodes = container->GetZOrderedWindowNodes();
+    isChanged = TraverseWindowNodes(*windowNodes, displayGroupInfo_.windowsInfo) || isChanged;
+    return isChanged;
 }
 
-void InputWindowMonitor::UpdateDisplayGroupInfo(const sptr<WindowNodeContainer>& windowNodeContainer,
+bool InputWindowMonitor::UpdateDisplayGroupInfo(const sptr<WindowNodeContainer>& windowNodeContainer,
                                                 MMI::DisplayGroupInfo& displayGroupInfo)
 {
     const Rect&& rect = windowNodeContainer->GetDisplayGroupRect();
-    displayGroupInfo.width = static_cast<int32_t>(rect.width_);
-    displayGroupInfo.height = static_cast<int32_t>(rect.height_);
-    displayGroupInfo.focusWindowId = static_cast<int32_t>(windowNodeContainer->GetFocusWindow());
-    displayGroupInfo.windowsInfo.clear();
-    displayGroupInfo.displaysInfo.clear();
+    int32_t width = static_cast<int32_t>(rect.width_);
+    int32_t height = static_cast<int32_t>(rect.height_);
+    int32_t focusWindowId = static_cast<int32_t>(windowNodeContainer->GetFocusWindow());
+    if (displayGroupInfo.width == width && displayGroupInfo.height == height &&
+        displayGroupInfo.focusWindowId == focusWindowId) {
+        return false;
+    }
+    displayGroupInfo.width = width;
+    displayGroupInfo.height = height;
+    displayGroupInfo.focusWindowId = focusWindowId;
+    return true;
 }
 
-void InputWindowMonitor::UpdateDisplayInfo(const sptr<DisplayInfo>& displayInfo,
+bool InputWindowMonitor::UpdateDisplayInfo(const sptr<DisplayInfo>& displayInfo,
                                            std::vector<MMI::DisplayInfo>& displayInfoVector)
 {
     uint32_t displayWidth = displayInfo->GetWidth();
@@ -104,74 +182,146 @@ void InputWindowMonitor::UpdateDisplayInfo(const sptr<DisplayInfo>& displayInfo,
         .y = displayInfo->GetOffsetY(),
         .width = static_cast<int32_t>(displayWidth),
         .height = static_cast<int32_t>(displayHeight),
-        .name = (std::stringstream("display ")<<displayInfo->GetDisplayId()).str(),
         .uniq = "default0",
         .direction = GetDisplayDirectionForMmi(displayInfo->GetRotation()),
     };
-    auto displayIter = std::find_if(displayInfoVector.begin(), displayInfoVector.end(),
-        [&display](MMI::DisplayInfo& displayInfoTmp) {
-        return displayInfoTmp.id == display.id;
-    });
-    if (displayIter != displayInfoVector.end()) {
-        *displayIter = display;
+    auto cacheIter = displayInfoCache_.find(displayInfo->GetDisplayId());
+    if (cacheIter == displayInfoCache_.end() || !IsSameDisplayInfo(cacheIter->second, display)) {
+        display.name = "display " + std::to_string(displayInfo->GetDisplayId());
+        displayInfoCache_[displayInfo->GetDisplayId()] = display;
     } else {
-        displayInfoVector.emplace_back(display);
+        display.name = cacheIter->second.name;
+    }
+    // only the display being updated is reported to MMI, as the display group info is rebuilt per display
+    if (displayInfoVector.size() == 1 && IsSameDisplayInfo(displayInfoVector.front(), display)) {
+        return false;
     }
+    displayInfoVector.clear();
+    displayInfoVector.emplace_back(display);
+    return true;
 }
 
-void InputWindowMonitor::TraverseWindowNodes(const std::vector<sptr<WindowNode>> &windowNodes,
+bool InputWindowMonitor::TraverseWindowNodes(const std::vector<sptr<WindowNode>> &windowNodes,
                                              std::vector<MMI::WindowInfo>& windowsInfo)
 {
     std::map<uint32_t, sptr<WindowNode>> dialogWindowMap;
-    for (const auto& windowNode: windowNodes) {
+    for (auto nodeIter = windowNodes.rbegin(); nodeIter != windowNodes.rend(); ++nodeIter) {
+        const auto& windowNode = *nodeIter;
+        if (windowNode->GetWindowType() != WindowType::WINDOW_TYPE_DIALOG) {
+            continue;
+        }
         sptr<WindowNode> callerNode =
             windowRoot_->FindDialogCallerNode(windowNode->GetWindowType(), windowNode->dialogTargetToken_);
         if (callerNode != nullptr) {
             dialogWindowMap.insert(std::make_pair(callerNode->GetWindowId(), windowNode));
         }
     }
-    for (const auto& windowNode: windowNodes) {
+    updateSeq_++;
+    bool isChanged = false;
+    size_t index = 0;
+    // windowNodes are ordered from bottom to top while MMI expects the topmost window first
+    for (auto nodeIter = windowNodes.rbegin(); nodeIter != windowNodes.rend(); ++nodeIter) {
+        const auto& windowNode = *nodeIter;
         if (windowTypeSkipped_.find(windowNode->GetWindowType()) != windowTypeSkipped_.end()) {
-            WLOGFI("skip node[id:%{public}u, type:%{public}d]", windowNode->GetWindowId(), windowNode->GetWindowType());
+            WLOGFD("skip node[id:%{public}u, type:%{public}d]", windowNode->GetWindowId(), windowNode->GetWindowType());
             continue;
         }
-        std::vector<Rect> touchHotAreas;
-        windowNode->GetTouchHotAreas(touchHotAreas);
-        Rect areaRect = windowNode->GetWindowRect();
-        if (windowNode->GetWindowProperty()->GetTransform() != Transform::Identity()) {
-            windowNode->ComputeTransform();
-            for (Rect& rect : touchHotAreas) {
-                rect = WindowHelper::TransformRect(windowNode->GetWindowProperty()->GetTransformMat(), rect);
-            }
-            WLOGFI("area rect befoe tranform: [%{public}d, %{public}d, %{public}u, %{public}u]",
-                areaRect.posX_, areaRect.posY_, areaRect.width_, areaRect.height_);
-            areaRect = WindowHelper::TransformRect(windowNode->GetWindowProperty()->GetTransformMat(), areaRect);
-            WLOGFI("area rect after tranform: [%{public}d, %{public}d, %{public}u, %{public}u]",
-                areaRect.posX_, areaRect.posY_, areaRect.width_, areaRect.height_);
-        }
-        MMI::WindowInfo windowInfo = {
-            .id = static_cast<int32_t>(windowNode->GetWindowId()),
-            .pid = windowNode->GetInputEventCallingPid(),
-            .uid = windowNode->GetCallingUid(),
-            .area = MMI::Rect { areaRect.posX_, areaRect.posY_,
-                static_cast<int32_t>(areaRect.width_), static_cast<int32_t>(areaRect.height_) },
-            .agentWindowId = static_cast<int32_t>(windowNode->GetWindowId()),
-        };
-
+        bool isRebuilt = false;
+        const MMI::WindowInfo& cachedInfo = GetCachedWindowInfo(windowNode, isRebuilt);
+        int32_t pid = cachedInfo.pid;
+        int32_t uid = cachedInfo.uid;
+        int32_t agentWindowId = cachedInfo.agentWindowId;
         auto iter = (windowNode->GetParentId() == INVALID_WINDOW_ID) ?
             dialogWindowMap.find(windowNode->GetWindowId()) : dialogWindowMap.find(windowNode->GetParentId());
         if (iter != dialogWindowMap.end()) {
-            windowInfo.pid = iter->second->GetCallingPid();
-            windowInfo.uid = iter->second->GetCallingUid();
-            windowInfo.agentWindowId = static_cast<int32_t>(iter->second->GetWindowId());
+            pid = iter->second->GetCallingPid();
+            uid = iter->second->GetCallingUid();
+            agentWindowId = static_cast<int32_t>(iter->second->GetWindowId());
+        }
+        // clean windows which still sit at the same slot with the same dialog caller need no copy nor compare
+        if (!isRebuilt && index < windowsInfo.size() && windowsInfo[index].id == cachedInfo.id &&
+            windowsInfo[index].pid == pid && windowsInfo[index].uid == uid &&
+            windowsInfo[index].agentWindowId == agentWindowId) {
+            index++;
+            continue;
+        }
+        MMI::WindowInfo windowInfo = cachedInfo;
+        windowInfo.pid = pid;
+        windowInfo.uid = uid;
+        windowInfo.agentWindowId = agentWindowId;
+        // patch the persistent array in place, so unchanged windows neither reallocate nor trigger a push
+        if (index < windowsInfo.size()) {
+            if (!IsSameWindowInfo(windowsInfo[index], windowInfo)) {
+                windowsInfo[index] = std::move(windowInfo);
+                isChanged = true;
+            }
+        } else {
+            windowsInfo.emplace_back(std::move(windowInfo));
+            isChanged = true;
+        }
+        index++;
+    }
+    if (index < windowsInfo.size()) {
+        windowsInfo.resize(index);
+        isChanged = true;
+    }
+    PruneWindowInfoCache();
+    return isChanged;
+}
+
+const MMI::WindowInfo& InputWindowMonitor::GetCachedWindowInfo(const sptr<WindowNode>& windowNode, bool& isRebuilt)
+{
+    auto& cacheItem = windowInfoCache_[windowNode->GetWindowId()];
+    // hot areas and transforms are only recomputed for windows whose input related fields changed
+    if (cacheItem.updateSeq == 0 || windowNode->isInputInfoDirty_) {
+        cacheItem.windowInfo = {};
+        BuildWindowInfo(windowNode, cacheItem.windowInfo);
+        windowNode->isInputInfoDirty_ = false;
+        isRebuilt = true;
+    }
+    cacheItem.updateSeq = updateSeq_;
+    return cacheItem.windowInfo;
+}
+
+void InputWindowMonitor::PruneWindowInfoCache()
+{
+    // windows of other containers are not visited by this update, only drop the ones which are gone
+    for (auto iter = windowInfoCache_.begin(); iter != windowInfoCache_.end();) {
+        if (iter->second.updateSeq != updateSeq_ && windowRoot_->GetWindowNode(iter->first) == nullptr) {
+            iter = windowInfoCache_.erase(iter);
+        } else {
+            ++iter;
         }
-        convertRectsToMmiRects(touchHotAreas, windowInfo.defaultHotAreas);
-        convertRectsToMmiRects(touchHotAreas, windowInfo.pointerHotAreas);
-        if (!windowNode->GetWindowProperty()->GetTouchable()) {
-            WLOGFI("window is not touchable: %{public}u", windowNode->GetWindowId());
-            windowInfo.flags |= MMI::WindowInfo::FLAG_BIT_UNTOUCHABLE;
+    }
+}
+
+void InputWindowMonitor::BuildWindowInfo(const sptr<WindowNode>& windowNode, MMI::WindowInfo& windowInfo)
+{
+    std::vector<Rect> touchHotAreas;
+    windowNode->GetTouchHotAreas(touchHotAreas);
+    Rect areaRect = windowNode->GetWindowRect();
+    if (windowNode->GetWindowProperty()->GetTransform() != Transform::Identity()) {
+        windowNode->ComputeTransform();
+        for (Rect& rect : touchHotAreas) {
+            rect = WindowHelper::TransformRect(windowNode->GetWindowProperty()->GetTransformMat(), rect);
         }
-        windowsInfo.emplace_back(windowInfo);
+        WLOGFD("area rect befoe tranform: [%{public}d, %{public}d, %{public}u, %{public}u]",
+            areaRect.posX_, areaRect.posY_, areaRect.width_, areaRect.height_);
+        areaRect = WindowHelper::TransformRect(windowNode->GetWindowProperty()->GetTransformMat(), areaRect);
+        WLOGFD("area rect after tranform: [%{public}d, %{public}d, %{public}u, %{public}u]",
+            areaRect.posX_, areaRect.posY_, areaRect.width_, areaRect.height_);
+    }
+    windowInfo.id = static_cast<int32_t>(windowNode->GetWindowId());
+    windowInfo.pid = windowNode->GetInputEventCallingPid();
+    windowInfo.uid = windowNode->GetCallingUid();
+    windowInfo.area = MMI::Rect { areaRect.posX_, areaRect.posY_,
+        static_cast<int32_t>(areaRect.width_), static_cast<int32_t>(areaRect.height_) };
+    windowInfo.agentWindowId = static_cast<int32_t>(windowNode->GetWindowId());
+    convertRectsToMmiRects(touchHotAreas, windowInfo.defaultHotAreas);
+    convertRectsToMmiRects(touchHotAreas, windowInfo.pointerHotAreas);
+    if (!windowNode->GetWindowProperty()->GetTouchable()) {
+        WLOGFD("window is not touchable: %{public}u", windowNode->GetWindowId());
+        windowInfo.flags |= MMI::WindowInfo::FLAG_BIT_UNTOUCHABLE;
     }
 }
 
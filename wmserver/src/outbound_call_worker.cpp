@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "outbound_call_worker.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <hitrace_meter.h>
+#include <sstream>
+
+#include "window_manager_hilog.h"
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "OutboundCallWorker"};
+    const std::string OUTBOUND_CALL_THREAD_NAME = "WmsOutboundCall";
+    constexpr int64_t SLOW_CALL_THRESHOLD_US = 100000; // 100ms
+    const std::map<OutboundCallTarget, std::string> TARGET_NAME_MAP {
+        { OutboundCallTarget::BRIGHTNESS,          "brightness" },
+        { OutboundCallTarget::RUNNING_LOCK,        "runningLock" },
+        { OutboundCallTarget::POWER_STATE,         "powerState" },
+        { OutboundCallTarget::INPUT_DISPLAY_INFO,  "inputDisplayInfo" },
+        { OutboundCallTarget::DISPLAY_ORIENTATION, "displayOrientation" },
+    };
+
+    std::string GetTargetName(OutboundCallTarget target)
+    {
+        auto iter = TARGET_NAME_MAP.find(target);
+        return (iter == TARGET_NAME_MAP.end()) ? "unknown" : iter->second;
+    }
+}
+WM_IMPLEMENT_SINGLE_INSTANCE(OutboundCallWorker)
+
+void OutboundCallWorker::PostCall(OutboundCallTarget target, uint64_t key, std::function<void()>&& call)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto indexIter = pendingIndex_.find({ target, key });
+    if (indexIter != pendingIndex_.end()) {
+        // keeps the place of the pending call, so calls of other targets posted after it still run after it
+        indexIter->second->call_ = std::move(call);
+        statistics_[target].coalescedCount_++;
+        return;
+    }
+    auto callIter = pendingCalls_.insert(pendingCalls_.end(),
+        { target, key, std::move(call), std::chrono::steady_clock::now() });
+    pendingIndex_[{ target, key }] = callIter;
+    if (isDraining_) {
+        return;
+    }
+    if (handler_ == nullptr) {
+        handler_ = std::make_shared<AppExecFwk::EventHandler>(
+            AppExecFwk::EventRunner::Create(OUTBOUND_CALL_THREAD_NAME));
+    }
+    isDraining_ = handler_->PostTask([this]() { Drain(); }, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+    if (!isDraining_) {
+        WLOGFE("post outbound call task failed, target: %{public}s", GetTargetName(target).c_str());
+    }
+}
+
+void OutboundCallWorker::Drain()
+{
+    while (true) {
+        PendingCall pendingCall;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pendingCalls_.empty()) {
+                isDraining_ = false;
+                return;
+            }
+            pendingCall = std::move(pendingCalls_.front());
+            pendingIndex_.erase({ pendingCall.target_, pendingCall.key_ });
+            pendingCalls_.pop_front();
+        }
+        std::string targetName = GetTargetName(pendingCall.target_);
+        auto startTime = std::chrono::steady_clock::now();
+        {
+            HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:OutboundCall(%s)", targetName.c_str());
+            pendingCall.call_();
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        int64_t waitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            startTime - pendingCall.postTime_).count();
+        int64_t callTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+        if (callTime > SLOW_CALL_THRESHOLD_US) {
+            WLOGFW("slow outbound call, target: %{public}s, cost: %{public}" PRId64"us",
+                targetName.c_str(), callTime);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        TargetStatistics& statistics = statistics_[pendingCall.target_];
+        statistics.callCount_++;
+        statistics.totalWaitTime_ += waitTime;
+        statistics.maxWaitTime_ = std::max(statistics.maxWaitTime_, waitTime);
+        statistics.totalCallTime_ += callTime;
+        statistics.maxCallTime_ = std::max(statistics.maxCallTime_, callTime);
+    }
+}
+
+void OutboundCallWorker::Dump(std::string& dumpInfo)
+{
+    std::ostringstream oss;
+    oss << "Outbound calls: " << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    oss << "  pending: " << pendingCalls_.size() << std::endl;
+    for (const auto& [target, statistics] : statistics_) {
+        int64_t callCount = static_cast<int64_t>(statistics.callCount_);
+        oss << "  " << GetTargetName(target)
+            << ": calls: " << statistics.callCount_
+            << ", coalesced: " << statistics.coalescedCount_
+            << ", avgWait(us): " << (callCount == 0 ? 0 : statistics.totalWaitTime_ / callCount)
+            << ", maxWait(us): " << statistics.maxWaitTime_
+            << ", avgCall(us): " << (callCount == 0 ? 0 : statistics.totalCallTime_ / callCount)
+            << ", maxCall(us): " << statistics.maxCallTime_ << std::endl;
+    }
+    dumpInfo.append(oss.str());
+}
+} // namespace Rosen
+} // namespace OHOS
@@ -25,6 +25,7 @@
 #include <sstream>
 
 #include "minimize_app.h"
+#include "outbound_call_worker.h"
 #include "remote_animation.h"
 #include "starting_window.h"
 #include "window_inner_manager.h"
@@ -37,6 +38,7 @@ namespace Rosen {
 namespace {
     constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WindowController"};
     constexpr uint32_t TOUCH_HOT_AREA_MAX_NUM = 10;
+    constexpr uint32_t REPORT_MOVE_DRAG_FRAMES = 300;
 }
 
 uint32_t WindowController::GenWindowId()
@@ -345,14 +347,19 @@ void WindowController::HandleTurnScreenOn(const sptr<WindowNode>& node)
         return;
     }
     WLOGFI("handle turn screen on: [%{public}s, %{public}d]", node->GetWindowName().c_str(), node->IsTurnScreenOn());
-    // reset ipc identity
-    std::string identity = IPCSkeleton::ResetCallingIdentity();
-    if (node->IsTurnScreenOn() && !PowerMgr::PowerMgrClient::GetInstance().IsScreenOn()) {
-        WLOGFI("turn screen on");
-        PowerMgr::PowerMgrClient::GetInstance().WakeupDevice();
+    if (!node->IsTurnScreenOn()) {
+        return;
     }
-    // set ipc identity to raw
-    IPCSkeleton::SetCallingIdentity(identity);
+    OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::POWER_STATE, 0, []() {
+        // reset ipc identity
+        std::string identity = IPCSkeleton::ResetCallingIdentity();
+        if (!PowerMgr::PowerMgrClient::GetInstance().IsScreenOn()) {
+            WLOGFI("turn screen on");
+            PowerMgr::PowerMgrClient::GetInstance().WakeupDevice();
+        }
+        // set ipc identity to raw
+        IPCSkeleton::SetCallingIdentity(identity);
+    });
 }
 
 WMError WindowController::RemoveWindowNode(uint32_t windowId)
@@ -439,7 +446,7 @@ WMError WindowController::ResizeRect(uint32_t windowId, const Rect& rect, Window
         newRect = rect;
     }
     property->SetRequestRect(newRect);
-    WMError res = windowRoot_->UpdateWindowNode(windowId, WindowUpdateReason::UPDATE_RECT);
+    WMError res = UpdateWindowNodeLayout(windowId, WindowUpdateReason::UPDATE_RECT);
     if (res != WMError::WM_OK) {
         return res;
     }
@@ -496,6 +503,7 @@ void WindowController::NotifyDisplayStateChange(DisplayId defaultDisplayId, sptr
         }
         case DisplayStateChangeType::DESTROY: {
             windowRoot_->ProcessDisplayDestroy(defaultDisplayId, displayInfo, displayInfoMap);
+            inputWindowMonitor_->RemoveDisplayInfo(displayInfo->GetDisplayId());
             break;
         }
         case DisplayStateChangeType::SIZE_CHANGE:
@@ -556,7 +564,8 @@ void WindowController::ProcessDisplayChange(DisplayId defaultDisplayId, sptr<Dis
             return;
         }
     }
-    FlushWindowInfoWithDisplayId(displayId);
+    // display changes are synchronized with DMS and RS, so commit them right away
+    FlushWindowInfoWithDisplayId(displayId, true);
     if (windowNodeContainer != nullptr) {
         windowNodeContainer->ProcessWindowAvoidAreaChangeWhenDisplayChange();
     }
@@ -622,7 +631,7 @@ WMError WindowController::SetWindowFlags(uint32_t windowId, uint32_t flags)
     if ((oldFlags ^ flags) == static_cast<uint32_t>(WindowFlag::WINDOW_FLAG_FORBID_SPLIT_MOVE)) {
         return WMError::WM_OK;
     }
-    WMError res = windowRoot_->UpdateWindowNode(windowId, WindowUpdateReason::UPDATE_FLAGS);
+    WMError res = UpdateWindowNodeLayout(windowId, WindowUpdateReason::UPDATE_FLAGS);
     if (res != WMError::WM_OK) {
         return res;
     }
@@ -639,7 +648,7 @@ WMError WindowController::SetSystemBarProperty(uint32_t windowId, WindowType typ
         return WMError::WM_ERROR_NULLPTR;
     }
     node->SetSystemBarProperty(type, property);
-    WMError res = windowRoot_->UpdateWindowNode(windowId, WindowUpdateReason::UPDATE_OTHER_PROPS);
+    WMError res = UpdateWindowNodeLayout(windowId, WindowUpdateReason::UPDATE_OTHER_PROPS);
     if (res != WMError::WM_OK) {
         return res;
     }
@@ -720,6 +729,7 @@ WMError WindowController::ProcessPointUp(uint32_t windowId)
         WLOGFW("could not find window");
         return WMError::WM_ERROR_NULLPTR;
     }
+    FinishMoveOrDrag(windowId);
     if (node->GetWindowType() == WindowType::WINDOW_TYPE_DOCK_SLICE) {
         DisplayId displayId = node->GetDisplayId();
         if (windowRoot_->IsDockSliceInExitSplitModeArea(displayId)) {
@@ -779,6 +789,7 @@ WMError WindowController::NotifyWindowClientPointUp(uint32_t windowId,
         WLOGFW("could not find window");
         return WMError::WM_ERROR_NULLPTR;
     }
+    FinishMoveOrDrag(windowId);
     if (node->GetWindowToken() != nullptr) {
         WLOGFI("notify client when receive point_up event, windowId: %{public}u", windowId);
         node->GetWindowToken()->NotifyWindowClientPointUp(pointerEvent);
@@ -786,6 +797,103 @@ WMError WindowController::NotifyWindowClientPointUp(uint32_t windowId,
     return WMError::WM_OK;
 }
 
+WMError WindowController::UpdateMoveOrDragRect(const sptr<WindowProperty>& property, int64_t pointerTime)
+{
+    uint32_t windowId = property->GetWindowId();
+    auto node = windowRoot_->GetWindowNode(windowId);
+    if (node == nullptr) {
+        WLOGFE("could not find window");
+        return WMError::WM_ERROR_NULLPTR;
+    }
+    if (moveDragWindowId_ != windowId) {
+        FinishMoveOrDrag(moveDragWindowId_);
+        moveDragWindowId_ = windowId;
+    }
+    WMError res = WMError::WM_ERROR_INVALID_OPERATION;
+    if (property->GetWindowSizeChangeReason() == WindowSizeChangeReason::MOVE) {
+        node->SetWindowSizeChangeReason(WindowSizeChangeReason::MOVE);
+        res = windowRoot_->MoveWindowNode(windowId, property->GetRequestRect());
+    }
+    if (res == WMError::WM_OK) {
+        isMoveLayoutDeferred_ = true;
+        FlushWindowInfo(windowId);
+    } else {
+        // resizing changes the content size, so the client still has to be laid out on every frame
+        res = UpdatePropertyByAction(node, property, PropertyChangeAction::ACTION_UPDATE_RECT);
+        if (res == WMError::WM_OK) {
+            UpdateCallingWindowRestoringRect(node, property->GetWindowSizeChangeReason());
+        }
+    }
+    if (res == WMError::WM_OK && pointerTime > 0) {
+        pendingMoveDragPointerTimes_.push_back(pointerTime);
+    }
+    return res;
+}
+
+void WindowController::FinishMoveOrDrag(uint32_t windowId)
+{
+    if (windowId == INVALID_WINDOW_ID || moveDragWindowId_ != windowId) {
+        return;
+    }
+    moveDragWindowId_ = INVALID_WINDOW_ID;
+    bool isMoveLayoutDeferred = isMoveLayoutDeferred_;
+    isMoveLayoutDeferred_ = false;
+    auto node = windowRoot_->GetWindowNode(windowId);
+    if (node == nullptr) {
+        return;
+    }
+    if (isMoveLayoutDeferred) {
+        // the request rect already holds the last position, the full layout notifies the client of it
+        node->SetWindowSizeChangeReason(WindowSizeChangeReason::MOVE);
+        if (windowRoot_->UpdateWindowNode(windowId, WindowUpdateReason::UPDATE_RECT) == WMError::WM_OK) {
+            FlushWindowInfo(windowId);
+            UpdateCallingWindowRestoringRect(node, WindowSizeChangeReason::MOVE);
+        }
+    }
+    accessibilityConnection_->NotifyAccessibilityInfo(node, WindowUpdateType::WINDOW_UPDATE_PROPERTY);
+}
+
+void WindowController::RecordMoveDragLatencyEvent(int64_t latency)
+{
+    WLOGFD("move or drag frame latency(us): %{public}" PRId64"", latency);
+    moveDragLatencyConfig_.frameTimes_++;
+    if (latency <= 8000) { // 8000: means latency is 8ms
+        moveDragLatencyConfig_.below8msTimes_++;
+    } else if (latency <= 16000) { // 16000: means latency is 16ms
+        moveDragLatencyConfig_.below16msTimes_++;
+    } else if (latency <= 33000) { // 33000: means latency is 33ms
+        moveDragLatencyConfig_.below33msTimes_++;
+    } else if (latency <= 50000) { // 50000: means latency is 50ms
+        moveDragLatencyConfig_.below50msTimes_++;
+    } else {
+        moveDragLatencyConfig_.above50msTimes_++;
+    }
+    if (moveDragLatencyConfig_.frameTimes_ < REPORT_MOVE_DRAG_FRAMES) {
+        return;
+    }
+    std::ostringstream oss;
+    oss << "move drag frames: " << "BELOW8(ms): " << moveDragLatencyConfig_.below8msTimes_
+        << ", BELOW16(ms): " << moveDragLatencyConfig_.below16msTimes_
+        << ", BELOW33(ms): " << moveDragLatencyConfig_.below33msTimes_
+        << ", BELOW50(ms): " << moveDragLatencyConfig_.below50msTimes_
+        << ", ABOVE50(ms): " << moveDragLatencyConfig_.above50msTimes_ << ";";
+    int32_t ret = OHOS::HiviewDFX::HiSysEvent::Write(
+        OHOS::HiviewDFX::HiSysEvent::Domain::WINDOW_MANAGER,
+        "MOVE_DRAG_LATENCY",
+        OHOS::HiviewDFX::HiSysEvent::EventType::STATISTIC,
+        "MSG", oss.str());
+    if (ret != 0) {
+        WLOGFE("Write HiSysEvent error, ret:%{public}d", ret);
+        return;
+    }
+    moveDragLatencyConfig_.frameTimes_ = 0;
+    moveDragLatencyConfig_.below8msTimes_ = 0;
+    moveDragLatencyConfig_.below16msTimes_ = 0;
+    moveDragLatencyConfig_.below33msTimes_ = 0;
+    moveDragLatencyConfig_.below50msTimes_ = 0;
+    moveDragLatencyConfig_.above50msTimes_ = 0;
+}
+
 void WindowController::MinimizeAllAppWindows(DisplayId displayId)
 {
     windowRoot_->MinimizeAllAppWindows(displayId);
@@ -807,18 +915,74 @@ WMError WindowController::GetTopWindowId(uint32_t mainWinId, uint32_t& topWinId)
     return windowRoot_->GetTopWindowId(mainWinId, topWinId);
 }
 
-void WindowController::FlushWindowInfo(uint32_t windowId)
+void WindowController::SetEventHandler(const std::shared_ptr<AppExecFwk::EventHandler>& handler)
 {
-    WLOGFI("FlushWindowInfo");
-    RSTransaction::FlushImplicitTransaction();
+    handler_ = handler;
+}
+
+void WindowController::SetRsTransactionFlusher(const std::function<void()>& flusher)
+{
+    rsTransactionFlusher_ = flusher;
+}
+
+void WindowController::FlushWindowInfo(uint32_t windowId, bool isSync)
+{
+    WLOGFD("FlushWindowInfo");
     inputWindowMonitor_->UpdateInputWindow(windowId);
+    RequestCommit(isSync);
 }
 
-void WindowController::FlushWindowInfoWithDisplayId(DisplayId displayId)
+void WindowController::FlushWindowInfoWithDisplayId(DisplayId displayId, bool isSync)
 {
-    WLOGFI("FlushWindowInfoWithDisplayId");
-    RSTransaction::FlushImplicitTransaction();
+    WLOGFD("FlushWindowInfoWithDisplayId");
     inputWindowMonitor_->UpdateInputWindowByDisplayId(displayId);
+    RequestCommit(isSync);
+}
+
+void WindowController::RequestCommit(bool isSync)
+{
+    if (isSync || handler_ == nullptr) {
+        CommitPendingChanges();
+        return;
+    }
+    if (isCommitTaskPosted_) {
+        return;
+    }
+    wptr<WindowController> weak = this;
+    auto task = [weak]() {
+        auto controller = weak.promote();
+        if (controller == nullptr) {
+            return;
+        }
+        controller->CommitPendingChanges();
+    };
+    isCommitTaskPosted_ = handler_->PostTask(task, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+    if (!isCommitTaskPosted_) {
+        WLOGFE("post commit task failed");
+        CommitPendingChanges();
+    }
+}
+
+void WindowController::CommitPendingChanges()
+{
+    HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:CommitPendingChanges");
+    isCommitTaskPosted_ = false;
+    if (rsTransactionFlusher_ != nullptr) {
+        rsTransactionFlusher_();
+    } else {
+        RSTransaction::FlushImplicitTransaction();
+    }
+    inputWindowMonitor_->FlushPendingInputWindow();
+    if (pendingMoveDragPointerTimes_.empty()) {
+        return;
+    }
+    // pointer action time is CLOCK_MONOTONIC in microseconds, as the steady clock here
+    int64_t commitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    for (auto pointerTime : pendingMoveDragPointerTimes_) {
+        RecordMoveDragLatencyEvent(commitTime - pointerTime);
+    }
+    pendingMoveDragPointerTimes_.clear();
 }
 
 void WindowController::UpdateWindowAnimation(const sptr<WindowNode>& node)
@@ -883,6 +1047,47 @@ WMError WindowController::UpdateProperty(sptr<WindowProperty>& property, Propert
     }
     WLOGFI("window: [%{public}s, %{public}u] update property for action: %{public}u", node->GetWindowName().c_str(),
         node->GetWindowId(), static_cast<uint32_t>(action));
+    uint32_t actions = static_cast<uint32_t>(action);
+    // all actions of one request are applied with a single relayout, the first failure is reported
+    deferredLayoutWindowId_ = windowId;
+    WMError ret = WMError::WM_OK;
+    WMError rectRet = WMError::WM_DO_NOTHING;
+    for (uint32_t bit = 1; bit != 0 && bit <= actions; bit <<= 1) {
+        if ((actions & bit) == 0) {
+            continue;
+        }
+        WMError res = UpdatePropertyByAction(node, property, static_cast<PropertyChangeAction>(bit));
+        if (bit == static_cast<uint32_t>(PropertyChangeAction::ACTION_UPDATE_RECT)) {
+            rectRet = res;
+        }
+        if (ret == WMError::WM_OK) {
+            ret = res;
+        }
+    }
+    deferredLayoutWindowId_ = INVALID_WINDOW_ID;
+    if (hasDeferredLayout_) {
+        hasDeferredLayout_ = false;
+        WMError res = windowRoot_->UpdateWindowNode(windowId, deferredLayoutReason_);
+        if (res == WMError::WM_OK) {
+            FlushWindowInfo(windowId);
+        } else {
+            rectRet = (rectRet == WMError::WM_OK) ? res : rectRet;
+            ret = (ret == WMError::WM_OK) ? res : ret;
+        }
+    }
+    if (rectRet == WMError::WM_OK) {
+        UpdateCallingWindowRestoringRect(node, property->GetWindowSizeChangeReason());
+    }
+    if (ret == WMError::WM_OK) {
+        accessibilityConnection_->NotifyAccessibilityInfo(node, WindowUpdateType::WINDOW_UPDATE_PROPERTY);
+    }
+    return ret;
+}
+
+WMError WindowController::UpdatePropertyByAction(const sptr<WindowNode>& node, const sptr<WindowProperty>& property,
+    PropertyChangeAction action)
+{
+    uint32_t windowId = node->GetWindowId();
     WMError ret = WMError::WM_OK;
     switch (action) {
         case PropertyChangeAction::ACTION_UPDATE_RECT: {
@@ -890,17 +1095,6 @@ WMError WindowController::UpdateProperty(sptr<WindowProperty>& property, Propert
             node->SetOriginRect(property->GetOriginRect());
             node->SetDragType(property->GetDragType());
             ret = ResizeRect(windowId, property->GetRequestRect(), property->GetWindowSizeChangeReason());
-            if (node->GetWindowMode() == WindowMode::WINDOW_MODE_FLOATING && ret == WMError::WM_OK &&
-                callingWindowId_ != 0u && !WindowHelper::IsEmptyRect(callingWindowRestoringRect_)) {
-                if (property->GetWindowSizeChangeReason() != WindowSizeChangeReason::MOVE) {
-                    callingWindowId_ = 0u;
-                    callingWindowRestoringRect_ = { 0, 0, 0, 0 };
-                } else {
-                    auto windowRect = node->GetWindowRect();
-                    callingWindowRestoringRect_.posX_ = windowRect.posX_;
-                    callingWindowRestoringRect_.posY_ = windowRect.posY_;
-                }
-            }
             break;
         }
         case PropertyChangeAction::ACTION_UPDATE_MODE: {
@@ -936,8 +1130,7 @@ WMError WindowController::UpdateProperty(sptr<WindowProperty>& property, Propert
         case PropertyChangeAction::ACTION_UPDATE_ORIENTATION: {
             node->SetRequestedOrientation(property->GetRequestedOrientation());
             if (WindowHelper::IsRotatableWindow(node->GetWindowType(), node->GetWindowMode())) {
-                DisplayManagerServiceInner::GetInstance().
-                    SetOrientationFromWindow(node->GetDisplayId(), property->GetRequestedOrientation());
+                windowRoot_->SetOrientationFromWindow(node);
             }
             break;
         }
@@ -984,18 +1177,93 @@ WMError WindowController::UpdateProperty(sptr<WindowProperty>& property, Propert
         default:
             break;
     }
-    if (ret == WMError::WM_OK) {
-        accessibilityConnection_->NotifyAccessibilityInfo(node, WindowUpdateType::WINDOW_UPDATE_PROPERTY);
-    }
     return ret;
 }
 
+WMError WindowController::UpdateWindowNodeLayout(uint32_t windowId, WindowUpdateReason reason)
+{
+    if (windowId != deferredLayoutWindowId_) {
+        return windowRoot_->UpdateWindowNode(windowId, reason);
+    }
+    // a reason that may switch the layout policy back to cascade wins over one that may not
+    if (!hasDeferredLayout_ || (WindowHelper::IsSwitchCascadeReason(reason) &&
+        !WindowHelper::IsSwitchCascadeReason(deferredLayoutReason_))) {
+        deferredLayoutReason_ = reason;
+    }
+    hasDeferredLayout_ = true;
+    return WMError::WM_OK;
+}
+
+void WindowController::UpdateCallingWindowRestoringRect(const sptr<WindowNode>& node, WindowSizeChangeReason reason)
+{
+    if (node->GetWindowMode() != WindowMode::WINDOW_MODE_FLOATING || callingWindowId_ == 0u ||
+        WindowHelper::IsEmptyRect(callingWindowRestoringRect_)) {
+        return;
+    }
+    if (reason != WindowSizeChangeReason::MOVE) {
+        callingWindowId_ = 0u;
+        callingWindowRestoringRect_ = { 0, 0, 0, 0 };
+    } else {
+        auto windowRect = node->GetWindowRect();
+        callingWindowRestoringRect_.posX_ = windowRect.posX_;
+        callingWindowRestoringRect_.posY_ = windowRect.posY_;
+    }
+}
+
 WMError WindowController::GetAccessibilityWindowInfo(sptr<AccessibilityWindowInfo>& windowInfo) const
 {
     accessibilityConnection_->GetAccessibilityWindowInfo(windowInfo);
     return WMError::WM_OK;
 }
 
+std::shared_ptr<const WindowReadModel> WindowController::CreateReadModel(const ModeChangeHotZonesConfig& config)
+{
+    HITRACE_METER(HITRACE_TAG_WINDOW_MANAGER);
+    auto readModel = std::make_shared<WindowReadModel>();
+    windowRoot_->GetWindowReadInfos(readModel->windowInfos_);
+    if (config.isModeChangeHotZoneConfigured_) {
+        for (auto displayId : windowRoot_->GetAllDisplayIds()) {
+            ModeChangeHotZones hotZones;
+            if (windowRoot_->GetModeChangeHotZones(displayId, hotZones, config) == WMError::WM_OK) {
+                readModel->hotZones_[displayId] = hotZones;
+            }
+        }
+    }
+    sptr<AccessibilityWindowInfo> accessibilityWindowInfo = new (std::nothrow) AccessibilityWindowInfo();
+    if (accessibilityWindowInfo != nullptr) {
+        accessibilityConnection_->GetAccessibilityWindowInfo(accessibilityWindowInfo);
+        readModel->accessibilityWindowList_ = std::move(accessibilityWindowInfo->windowList_);
+    }
+    return readModel;
+}
+
+std::shared_ptr<const WindowReadModel> WindowController::UpdateReadModel(
+    const std::shared_ptr<const WindowReadModel>& readModel, const std::unordered_set<uint32_t>& windowIds,
+    const ModeChangeHotZonesConfig& config)
+{
+    HITRACE_METER(HITRACE_TAG_WINDOW_MANAGER);
+    std::vector<uint32_t> updateIds;
+    for (auto windowId : windowIds) {
+        auto node = windowRoot_->GetWindowNode(windowId);
+        if (node != nullptr && WindowHelper::IsOverlayWindow(node->GetWindowType())) {
+            // bars and the keyboard change the avoid areas of other windows
+            return CreateReadModel(config);
+        }
+        updateIds.push_back(windowId);
+        if (node != nullptr) {
+            for (auto& child : node->children_) {
+                updateIds.push_back(child->GetWindowId());
+            }
+        }
+    }
+    auto newModel = std::make_shared<WindowReadModel>(*readModel);
+    for (auto windowId : updateIds) {
+        windowRoot_->UpdateWindowReadInfo(windowId, newModel->windowInfos_);
+        accessibilityConnection_->UpdateAccessibilityWindowInfo(windowId, newModel->accessibilityWindowList_);
+    }
+    return newModel;
+}
+
 WMError WindowController::GetModeChangeHotZones(DisplayId displayId,
     ModeChangeHotZones& hotZones, const ModeChangeHotZonesConfig& config)
 {
@@ -1038,7 +1306,7 @@ WMError WindowController::UpdateTouchHotAreas(const sptr<WindowNode>& node, cons
 
 WMError WindowController::UpdateTransform(uint32_t windowId)
 {
-    WMError res = windowRoot_->UpdateWindowNode(windowId, WindowUpdateReason::UPDATE_TRANSFORM);
+    WMError res = UpdateWindowNodeLayout(windowId, WindowUpdateReason::UPDATE_TRANSFORM);
     if (res != WMError::WM_OK) {
         return res;
     }
@@ -1151,7 +1419,7 @@ WMError WindowController::BindDialogTarget(uint32_t& windowId, sptr<IRemoteObjec
     if (windowRoot_->CheckMultiDialogWindows(node->GetWindowType(), targetToken)) {
         return WMError::WM_ERROR_INVALID_WINDOW;
     }
-    node->dialogTargetToken_ = targetToken;
+    windowRoot_->BindDialogTarget(node, targetToken);
     return WMError::WM_OK;
 }
 } // namespace OHOS
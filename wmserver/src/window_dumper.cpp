@@ -22,8 +22,10 @@
 #include <sstream>
 
 #include "display_manager_service_inner.h"
+#include "outbound_call_worker.h"
 #include "string_ex.h"
 #include "unique_fd.h"
+#include "window_manager_agent_controller.h"
 #include "window_manager_hilog.h"
 #include "window_manager_service.h"
 #include "wm_common.h"
@@ -145,6 +147,9 @@ WMError WindowDumper::DumpAllWindowInfo(std::string& dumpInfo) const
             return ret;
         }
     }
+    WindowManagerAgentController::GetInstance().DumpAgentInfo(dumpInfo);
+    OutboundCallWorker::GetInstance().Dump(dumpInfo);
+    WindowManagerService::GetInstance().DumpTaskClassInfo(dumpInfo);
     return WMError::WM_OK;
 }
 
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "window_hit_test_index.h"
+
+#include <algorithm>
+
+#include "window_helper.h"
+#include "window_manager_hilog.h"
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WindowHitTestIndex"};
+    constexpr int64_t HIT_TEST_CELL_SIZE = 256;
+    constexpr int64_t MAX_CELLS_PER_WINDOW = 256;
+}
+
+void WindowHitTestIndex::AddWindowNode(const sptr<WindowNode>& node)
+{
+    if (node == nullptr) {
+        return;
+    }
+    uint32_t windowId = node->GetWindowId();
+    auto iter = entries_.find(windowId);
+    if (iter != entries_.end()) {
+        RemoveFromCells(windowId, iter->second);
+        entries_.erase(iter);
+    }
+    HitTestEntry& entry = entries_[windowId];
+    entry.node_ = node;
+    RefreshEntry(node, entry);
+    InsertIntoCells(windowId, entry);
+}
+
+void WindowHitTestIndex::RemoveWindowNode(const sptr<WindowNode>& node)
+{
+    if (node == nullptr) {
+        return;
+    }
+    uint32_t windowId = node->GetWindowId();
+    auto iter = entries_.find(windowId);
+    if (iter == entries_.end()) {
+        return;
+    }
+    RemoveFromCells(windowId, iter->second);
+    entries_.erase(iter);
+}
+
+void WindowHitTestIndex::UpdateWindowNode(const sptr<WindowNode>& node)
+{
+    if (node == nullptr) {
+        return;
+    }
+    uint32_t windowId = node->GetWindowId();
+    auto iter = entries_.find(windowId);
+    if (iter == entries_.end() || iter->second.node_ != node) {
+        return;
+    }
+    HitTestEntry& entry = iter->second;
+    if (entry.rect_ == node->GetWindowRect() && entry.transform_ == node->GetWindowProperty()->GetTransform()) {
+        return;
+    }
+    RemoveFromCells(windowId, entry);
+    RefreshEntry(node, entry);
+    InsertIntoCells(windowId, entry);
+}
+
+sptr<WindowNode> WindowHitTestIndex::HitTest(const PointInfo& point, const HitTestFilterFunc& filter) const
+{
+    sptr<WindowNode> hitNode = nullptr;
+    auto checkWindow = [this, &point, &filter, &hitNode](uint32_t windowId) {
+        auto iter = entries_.find(windowId);
+        if (iter == entries_.end()) {
+            return;
+        }
+        const HitTestEntry& entry = iter->second;
+        if (hitNode != nullptr && entry.node_->GetZOrder() <= hitNode->GetZOrder()) {
+            return;
+        }
+        if (!IsPointInEntry(entry, point) || (filter != nullptr && !filter(entry.node_))) {
+            return;
+        }
+        hitNode = entry.node_;
+    };
+    auto cellIter = cells_.find(GetCellKey(GetCellIndex(point.x), GetCellIndex(point.y)));
+    if (cellIter != cells_.end()) {
+        for (auto windowId : cellIter->second) {
+            checkWindow(windowId);
+        }
+    }
+    for (auto windowId : oversizedWindowIds_) {
+        checkWindow(windowId);
+    }
+    return hitNode;
+}
+
+void WindowHitTestIndex::RefreshEntry(const sptr<WindowNode>& node, HitTestEntry& entry)
+{
+    const auto& property = node->GetWindowProperty();
+    entry.rect_ = node->GetWindowRect();
+    entry.transform_ = property->GetTransform();
+    entry.isTransformed_ = (entry.transform_ != Transform::Identity());
+    entry.bounds_ = entry.rect_;
+    if (!entry.isTransformed_) {
+        return;
+    }
+    // the inverse matrix is computed once per layout instead of once per hit test
+    node->ComputeTransform();
+    entry.invertMat_ = property->GetTransformMat();
+    entry.invertMat_.Invert();
+    entry.plane_ = property->GetPlane();
+    entry.bounds_ = WindowHelper::TransformRect(property->GetTransformMat(), entry.rect_);
+}
+
+void WindowHitTestIndex::InsertIntoCells(uint32_t windowId, HitTestEntry& entry)
+{
+    entry.isOversized_ = false;
+    entry.cellLeft_ = 0;
+    entry.cellTop_ = 0;
+    entry.cellRight_ = -1;
+    entry.cellBottom_ = -1;
+    const Rect& bounds = entry.bounds_;
+    if (bounds.width_ == 0 || bounds.height_ == 0) {
+        return;
+    }
+    int64_t right = static_cast<int64_t>(bounds.posX_) + static_cast<int64_t>(bounds.width_) - 1;
+    int64_t bottom = static_cast<int64_t>(bounds.posY_) + static_cast<int64_t>(bounds.height_) - 1;
+    int32_t cellLeft = GetCellIndex(bounds.posX_);
+    int32_t cellTop = GetCellIndex(bounds.posY_);
+    int32_t cellRight = GetCellIndex(right);
+    int32_t cellBottom = GetCellIndex(bottom);
+    int64_t cellCount = (static_cast<int64_t>(cellRight) - cellLeft + 1) *
+        (static_cast<int64_t>(cellBottom) - cellTop + 1);
+    if (cellCount > MAX_CELLS_PER_WINDOW) {
+        WLOGFD("window covers %{public}" PRId64" cells, id: %{public}u", cellCount, windowId);
+        entry.isOversized_ = true;
+        oversizedWindowIds_.insert(windowId);
+        return;
+    }
+    entry.cellLeft_ = cellLeft;
+    entry.cellTop_ = cellTop;
+    entry.cellRight_ = cellRight;
+    entry.cellBottom_ = cellBottom;
+    for (int32_t cellX = cellLeft; cellX <= cellRight; ++cellX) {
+        for (int32_t cellY = cellTop; cellY <= cellBottom; ++cellY) {
+            cells_[GetCellKey(cellX, cellY)].push_back(windowId);
+        }
+    }
+}
+
+void WindowHitTestIndex::RemoveFromCells(uint32_t windowId, const HitTestEntry& entry)
+{
+    if (entry.isOversized_) {
+        oversizedWindowIds_.erase(windowId);
+        return;
+    }
+    for (int32_t cellX = entry.cellLeft_; cellX <= entry.cellRight_; ++cellX) {
+        for (int32_t cellY = entry.cellTop_; cellY <= entry.cellBottom_; ++cellY) {
+            auto iter = cells_.find(GetCellKey(cellX, cellY));
+            if (iter == cells_.end()) {
+                continue;
+            }
+            auto& windowIds = iter->second;
+            windowIds.erase(std::remove(windowIds.begin(), windowIds.end(), windowId), windowIds.end());
+            if (windowIds.empty()) {
+                cells_.erase(iter);
+            }
+        }
+    }
+}
+
+bool WindowHitTestIndex::IsPointInEntry(const HitTestEntry& entry, const PointInfo& point)
+{
+    if (!entry.isTransformed_) {
+        return WindowHelper::IsPointInTargetRect(point.x, point.y, entry.rect_);
+    }
+    if (!WindowHelper::IsPointInTargetRectWithBound(point.x, point.y, entry.bounds_)) {
+        return false;
+    }
+    // project the point back onto the window plane, then test it against the untransformed rect
+    TransformHelper::Vector3 pointAtPlane;
+    pointAtPlane.x_ = static_cast<float>(point.x);
+    pointAtPlane.y_ = static_cast<float>(point.y);
+    pointAtPlane.z_ = entry.plane_.ComponentZ(pointAtPlane.x_, pointAtPlane.y_);
+    TransformHelper::Vector3 originPos = TransformHelper::Transform(pointAtPlane, entry.invertMat_);
+    return WindowHelper::IsPointInTargetRect(static_cast<int32_t>(originPos.x_), static_cast<int32_t>(originPos.y_),
+        entry.rect_);
+}
+
+int32_t WindowHitTestIndex::GetCellIndex(int64_t pos)
+{
+    // floor division, window rects in the display group may start at negative coordinates
+    int64_t cell = (pos >= 0) ? (pos / HIT_TEST_CELL_SIZE) : -((-pos - 1) / HIT_TEST_CELL_SIZE) - 1;
+    return static_cast<int32_t>(cell);
+}
+
+uint64_t WindowHitTestIndex::GetCellKey(int32_t cellX, int32_t cellY)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY); // 32: y bits
+}
+} // namespace Rosen
+} // namespace OHOS
@@ -379,6 +379,24 @@ void WindowLayoutPolicy::UpdateWindowNode(const sptr<WindowNode>& node, bool isA
     }
 }
 
+bool WindowLayoutPolicy::MoveWindowNode(const sptr<WindowNode>& node, const Rect& requestRect)
+{
+    // windows that may cross displays, carry sub windows or are transformed depend on the rest of the layout
+    if (isMultiDisplay_ || !node->currentVisibility_ || !node->children_.empty() ||
+        !WindowHelper::IsMainFloatingWindow(node->GetWindowType(), node->GetWindowMode()) ||
+        node->GetWindowProperty()->GetTransform() != Transform::Identity()) {
+        return false;
+    }
+    const Rect lastWinRect = node->GetWindowRect();
+    Rect winRect = { requestRect.posX_, requestRect.posY_, lastWinRect.width_, lastWinRect.height_ };
+    node->SetRequestRect(winRect);
+    LimitWindowPositionWhenInitRectOrMove(node, winRect);
+    node->SetWindowRect(winRect);
+    CalcAndSetNodeHotZone(winRect, node);
+    UpdateSurfaceBounds(node, winRect, lastWinRect);
+    return true;
+}
+
 void WindowLayoutPolicy::UpdateFloatingLayoutRect(Rect& limitRect, Rect& winRect)
 {
     winRect.width_ = std::min(limitRect.width_, winRect.width_);
@@ -458,6 +476,15 @@ void WindowLayoutPolicy::CalcAndSetNodeHotZone(const Rect& winRect, const sptr<W
         }
     }
     node->SetTouchHotAreas(hotAreas);
+    // every layout pass ends here with the final window rect, keep hit testing in sync with it
+    if (hitTestIndex_ != nullptr) {
+        hitTestIndex_->UpdateWindowNode(node);
+    }
+}
+
+void WindowLayoutPolicy::SetHitTestIndex(const sptr<WindowHitTestIndex>& hitTestIndex)
+{
+    hitTestIndex_ = hitTestIndex;
 }
 
 void WindowLayoutPolicy::FixWindowSizeByRatioIfDragBeyondLimitRegion(const sptr<WindowNode>& node, Rect& winRect)
@@ -851,7 +878,7 @@ void WindowLayoutPolicy::LimitWindowPositionWhenInitRectOrMove(const sptr<Window
                                      winRect.posX_);
         }
     }
-    WLOGFI("After limit by position if init or move, winRect: %{public}d %{public}d %{public}u %{public}u",
+    WLOGFD("After limit by position if init or move, winRect: %{public}d %{public}d %{public}u %{public}u",
         winRect.posX_, winRect.posY_, winRect.width_, winRect.height_);
 }
 
@@ -24,9 +24,20 @@ namespace {
 }
 WM_IMPLEMENT_SINGLE_INSTANCE(WindowManagerAgentController)
 
+WindowManagerAgentController::WindowManagerAgentController()
+    : dispatcher_([this](const sptr<IWindowManagerAgent>& agent, const std::set<WindowManagerAgentType>& types) {
+        for (auto type : types) {
+            wmAgentContainer_.UnregisterAgent(agent, type);
+        }
+    })
+{
+}
+
 void WindowManagerAgentController::RegisterWindowManagerAgent(const sptr<IWindowManagerAgent>& windowManagerAgent,
     WindowManagerAgentType type)
 {
+    // an agent dropped for overflowing its queue gets a fresh one when it registers again
+    dispatcher_.ResetAgent(windowManagerAgent);
     wmAgentContainer_.RegisterAgent(windowManagerAgent, type);
 }
 
@@ -34,34 +45,52 @@ void WindowManagerAgentController::UnregisterWindowManagerAgent(const sptr<IWind
     WindowManagerAgentType type)
 {
     wmAgentContainer_.UnregisterAgent(windowManagerAgent, type);
+    dispatcher_.RemoveAgentType(windowManagerAgent, type);
 }
 
 void WindowManagerAgentController::UpdateFocusChangeInfo(const sptr<FocusChangeInfo>& focusChangeInfo, bool focused)
 {
     for (auto& agent : wmAgentContainer_.GetAgentsByType(WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_FOCUS)) {
-        agent->UpdateFocusChangeInfo(focusChangeInfo, focused);
+        // listeners pair every unfocus with an earlier focus of the same window, so only the focus of a window
+        // still pending and its unfocus cancel each other, every other change is delivered
+        dispatcher_.Dispatch(agent, { WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_FOCUS, false,
+            focusChangeInfo->displayId_, { focusChangeInfo->windowId_ },
+            [focusChangeInfo, focused](const sptr<IWindowManagerAgent>& target) {
+                target->UpdateFocusChangeInfo(focusChangeInfo, focused);
+            }, !focused });
     }
 }
 
 void WindowManagerAgentController::UpdateSystemBarRegionTints(DisplayId displayId, const SystemBarRegionTints& tints)
 {
-    WLOGFI("UpdateSystemBarRegionTints, tints size: %{public}u", static_cast<uint32_t>(tints.size()));
+    WLOGFD("UpdateSystemBarRegionTints, tints size: %{public}u", static_cast<uint32_t>(tints.size()));
     if (tints.empty()) {
         return;
     }
+    // tints may only carry some of the bars, so only a notification covering the same bars is superseded
+    std::set<uint32_t> tintTypes;
+    for (const auto& tint : tints) {
+        tintTypes.insert(static_cast<uint32_t>(tint.type_));
+    }
     for (auto& agent : wmAgentContainer_.GetAgentsByType(
         WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_SYSTEM_BAR)) {
-        agent->UpdateSystemBarRegionTints(displayId, tints);
+        dispatcher_.Dispatch(agent, { WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_SYSTEM_BAR, true, displayId,
+            tintTypes, [displayId, tints](const sptr<IWindowManagerAgent>& target) {
+                target->UpdateSystemBarRegionTints(displayId, tints);
+            } });
     }
 }
 
 void WindowManagerAgentController::NotifyAccessibilityWindowInfo(const sptr<AccessibilityWindowInfo>& windowInfo,
     WindowUpdateType type)
 {
-    WLOGFI("NotifyAccessibilityWindowInfo");
+    WLOGFD("NotifyAccessibilityWindowInfo");
     for (auto& agent : wmAgentContainer_.GetAgentsByType(
         WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_WINDOW_UPDATE)) {
-        agent->NotifyAccessibilityWindowInfo(windowInfo, type);
+        dispatcher_.Dispatch(agent, { WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_WINDOW_UPDATE, false, 0, {},
+            [windowInfo, type](const sptr<IWindowManagerAgent>& target) {
+                target->NotifyAccessibilityWindowInfo(windowInfo, type);
+            } });
     }
 }
 
@@ -71,7 +100,11 @@ void WindowManagerAgentController::UpdateWindowVisibilityInfo(
     WLOGFD("UpdateWindowVisibilityInfo size:%{public}zu", windowVisibilityInfos.size());
     for (auto& agent : wmAgentContainer_.GetAgentsByType(
         WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_WINDOW_VISIBILITY)) {
-        agent->UpdateWindowVisibilityInfo(windowVisibilityInfos);
+        // visibility changes are incremental, every one of them has to be delivered
+        dispatcher_.Dispatch(agent, { WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_WINDOW_VISIBILITY, false, 0,
+            {}, [windowVisibilityInfos](const sptr<IWindowManagerAgent>& target) {
+                target->UpdateWindowVisibilityInfo(windowVisibilityInfos);
+            } });
     }
 }
 
@@ -79,8 +112,16 @@ void WindowManagerAgentController::UpdateCameraFloatWindowStatus(uint32_t access
 {
     for (auto& agent : wmAgentContainer_.GetAgentsByType(
         WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_CAMERA_FLOAT)) {
-        agent->UpdateCameraFloatWindowStatus(accessTokenId, isShowing);
+        dispatcher_.Dispatch(agent, { WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_CAMERA_FLOAT, true,
+            accessTokenId, {}, [accessTokenId, isShowing](const sptr<IWindowManagerAgent>& target) {
+                target->UpdateCameraFloatWindowStatus(accessTokenId, isShowing);
+            } });
     }
 }
+
+void WindowManagerAgentController::DumpAgentInfo(std::string& dumpInfo)
+{
+    dispatcher_.Dump(dumpInfo);
+}
 } // namespace Rosen
 } // namespace OHOS
\ No newline at end of file
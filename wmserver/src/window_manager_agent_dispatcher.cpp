@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "window_manager_agent_dispatcher.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <sstream>
+
+#include "window_manager_hilog.h"
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WindowManagerAgentDispatcher"};
+    constexpr uint32_t AGENT_WORKER_NUM = 2;
+    constexpr size_t MAX_AGENT_QUEUE_DEPTH = 64;
+    const std::string AGENT_WORKER_THREAD_NAME = "WmAgentNotifier";
+}
+
+WindowManagerAgentDispatcher::WindowManagerAgentDispatcher(AgentDropCallback dropCallback)
+    : dropCallback_(dropCallback), deathRecipient_(new AgentDeathRecipient(
+        [this](sptr<IRemoteObject>& remoteObject) { OnAgentDied(remoteObject); }))
+{
+}
+
+std::shared_ptr<AppExecFwk::EventHandler> WindowManagerAgentDispatcher::GetWorker()
+{
+    // workers are created on first use, the controller is a singleton constructed before the service runs
+    if (workers_.empty()) {
+        for (uint32_t i = 0; i < AGENT_WORKER_NUM; i++) {
+            auto runner = AppExecFwk::EventRunner::Create(AGENT_WORKER_THREAD_NAME + std::to_string(i));
+            workers_.push_back(std::make_shared<AppExecFwk::EventHandler>(runner));
+        }
+    }
+    return workers_[nextWorker_++ % workers_.size()];
+}
+
+bool WindowManagerAgentDispatcher::Supersedes(const AgentNotification& newer, const AgentNotification& older)
+{
+    if (!older.isCoalescable_ || older.type_ != newer.type_ || older.key_ != newer.key_) {
+        return false;
+    }
+    return std::includes(newer.subKeys_.begin(), newer.subKeys_.end(),
+        older.subKeys_.begin(), older.subKeys_.end());
+}
+
+bool WindowManagerAgentDispatcher::UndoPendingLocked(AgentQueue& queue, const AgentNotification& notification)
+{
+    auto& notifications = queue.notifications_;
+    auto iter = std::find_if(notifications.rbegin(), notifications.rend(), [&notification](const auto& pending) {
+        return pending.first.type_ == notification.type_ && pending.first.key_ == notification.key_;
+    });
+    if (iter == notifications.rend() || iter->first.isUndo_ || iter->first.subKeys_ != notification.subKeys_) {
+        return false;
+    }
+    notifications.erase(std::next(iter).base());
+    queue.coalescedCount_ += 2; // 2: the pending notification and its undo
+    return true;
+}
+
+void WindowManagerAgentDispatcher::Dispatch(const sptr<IWindowManagerAgent>& agent,
+    AgentNotification&& notification)
+{
+    if (agent == nullptr || agent->AsObject() == nullptr) {
+        return;
+    }
+    sptr<IRemoteObject> remoteObject = agent->AsObject();
+    sptr<IWindowManagerAgent> droppedAgent = nullptr;
+    std::set<WindowManagerAgentType> droppedTypes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AgentQueue& queue = agentQueues_[remoteObject];
+        if (queue.isDropped_) {
+            return;
+        }
+        if (queue.worker_ == nullptr) {
+            queue.agent_ = agent;
+            queue.worker_ = GetWorker();
+            if (!remoteObject->AddDeathRecipient(deathRecipient_)) {
+                WLOGFI("failed to add death recipient");
+            }
+        }
+        queue.isRemoved_ = false;
+        queue.types_.insert(notification.type_);
+        auto& notifications = queue.notifications_;
+        if (notification.isUndo_ && UndoPendingLocked(queue, notification)) {
+            return;
+        }
+        if (notification.isCoalescable_) {
+            auto iter = std::find_if(notifications.begin(), notifications.end(), [&notification](const auto& pending) {
+                return Supersedes(notification, pending.first);
+            });
+            // the superseded one is removed rather than replaced, so the latest state is also delivered last
+            if (iter != notifications.end()) {
+                notifications.erase(iter);
+                queue.coalescedCount_++;
+            }
+        }
+        if (notifications.size() >= MAX_AGENT_QUEUE_DEPTH) {
+            WLOGFE("agent queue overflows, drop the agent, pending: %{public}zu, delivered: %{public}" PRIu64"",
+                notifications.size(), queue.deliveredCount_);
+            queue.isDropped_ = true;
+            notifications.clear();
+            droppedAgent = queue.agent_;
+            droppedTypes = queue.types_;
+        } else {
+            notifications.emplace_back(std::move(notification), std::chrono::steady_clock::now());
+            queue.maxDepth_ = std::max(queue.maxDepth_, notifications.size());
+            if (!queue.isDraining_) {
+                queue.isDraining_ = queue.worker_->PostTask([this, remoteObject]() { Drain(remoteObject); },
+                    AppExecFwk::EventQueue::Priority::IMMEDIATE);
+                if (!queue.isDraining_) {
+                    WLOGFE("post agent notification task failed");
+                }
+            }
+        }
+    }
+    if (droppedAgent != nullptr && dropCallback_ != nullptr) {
+        dropCallback_(droppedAgent, droppedTypes);
+    }
+}
+
+void WindowManagerAgentDispatcher::Drain(const sptr<IRemoteObject>& remoteObject)
+{
+    while (true) {
+        sptr<IWindowManagerAgent> agent;
+        AgentNotification notification;
+        std::chrono::steady_clock::time_point enqueueTime;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = agentQueues_.find(remoteObject);
+            if (iter == agentQueues_.end()) {
+                return;
+            }
+            AgentQueue& queue = iter->second;
+            if (queue.notifications_.empty()) {
+                queue.isDraining_ = false;
+                if (queue.isRemoved_ || remoteObject->IsObjectDead()) {
+                    RemoveQueueLocked(iter);
+                }
+                return;
+            }
+            agent = queue.agent_;
+            notification = std::move(queue.notifications_.front().first);
+            enqueueTime = queue.notifications_.front().second;
+            queue.notifications_.pop_front();
+        }
+        notification.deliver_(agent);
+        int64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - enqueueTime).count();
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = agentQueues_.find(remoteObject);
+        if (iter == agentQueues_.end()) {
+            return;
+        }
+        AgentQueue& queue = iter->second;
+        queue.deliveredCount_++;
+        queue.totalLatency_ += latency;
+        queue.maxLatency_ = std::max(queue.maxLatency_, latency);
+    }
+}
+
+void WindowManagerAgentDispatcher::ResetAgent(const sptr<IWindowManagerAgent>& agent)
+{
+    if (agent == nullptr || agent->AsObject() == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = agentQueues_.find(agent->AsObject());
+    if (iter == agentQueues_.end()) {
+        return;
+    }
+    if (iter->second.isDraining_) {
+        // the running drain task still owns the queue, only its pending notifications are discarded
+        iter->second.notifications_.clear();
+        iter->second.isDropped_ = false;
+        return;
+    }
+    RemoveQueueLocked(iter);
+}
+
+void WindowManagerAgentDispatcher::RemoveAgentType(const sptr<IWindowManagerAgent>& agent,
+    WindowManagerAgentType type)
+{
+    if (agent == nullptr || agent->AsObject() == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = agentQueues_.find(agent->AsObject());
+    if (iter == agentQueues_.end()) {
+        return;
+    }
+    AgentQueue& queue = iter->second;
+    auto& notifications = queue.notifications_;
+    notifications.erase(std::remove_if(notifications.begin(), notifications.end(),
+        [type](const auto& pending) { return pending.first.type_ == type; }), notifications.end());
+    queue.types_.erase(type);
+    if (!queue.types_.empty()) {
+        return;
+    }
+    if (queue.isDraining_) {
+        queue.isRemoved_ = true;
+        return;
+    }
+    RemoveQueueLocked(iter);
+}
+
+void WindowManagerAgentDispatcher::OnAgentDied(const sptr<IRemoteObject>& remoteObject)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = agentQueues_.find(remoteObject);
+    if (iter == agentQueues_.end()) {
+        return;
+    }
+    if (iter->second.isDraining_) {
+        iter->second.notifications_.clear();
+        iter->second.isRemoved_ = true;
+        return;
+    }
+    RemoveQueueLocked(iter);
+}
+
+void WindowManagerAgentDispatcher::RemoveQueueLocked(std::map<sptr<IRemoteObject>, AgentQueue>::iterator iter)
+{
+    iter->first->RemoveDeathRecipient(deathRecipient_);
+    agentQueues_.erase(iter);
+}
+
+void WindowManagerAgentDispatcher::Dump(std::string& dumpInfo)
+{
+    std::ostringstream oss;
+    oss << "Window manager agents: " << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [remoteObject, queue] : agentQueues_) {
+        int64_t avgLatency = (queue.deliveredCount_ == 0) ? 0 :
+            queue.totalLatency_ / static_cast<int64_t>(queue.deliveredCount_);
+        oss << "  agent: " << remoteObject.GetRefPtr()
+            << ", dropped: " << (queue.isDropped_ ? "true" : "false")
+            << ", depth: " << queue.notifications_.size()
+            << ", maxDepth: " << queue.maxDepth_
+            << ", delivered: " << queue.deliveredCount_
+            << ", coalesced: " << queue.coalescedCount_
+            << ", avgLatency(us): " << avgLatency
+            << ", maxLatency(us): " << queue.maxLatency_ << std::endl;
+    }
+    dumpInfo.append(oss.str());
+}
+} // namespace Rosen
+} // namespace OHOS
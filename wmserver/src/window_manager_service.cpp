@@ -18,6 +18,7 @@
 #include <thread>
 
 #include <ability_manager_client.h>
+#include <algorithm>
 #include <cinttypes>
 #include <chrono>
 #include <hisysevent.h>
@@ -50,6 +51,20 @@ namespace Rosen {
 namespace {
     constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WindowManagerService"};
     constexpr int REPORT_SHOW_WINDOW_TIMES = 50;
+    // how long the oldest bookkeeping task may wait before lifecycle tasks queue behind it
+    constexpr std::chrono::milliseconds BOOKKEEPING_STARVATION_LIMIT(500);
+
+    AppExecFwk::EventQueue::Priority GetTaskLanePriority(WmsTaskClass lane)
+    {
+        switch (lane) {
+            case WmsTaskClass::INTERACTIVE:
+                return AppExecFwk::EventQueue::Priority::IMMEDIATE;
+            case WmsTaskClass::BOOKKEEPING:
+                return AppExecFwk::EventQueue::Priority::LOW;
+            default:
+                return AppExecFwk::EventQueue::Priority::HIGH;
+        }
+    }
 }
 WM_IMPLEMENT_SINGLE_INSTANCE(WindowManagerService)
 
@@ -69,7 +84,10 @@ WindowManagerService::WindowManagerService() : SystemAbility(WINDOW_MANAGER_SERV
     startingOpen_ = system::GetParameter("persist.window.sw.enabled", "1") == "1"; // startingWin default enabled
     runner_ = AppExecFwk::EventRunner::Create(name_);
     handler_ = std::make_shared<AppExecFwk::EventHandler>(runner_);
-    snapshotController_ = new SnapshotController(windowRoot_, handler_);
+    windowController_->SetEventHandler(handler_);
+    snapshotController_ = new SnapshotController(windowRoot_, [this](const Task& task) {
+        return PostAsyncTask(task, WmsTaskClass::BOOKKEEPING);
+    });
     int ret = HiviewDFX::Watchdog::GetInstance().AddThread(name_, handler_);
     if (ret != 0) {
         WLOGFE("Add watchdog thread failed");
@@ -77,7 +95,13 @@ WindowManagerService::WindowManagerService() : SystemAbility(WINDOW_MANAGER_SERV
 
     // init RSUIDirector, it will handle animation callback
     rsUiDirector_ = RSUIDirector::Create();
-    rsUiDirector_->SetUITaskRunner([this](const std::function<void()>& task) { PostAsyncTask(task); });
+    rsUiDirector_->SetUITaskRunner([this](const std::function<void()>& task) {
+        // animation callbacks may hide or remove windows
+        PostAsyncTask([this, task]() {
+            task();
+            MarkReadModelStale();
+        }, WmsTaskClass::INTERACTIVE);
+    });
     rsUiDirector_->Init(false);
 }
 
@@ -98,26 +122,184 @@ void WindowManagerService::OnStart()
     AddSystemAbilityListener(COMMON_EVENT_SERVICE_ID);
 }
 
-void WindowManagerService::PostAsyncTask(Task task)
+bool WindowManagerService::PostAsyncTask(Task task, WmsTaskClass taskClass)
 {
     if (handler_) {
-        bool ret = handler_->PostTask(task, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+        auto postTime = std::chrono::steady_clock::now();
+        WmsTaskClass lane = AcquireTaskLane(taskClass, postTime);
+        bool ret = handler_->PostTask([this, task, taskClass, lane, postTime]() {
+            RunTask(task, taskClass, lane, postTime);
+        }, GetTaskLanePriority(lane));
         if (!ret) {
+            ReleaseTaskLane(taskClass, lane, postTime);
             WLOGFE("EventHandler PostTask Failed");
         }
+        return ret;
     }
+    return false;
 }
 
-void WindowManagerService::PostVoidSyncTask(Task task)
+void WindowManagerService::PostVoidSyncTask(Task task, WmsTaskClass taskClass)
 {
     if (handler_) {
-        bool ret = handler_->PostSyncTask(task, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+        auto postTime = std::chrono::steady_clock::now();
+        WmsTaskClass lane = AcquireTaskLane(taskClass, postTime);
+        bool ret = handler_->PostSyncTask([this, &task, taskClass, lane, postTime]() {
+            RunTask(task, taskClass, lane, postTime);
+        }, GetTaskLanePriority(lane));
         if (!ret) {
+            ReleaseTaskLane(taskClass, lane, postTime);
             WLOGFE("EventHandler PostVoidSyncTask Failed");
         }
     }
 }
 
+void WindowManagerService::RunTask(const Task& task, WmsTaskClass taskClass, WmsTaskClass lane,
+    std::chrono::steady_clock::time_point postTime)
+{
+    ReleaseTaskLane(taskClass, lane, postTime);
+    int64_t waitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - postTime).count();
+    auto& statistics = taskClassStatistics_[static_cast<size_t>(taskClass)];
+    statistics.taskCount_++;
+    statistics.yieldCount_ += (lane != taskClass) ? 1 : 0;
+    statistics.totalWaitTime_ += waitTime;
+    statistics.maxWaitTime_ = std::max(statistics.maxWaitTime_, waitTime);
+    task();
+}
+
+WmsTaskClass WindowManagerService::AcquireTaskLane(WmsTaskClass taskClass,
+    std::chrono::steady_clock::time_point postTime)
+{
+    std::lock_guard<std::mutex> lock(taskLaneMutex_);
+    WmsTaskClass lane = taskClass;
+    // input driven tasks never yield, the event queue still lets a lower priority event through now and then;
+    // lifecycle tasks queue behind a starving bookkeeping lane instead of overtaking it again, and keep queueing
+    // there until every demoted one has run, so lifecycle tasks never overtake each other
+    if (taskClass == WmsTaskClass::LIFECYCLE) {
+        const auto& pendingPostTimes = pendingTaskPostTimes_[static_cast<size_t>(WmsTaskClass::BOOKKEEPING)];
+        if (demotedLifecycleTaskCount_ > 0 ||
+            (!pendingPostTimes.empty() && postTime - *pendingPostTimes.begin() > BOOKKEEPING_STARVATION_LIMIT)) {
+            lane = WmsTaskClass::BOOKKEEPING;
+            demotedLifecycleTaskCount_++;
+        }
+    }
+    pendingTaskPostTimes_[static_cast<size_t>(lane)].insert(postTime);
+    return lane;
+}
+
+void WindowManagerService::ReleaseTaskLane(WmsTaskClass taskClass, WmsTaskClass lane,
+    std::chrono::steady_clock::time_point postTime)
+{
+    std::lock_guard<std::mutex> lock(taskLaneMutex_);
+    if (taskClass != lane && demotedLifecycleTaskCount_ > 0) {
+        demotedLifecycleTaskCount_--;
+    }
+    auto& pendingPostTimes = pendingTaskPostTimes_[static_cast<size_t>(lane)];
+    auto iter = pendingPostTimes.find(postTime);
+    if (iter != pendingPostTimes.end()) {
+        pendingPostTimes.erase(iter);
+    }
+}
+
+void WindowManagerService::DumpTaskClassInfo(std::string& dumpInfo) const
+{
+    const char* taskClassNames[] = { "interactive", "lifecycle", "bookkeeping" };
+    std::ostringstream oss;
+    oss << "WMS handler tasks: " << std::endl;
+    for (size_t i = 0; i < static_cast<size_t>(WmsTaskClass::END); i++) {
+        const auto& statistics = taskClassStatistics_[i];
+        int64_t avgWaitTime = (statistics.taskCount_ == 0) ? 0 :
+            statistics.totalWaitTime_ / static_cast<int64_t>(statistics.taskCount_);
+        oss << "  " << taskClassNames[i]
+            << ": count: " << statistics.taskCount_
+            << ", yielded: " << statistics.yieldCount_
+            << ", avgWait(us): " << avgWaitTime
+            << ", maxWait(us): " << statistics.maxWaitTime_ << std::endl;
+    }
+    dumpInfo.append(oss.str());
+}
+
+void WindowManagerService::MarkReadModelStale()
+{
+    isReadModelStale_ = true;
+    readModelChangeSeq_.fetch_add(1, std::memory_order_release);
+    PostReadModelPublish();
+}
+
+void WindowManagerService::MarkReadModelWindowStale(uint32_t windowId)
+{
+    readModelStaleWindows_.insert(windowId);
+    readModelChangeSeq_.fetch_add(1, std::memory_order_release);
+    PostReadModelPublish();
+}
+
+void WindowManagerService::MarkReadModelStale(const sptr<WindowProperty>& windowProperty,
+    PropertyChangeAction action)
+{
+    // rect and transform updates only change the updated window
+    if (action == PropertyChangeAction::ACTION_UPDATE_RECT ||
+        action == PropertyChangeAction::ACTION_UPDATE_TRANSFORM_PROPERTY) {
+        MarkReadModelWindowStale(windowProperty->GetWindowId());
+    } else {
+        MarkReadModelStale();
+    }
+}
+
+void WindowManagerService::PostReadModelPublish()
+{
+    // posted at IMMEDIATE, ahead of the queued lifecycle and bookkeeping tasks, so readers see a change soon;
+    // the changes made before it runs, e.g. all of one handler task, share this one publish
+    if (isReadModelPublishPosted_ || handler_ == nullptr) {
+        return;
+    }
+    isReadModelPublishPosted_ = handler_->PostTask([this]() {
+        isReadModelPublishPosted_ = false;
+        PublishReadModel();
+    }, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+    if (!isReadModelPublishPosted_) {
+        WLOGFE("post read model publish task failed, retried by the next change");
+    }
+}
+
+std::shared_ptr<const WindowReadModel> WindowManagerService::PublishReadModel()
+{
+    auto readModel = std::atomic_load(&readModel_);
+    uint64_t changeSeq = readModelChangeSeq_.load(std::memory_order_acquire);
+    if (readModel != nullptr && !isReadModelStale_ && readModelStaleWindows_.empty()) {
+        readModelPublishedSeq_.store(changeSeq, std::memory_order_release);
+        return readModel;
+    }
+    if (readModel == nullptr || isReadModelStale_) {
+        readModel = windowController_->CreateReadModel(hotZonesConfig_);
+    } else {
+        readModel = windowController_->UpdateReadModel(readModel, readModelStaleWindows_, hotZonesConfig_);
+    }
+    // the new model is stored before the marks are cleared, a change is never dropped unpublished
+    std::atomic_store(&readModel_, readModel);
+    readModelPublishedSeq_.store(changeSeq, std::memory_order_release);
+    isReadModelStale_ = false;
+    readModelStaleWindows_.clear();
+    return readModel;
+}
+
+std::shared_ptr<const WindowReadModel> WindowManagerService::GetReadModel()
+{
+    // the published model is served while no change is waiting for its republish
+    uint64_t publishedSeq = readModelPublishedSeq_.load(std::memory_order_acquire);
+    auto readModel = std::atomic_load(&readModel_);
+    if ((readModel != nullptr && publishedSeq == readModelChangeSeq_.load(std::memory_order_acquire)) ||
+        handler_ == nullptr) {
+        return readModel;
+    }
+    // a change whose request may already have returned is not published yet, bring the model up to date
+    // on the handler so a client never reads state older than its own completed request
+    handler_->PostSyncTask([this, &readModel]() {
+        readModel = PublishReadModel();
+    }, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+    return readModel;
+}
+
 
 void WindowManagerService::OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
 {
@@ -131,6 +313,7 @@ void WindowManagerService::OnAccountSwitched(int accountId)
 {
     PostAsyncTask([this, accountId]() {
         windowRoot_->RemoveSingleUserWindowNodes(accountId);
+        MarkReadModelStale();
     });
     WLOGFI("called");
 }
@@ -180,7 +363,9 @@ void WindowManagerService::RegisterWindowVisibilityChangeCallback()
 void WindowManagerService::RegisterSnapshotHandler()
 {
     if (snapshotController_ == nullptr) {
-        snapshotController_ = new SnapshotController(windowRoot_, handler_);
+        snapshotController_ = new SnapshotController(windowRoot_, [this](const Task& task) {
+            return PostAsyncTask(task, WmsTaskClass::BOOKKEEPING);
+        });
     }
     if (AAFwk::AbilityManagerClient::GetInstance()->RegisterSnapshotHandler(snapshotController_) != ERR_OK) {
         WLOGFW("WindowManagerService::RegisterSnapshotHandler failed, create async thread!");
@@ -295,7 +480,7 @@ int WindowManagerService::Dump(int fd, const std::vector<std::u16string>& args)
 
     return PostSyncTask([this, fd, &args]() {
         return static_cast<int>(windowDumper_->Dump(fd, args));
-    });
+    }, WmsTaskClass::BOOKKEEPING);
 }
 
 void WindowManagerService::ConfigureWindowManagerService()
@@ -581,12 +766,14 @@ WMError WindowManagerService::NotifyWindowTransition(
     if (!isFromClient) {
         WLOGFI("NotifyWindowTransition asynchronously.");
         PostAsyncTask([this, fromInfo, toInfo]() mutable {
+            MarkReadModelStale();
             return windowController_->NotifyWindowTransition(fromInfo, toInfo);
         });
         return WMError::WM_OK;
     } else {
         WLOGFI("NotifyWindowTransition synchronously.");
         return PostSyncTask([this, &fromInfo, &toInfo]() {
+            MarkReadModelStale();
             return windowController_->NotifyWindowTransition(fromInfo, toInfo);
         });
     }
@@ -596,7 +783,7 @@ WMError WindowManagerService::GetFocusWindowInfo(sptr<IRemoteObject>& abilityTok
 {
     return PostSyncTask([this, &abilityToken]() {
         return windowController_->GetFocusWindowInfo(abilityToken);
-    });
+    }, WmsTaskClass::BOOKKEEPING);
 }
 
 void WindowManagerService::StartingWindow(sptr<WindowTransitionInfo> info, sptr<Media::PixelMap> pixelMap,
@@ -608,6 +795,7 @@ void WindowManagerService::StartingWindow(sptr<WindowTransitionInfo> info, sptr<
     }
     PostAsyncTask([this, info, pixelMap, isColdStart, bkgColor]() {
         windowController_->StartingWindow(info, pixelMap, bkgColor, isColdStart);
+        MarkReadModelStale();
     });
 }
 
@@ -620,6 +808,7 @@ void WindowManagerService::CancelStartingWindow(sptr<IRemoteObject> abilityToken
     }
     PostAsyncTask([this, abilityToken]() {
         windowController_->CancelStartingWindow(abilityToken);
+        MarkReadModelStale();
     });
 }
 
@@ -658,6 +847,7 @@ WMError WindowManagerService::AddWindow(sptr<WindowProperty>& property)
             "%{public}4d %{public}4d]", windowId, property->GetWindowType(), property->GetWindowMode(),
             property->GetWindowFlags(), rect.posX_, rect.posY_, rect.width_, rect.height_);
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:AddWindow(%u)", windowId);
+        MarkReadModelStale();
         WMError res = windowController_->AddWindowNode(property);
         if (property->GetWindowType() == WindowType::WINDOW_TYPE_DRAGGING_EFFECT) {
             dragController_->StartDrag(windowId);
@@ -677,6 +867,7 @@ WMError WindowManagerService::RemoveWindow(uint32_t windowId)
     return PostSyncTask([this, windowId]() {
         WLOGFI("[WMS] Remove: %{public}u", windowId);
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:RemoveWindow(%u)", windowId);
+        MarkReadModelStale();
         WindowInnerManager::GetInstance().NotifyWindowRemovedOrDestroyed(windowId);
         WMError res = windowController_->RecoverInputEventToClient(windowId);
         if (res != WMError::WM_OK) {
@@ -695,6 +886,7 @@ WMError WindowManagerService::DestroyWindow(uint32_t windowId, bool onlySelf)
     return PostSyncTask([this, windowId, onlySelf]() {
         WLOGFI("[WMS] Destroy: %{public}u", windowId);
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:DestroyWindow(%u)", windowId);
+        MarkReadModelStale();
         WindowInnerManager::GetInstance().NotifyWindowRemovedOrDestroyed(windowId);
         auto node = windowRoot_->GetWindowNode(windowId);
         if (node != nullptr && node->GetWindowType() == WindowType::WINDOW_TYPE_DRAGGING_EFFECT) {
@@ -708,17 +900,20 @@ WMError WindowManagerService::RequestFocus(uint32_t windowId)
 {
     return PostSyncTask([this, windowId]() {
         WLOGFI("[WMS] RequestFocus: %{public}u", windowId);
+        MarkReadModelStale();
         return windowController_->RequestFocus(windowId);
-    });
+    }, WmsTaskClass::INTERACTIVE);
 }
 
 AvoidArea WindowManagerService::GetAvoidAreaByType(uint32_t windowId, AvoidAreaType avoidAreaType)
 {
-    return PostSyncTask([this, windowId, avoidAreaType]() {
-        WLOGFI("[WMS] GetAvoidAreaByType: %{public}u, Type: %{public}u", windowId,
-            static_cast<uint32_t>(avoidAreaType));
-        return windowController_->GetAvoidAreaByType(windowId, avoidAreaType);
-    });
+    WLOGFI("[WMS] GetAvoidAreaByType: %{public}u, Type: %{public}u", windowId,
+        static_cast<uint32_t>(avoidAreaType));
+    auto readModel = GetReadModel();
+    if (readModel == nullptr) {
+        return {};
+    }
+    return readModel->GetAvoidAreaByType(windowId, avoidAreaType);
 }
 
 void WindowManagerService::RegisterWindowManagerAgent(WindowManagerAgentType type,
@@ -733,7 +928,7 @@ void WindowManagerService::RegisterWindowManagerAgent(WindowManagerAgentType typ
         if (type == WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_SYSTEM_BAR) { // if system bar, notify once
             windowController_->NotifySystemBarTints();
         }
-    });
+    }, WmsTaskClass::BOOKKEEPING);
 }
 
 void WindowManagerService::UnregisterWindowManagerAgent(WindowManagerAgentType type,
@@ -745,7 +940,7 @@ void WindowManagerService::UnregisterWindowManagerAgent(WindowManagerAgentType t
     }
     PostVoidSyncTask([this, &windowManagerAgent, type]() {
         WindowManagerAgentController::GetInstance().UnregisterWindowManagerAgent(windowManagerAgent, type);
-    });
+    }, WmsTaskClass::BOOKKEEPING);
 }
 
 WMError WindowManagerService::SetWindowAnimationController(const sptr<RSIWindowAnimationController>& controller)
@@ -757,15 +952,16 @@ WMError WindowManagerService::SetWindowAnimationController(const sptr<RSIWindowA
 
     sptr<AgentDeathRecipient> deathRecipient = new AgentDeathRecipient(
         [this](sptr<IRemoteObject>& remoteObject) {
-            PostVoidSyncTask([&remoteObject]() {
+            PostVoidSyncTask([this, &remoteObject]() {
                 RemoteAnimation::OnRemoteDie(remoteObject);
+                MarkReadModelStale();
             });
         }
     );
     controller->AsObject()->AddDeathRecipient(deathRecipient);
     return PostSyncTask([this, &controller]() {
         return windowController_->SetWindowAnimationController(controller);
-    });
+    }, WmsTaskClass::BOOKKEEPING);
 }
 
 void WindowManagerService::OnWindowEvent(Event event, const sptr<IRemoteObject>& remoteObject)
@@ -778,6 +974,7 @@ void WindowManagerService::OnWindowEvent(Event event, const sptr<IRemoteObject>&
                 dragController_->FinishDrag(windowId);
             }
             windowController_->DestroyWindow(windowId, true);
+            MarkReadModelStale();
         });
     }
 }
@@ -794,6 +991,7 @@ void WindowManagerService::NotifyDisplayStateChange(DisplayId defaultDisplayId,
     } else {
         PostAsyncTask([this, defaultDisplayId, displayInfo, displayInfoMap, type]() mutable {
             windowController_->NotifyDisplayStateChange(defaultDisplayId, displayInfo, displayInfoMap, type);
+            MarkReadModelStale();
         });
     }
 }
@@ -833,14 +1031,16 @@ void WindowManagerService::NotifyServerReadyToMoveOrDrag(uint32_t windowId, sptr
             windowController_->InterceptInputEventToServer(windowId);
         }
         windowController_->NotifyServerReadyToMoveOrDrag(windowId, moveDragProperty);
-    });
+        MarkReadModelStale();
+    }, WmsTaskClass::INTERACTIVE);
 }
 
 void WindowManagerService::ProcessPointDown(uint32_t windowId)
 {
     PostAsyncTask([this, windowId]() {
         windowController_->ProcessPointDown(windowId);
-    });
+        MarkReadModelStale();
+    }, WmsTaskClass::INTERACTIVE);
 }
 
 void WindowManagerService::ProcessPointUp(uint32_t windowId)
@@ -849,7 +1049,8 @@ void WindowManagerService::ProcessPointUp(uint32_t windowId)
         WindowInnerManager::GetInstance().NotifyWindowEndUpMovingOrDragging(windowId);
         windowController_->RecoverInputEventToClient(windowId);
         windowController_->ProcessPointUp(windowId);
-    });
+        MarkReadModelStale();
+    }, WmsTaskClass::INTERACTIVE);
 }
 
 void WindowManagerService::NotifyWindowClientPointUp(uint32_t windowId,
@@ -857,7 +1058,23 @@ void WindowManagerService::NotifyWindowClientPointUp(uint32_t windowId,
 {
     PostAsyncTask([this, windowId, pointerEvent]() mutable {
         windowController_->NotifyWindowClientPointUp(windowId, pointerEvent);
-    });
+        // finishing the move or drag runs the deferred layout, which may change any rect or avoid area
+        MarkReadModelStale();
+    }, WmsTaskClass::INTERACTIVE);
+}
+
+void WindowManagerService::UpdateMoveOrDragRect(const sptr<WindowProperty>& windowProperty, int64_t pointerTime)
+{
+    PostAsyncTask([this, windowProperty, pointerTime]() {
+        HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:UpdateMoveOrDragRect");
+        WMError res = windowController_->UpdateMoveOrDragRect(windowProperty, pointerTime);
+        if (res == WMError::WM_OK && windowProperty->GetWindowSizeChangeReason() == WindowSizeChangeReason::MOVE) {
+            // keeps the drag target under the pointer up to date, as the UpdateProperty path does
+            dragController_->UpdateDragInfo(windowProperty->GetWindowId());
+        }
+        // drag frames only move the dragged window
+        MarkReadModelWindowStale(windowProperty->GetWindowId());
+    }, WmsTaskClass::INTERACTIVE);
 }
 
 void WindowManagerService::MinimizeAllAppWindows(DisplayId displayId)
@@ -866,6 +1083,7 @@ void WindowManagerService::MinimizeAllAppWindows(DisplayId displayId)
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:MinimizeAllAppWindows(%" PRIu64")", displayId);
         WLOGFI("displayId %{public}" PRIu64"", displayId);
         windowController_->MinimizeAllAppWindows(displayId);
+        MarkReadModelStale();
     });
 }
 
@@ -873,6 +1091,7 @@ WMError WindowManagerService::ToggleShownStateForAllAppWindows()
 {
     PostAsyncTask([this]() {
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:ToggleShownStateForAllAppWindows");
+        MarkReadModelStale();
         return windowController_->ToggleShownStateForAllAppWindows();
     });
     return WMError::WM_OK;
@@ -880,9 +1099,11 @@ WMError WindowManagerService::ToggleShownStateForAllAppWindows()
 
 WMError WindowManagerService::GetTopWindowId(uint32_t mainWinId, uint32_t& topWinId)
 {
-    return PostSyncTask([this, &topWinId, mainWinId]() {
-        return windowController_->GetTopWindowId(mainWinId, topWinId);
-    });
+    auto readModel = GetReadModel();
+    if (readModel == nullptr) {
+        return WMError::WM_ERROR_NULLPTR;
+    }
+    return readModel->GetTopWindowId(mainWinId, topWinId);
 }
 
 WMError WindowManagerService::SetWindowLayoutMode(WindowLayoutMode mode)
@@ -890,6 +1111,7 @@ WMError WindowManagerService::SetWindowLayoutMode(WindowLayoutMode mode)
     return PostSyncTask([this, mode]() {
         WLOGFI("layoutMode: %{public}u", mode);
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:SetWindowLayoutMode");
+        MarkReadModelStale();
         return windowController_->SetWindowLayoutMode(mode);
     });
 }
@@ -905,6 +1127,7 @@ WMError WindowManagerService::UpdateProperty(sptr<WindowProperty>& windowPropert
     if (action == PropertyChangeAction::ACTION_UPDATE_TRANSFORM_PROPERTY) {
         PostAsyncTask([this, windowProperty, action]() mutable {
             windowController_->UpdateProperty(windowProperty, action);
+            MarkReadModelStale(windowProperty, action);
         });
         return WMError::WM_OK;
     }
@@ -913,7 +1136,9 @@ WMError WindowManagerService::UpdateProperty(sptr<WindowProperty>& windowPropert
         PostAsyncTask([this, windowProperty, action]() mutable {
             HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:UpdateProperty");
             WMError res = windowController_->UpdateProperty(windowProperty, action);
-            if (action == PropertyChangeAction::ACTION_UPDATE_RECT && res == WMError::WM_OK &&
+            MarkReadModelStale(windowProperty, action);
+            if ((static_cast<uint32_t>(action) & static_cast<uint32_t>(PropertyChangeAction::ACTION_UPDATE_RECT)) &&
+                res == WMError::WM_OK &&
                 windowProperty->GetWindowSizeChangeReason() == WindowSizeChangeReason::MOVE) {
                 dragController_->UpdateDragInfo(windowProperty->GetWindowId());
             }
@@ -924,7 +1149,9 @@ WMError WindowManagerService::UpdateProperty(sptr<WindowProperty>& windowPropert
     return PostSyncTask([this, &windowProperty, action]() {
         HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:UpdateProperty");
         WMError res = windowController_->UpdateProperty(windowProperty, action);
-        if (action == PropertyChangeAction::ACTION_UPDATE_RECT && res == WMError::WM_OK &&
+        MarkReadModelStale(windowProperty, action);
+        if ((static_cast<uint32_t>(action) & static_cast<uint32_t>(PropertyChangeAction::ACTION_UPDATE_RECT)) &&
+            res == WMError::WM_OK &&
             windowProperty->GetWindowSizeChangeReason() == WindowSizeChangeReason::MOVE) {
             dragController_->UpdateDragInfo(windowProperty->GetWindowId());
         }
@@ -938,9 +1165,12 @@ WMError WindowManagerService::GetAccessibilityWindowInfo(sptr<AccessibilityWindo
         WLOGFE("windowInfo is invalid");
         return WMError::WM_ERROR_NULLPTR;
     }
-    return PostSyncTask([this, &windowInfo]() {
-        return windowController_->GetAccessibilityWindowInfo(windowInfo);
-    });
+    auto readModel = GetReadModel();
+    if (readModel == nullptr) {
+        return WMError::WM_ERROR_NULLPTR;
+    }
+    readModel->GetAccessibilityWindowInfo(windowInfo);
+    return WMError::WM_OK;
 }
 
 WMError WindowManagerService::GetSystemConfig(SystemConfig& systemConfig)
@@ -955,7 +1185,11 @@ WMError WindowManagerService::GetModeChangeHotZones(DisplayId displayId, ModeCha
         return WMError::WM_DO_NOTHING;
     }
 
-    return windowController_->GetModeChangeHotZones(displayId, hotZones, hotZonesConfig_);
+    auto readModel = GetReadModel();
+    if (readModel == nullptr) {
+        return WMError::WM_ERROR_NULLPTR;
+    }
+    return readModel->GetModeChangeHotZones(displayId, hotZones);
 }
 
 void WindowManagerService::MinimizeWindowsByLauncher(std::vector<uint32_t> windowIds, bool isAnimated,
@@ -963,6 +1197,7 @@ void WindowManagerService::MinimizeWindowsByLauncher(std::vector<uint32_t> windo
 {
     PostVoidSyncTask([this, windowIds, isAnimated, &finishCallback]() mutable {
         windowController_->MinimizeWindowsByLauncher(windowIds, isAnimated, finishCallback);
+        MarkReadModelStale();
     });
 }
 
@@ -988,7 +1223,7 @@ WMError WindowManagerService::UpdateAvoidAreaListener(uint32_t windowId, bool ha
         }
         container->UpdateAvoidAreaListener(node, haveAvoidAreaListener);
         return WMError::WM_OK;
-    });
+    }, WmsTaskClass::BOOKKEEPING);
 }
 
 WMError WindowManagerService::UpdateRsTree(uint32_t windowId, bool isAdd)
@@ -1016,7 +1251,7 @@ void WindowManagerService::HasPrivateWindow(DisplayId displayId, bool& hasPrivat
 {
     PostVoidSyncTask([this, displayId, &hasPrivateWindow]() mutable {
         hasPrivateWindow = windowRoot_->HasPrivateWindow(displayId);
-    });
+    }, WmsTaskClass::BOOKKEEPING);
     WLOGFI("called %{public}u", hasPrivateWindow);
 }
 
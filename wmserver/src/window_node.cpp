@@ -40,6 +40,10 @@ void WindowNode::SetFullWindowHotArea(const Rect& rect)
 
 void WindowNode::SetWindowRect(const Rect& rect)
 {
+    if (property_->GetWindowRect() != rect) {
+        isInputInfoDirty_ = true;
+        UpdateContentGeneration();
+    }
     property_->SetWindowRect(rect);
 }
 
@@ -56,6 +60,7 @@ void WindowNode::SetRequestRect(const Rect& rect)
 void WindowNode::SetWindowProperty(const sptr<WindowProperty>& property)
 {
     property_ = property;
+    isInputInfoDirty_ = true;
 }
 
 void WindowNode::SetSystemBarProperty(WindowType type, const SystemBarProperty& property)
@@ -65,6 +70,9 @@ void WindowNode::SetSystemBarProperty(WindowType type, const SystemBarProperty&
 
 void WindowNode::SetWindowMode(WindowMode mode)
 {
+    if (property_->GetWindowMode() != mode) {
+        UpdateContentGeneration();
+    }
     property_->SetWindowMode(mode);
 }
 
@@ -81,6 +89,7 @@ void WindowNode::SetFocusable(bool focusable)
 void WindowNode::SetTouchable(bool touchable)
 {
     property_->SetTouchable(touchable);
+    isInputInfoDirty_ = true;
 }
 
 void WindowNode::SetTurnScreenOn(bool turnScreenOn)
@@ -142,6 +151,7 @@ void WindowNode::SetWindowToken(sptr<IWindow> window)
 void WindowNode::SetInputEventCallingPid(int32_t pid)
 {
     inputCallingPid_ = pid;
+    isInputInfoDirty_ = true;
 }
 
 void WindowNode::SetCallingPid(int32_t pid)
@@ -153,6 +163,7 @@ void WindowNode::SetCallingPid(int32_t pid)
 void WindowNode::SetCallingUid(int32_t uid)
 {
     callingUid_ = uid;
+    isInputInfoDirty_ = true;
 }
 
 void WindowNode::SetDragType(DragType dragType)
@@ -168,6 +179,7 @@ void WindowNode::SetOriginRect(const Rect& rect)
 void WindowNode::SetTouchHotAreas(const std::vector<Rect>& rects)
 {
     touchHotAreas_ = rects;
+    isInputInfoDirty_ = true;
 }
 
 void WindowNode::SetWindowSizeLimits(const WindowSizeLimits& sizeLimits)
@@ -188,6 +200,45 @@ void WindowNode::ComputeTransform()
 void WindowNode::SetTransform(const Transform& trans)
 {
     property_->SetTransform(trans);
+    isInputInfoDirty_ = true;
+}
+
+void WindowNode::SetZOrder(uint32_t zOrder)
+{
+    const std::array<std::shared_ptr<RSSurfaceNode>, 3> surfaceNodes = {
+        leashWinSurfaceNode_, surfaceNode_, startingWinSurfaceNode_
+    };
+    std::array<uint64_t, 3> surfaceIds { 0, 0, 0 };
+    for (size_t i = 0; i < surfaceNodes.size(); i++) {
+        if (surfaceNodes[i] != nullptr) {
+            surfaceIds[i] = surfaceNodes[i]->GetId();
+        }
+    }
+    if (zOrder == zOrder_ && surfaceIds == zOrderSurfaceIds_) {
+        return;
+    }
+    for (auto& surfaceNode : surfaceNodes) {
+        if (surfaceNode != nullptr) {
+            surfaceNode->SetPositionZ(zOrder);
+        }
+    }
+    zOrder_ = zOrder;
+    zOrderSurfaceIds_ = surfaceIds;
+}
+
+uint32_t WindowNode::GetZOrder() const
+{
+    return zOrder_;
+}
+
+void WindowNode::UpdateContentGeneration()
+{
+    contentGeneration_++;
+}
+
+uint32_t WindowNode::GetContentGeneration() const
+{
+    return contentGeneration_;
 }
 
 WindowSizeLimits WindowNode::GetWindowSizeLimits() const
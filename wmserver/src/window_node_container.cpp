@@ -26,6 +26,7 @@
 
 #include "common_event_manager.h"
 #include "dm_common.h"
+#include "outbound_call_worker.h"
 #include "remote_animation.h"
 #include "starting_window.h"
 #include "window_helper.h"
@@ -66,6 +67,9 @@ WindowNodeContainer::WindowNodeContainer(const sptr<DisplayInfo>& displayInfo, S
         displayGroupController_->displayGroupWindowTree_);
     layoutPolicies_[WindowLayoutMode::TILE] = new WindowLayoutPolicyTile(displayGroupInfo_,
         displayGroupController_->displayGroupWindowTree_);
+    for (auto& iter : layoutPolicies_) {
+        iter.second->SetHitTestIndex(hitTestIndex_);
+    }
     layoutPolicy_ = layoutPolicies_[WindowLayoutMode::CASCADE];
     layoutPolicy_->Launch();
 
@@ -100,6 +104,7 @@ WMError WindowNodeContainer::AddWindowNodeOnWindowTree(sptr<WindowNode>& node, c
         return WMError::WM_ERROR_NULLPTR;
     }
     node->requestedVisibility_ = true;
+    node->UpdateContentGeneration();
     if (parentNode != nullptr) { // subwindow
         if (parentNode->parent_ != root &&
             !((parentNode->GetWindowFlags() & static_cast<uint32_t>(WindowFlag::WINDOW_FLAG_SHOW_WHEN_LOCKED)) &&
@@ -114,6 +119,7 @@ WMError WindowNodeContainer::AddWindowNodeOnWindowTree(sptr<WindowNode>& node, c
         node->currentVisibility_ = true;
         for (auto& child : node->children_) {
             child->currentVisibility_ = child->requestedVisibility_;
+            child->UpdateContentGeneration();
         }
         if (WindowHelper::IsSystemBarWindow(node->GetWindowType())) {
             displayGroupController_->sysBarNodeMaps_[node->GetDisplayId()][node->GetWindowType()] = node;
@@ -242,6 +248,15 @@ WMError WindowNodeContainer::UpdateWindowNode(sptr<WindowNode>& node, WindowUpda
     return WMError::WM_OK;
 }
 
+bool WindowNodeContainer::MoveWindowNode(sptr<WindowNode>& node, const Rect& requestRect)
+{
+    // moving a window in tile mode switches the layout policy back to cascade
+    if (layoutMode_ != WindowLayoutMode::CASCADE) {
+        return false;
+    }
+    return layoutPolicy_->MoveWindowNode(node, requestRect);
+}
+
 void WindowNodeContainer::RemoveWindowNodeFromWindowTree(sptr<WindowNode>& node)
 {
     // remove this node from node vector of display
@@ -255,6 +270,8 @@ void WindowNodeContainer::RemoveWindowNodeFromWindowTree(sptr<WindowNode>& node)
         WLOGFE("can't find this node in parent");
     }
     node->parent_ = nullptr;
+    RemoveWindowNodeIndex(node);
+    MarkWindowTreeChanged();
 }
 
 void WindowNodeContainer::RemoveNodeFromRSTree(sptr<WindowNode>& node)
@@ -286,6 +303,7 @@ WMError WindowNodeContainer::RemoveWindowNode(sptr<WindowNode>& node)
 
     node->requestedVisibility_ = false;
     node->currentVisibility_ = false;
+    node->UpdateContentGeneration();
     // Remove node from RSTree
     // When RemoteAnimation exists, Remove node from RSTree after animation
     RemoveNodeFromRSTree(node);
@@ -353,6 +371,7 @@ WMError WindowNodeContainer::DestroyWindowNode(sptr<WindowNode>& node, std::vect
     // clear vector cache completely, swap with empty vector
     auto emptyVector = std::vector<sptr<WindowNode>>();
     node->children_.swap(emptyVector);
+    MarkWindowTreeChanged();
     WLOGFI("DestroyWindowNode windowId: %{public}u end", node->GetWindowId());
     return WMError::WM_OK;
 }
@@ -404,6 +423,8 @@ void WindowNodeContainer::UpdateWindowTree(sptr<WindowNode>& node)
         }
     }
     parentNode->children_.insert(position, node);
+    AddWindowNodeIndex(node);
+    MarkWindowTreeChanged();
 }
 
 bool WindowNodeContainer::UpdateRSTree(sptr<WindowNode>& node, DisplayId displayId, bool isAdd, bool animationPlayed)
@@ -481,7 +502,10 @@ void WindowNodeContainer::RecoverScreenDefaultOrientationIfNeed(DisplayId displa
                 break;
             }
         }
-        DisplayManagerServiceInner::GetInstance().SetOrientationFromWindow(displayId, targetOrientation);
+        OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::DISPLAY_ORIENTATION, displayId,
+            [displayId, targetOrientation]() {
+                DisplayManagerServiceInner::GetInstance().SetOrientationFromWindow(displayId, targetOrientation);
+            });
     }
 }
 
@@ -520,20 +544,30 @@ sptr<WindowNode> WindowNodeContainer::FindRoot(WindowType type) const
 
 sptr<WindowNode> WindowNodeContainer::FindWindowNodeById(uint32_t id) const
 {
-    std::vector<sptr<WindowNode>> rootNodes = { aboveAppWindowNode_, appWindowNode_, belowAppWindowNode_ };
-    for (auto& rootNode : rootNodes) {
-        for (auto& node : rootNode->children_) {
-            if (node->GetWindowId() == id) {
-                return node;
-            }
-            for (auto& subNode : node->children_) {
-                if (subNode->GetWindowId() == id) {
-                    return subNode;
-                }
-            }
-        }
+    auto iter = windowNodeMap_.find(id);
+    if (iter == windowNodeMap_.end()) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+void WindowNodeContainer::AddWindowNodeIndex(const sptr<WindowNode>& node)
+{
+    // children of a node become reachable again together with it, e.g. sub windows of a re-shown main window
+    windowNodeMap_[node->GetWindowId()] = node;
+    hitTestIndex_->AddWindowNode(node);
+    for (auto& child : node->children_) {
+        AddWindowNodeIndex(child);
+    }
+}
+
+void WindowNodeContainer::RemoveWindowNodeIndex(const sptr<WindowNode>& node)
+{
+    windowNodeMap_.erase(node->GetWindowId());
+    hitTestIndex_->RemoveWindowNode(node);
+    for (auto& child : node->children_) {
+        RemoveWindowNodeIndex(child);
     }
-    return nullptr;
 }
 
 void WindowNodeContainer::UpdateFocusStatus(uint32_t id, bool focused) const
@@ -588,15 +622,19 @@ void WindowNodeContainer::UpdateBrightness(uint32_t id, bool byRemoved)
     if (node->GetBrightness() == UNDEFINED_BRIGHTNESS) {
         if (GetDisplayBrightness() != node->GetBrightness()) {
             WLOGFI("adjust brightness with default value");
-            DisplayPowerMgr::DisplayPowerMgrClient::GetInstance().RestoreBrightness();
+            OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::BRIGHTNESS, 0, []() {
+                DisplayPowerMgr::DisplayPowerMgrClient::GetInstance().RestoreBrightness();
+            });
             SetDisplayBrightness(UNDEFINED_BRIGHTNESS); // UNDEFINED_BRIGHTNESS means system default brightness
         }
         SetBrightnessWindow(INVALID_WINDOW_ID);
     } else {
         if (GetDisplayBrightness() != node->GetBrightness()) {
-            WLOGFI("adjust brightness with value: %{public}u", ToOverrideBrightness(node->GetBrightness()));
-            DisplayPowerMgr::DisplayPowerMgrClient::GetInstance().OverrideBrightness(
-                ToOverrideBrightness(node->GetBrightness()));
+            uint32_t brightness = ToOverrideBrightness(node->GetBrightness());
+            WLOGFI("adjust brightness with value: %{public}u", brightness);
+            OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::BRIGHTNESS, 0, [brightness]() {
+                DisplayPowerMgr::DisplayPowerMgrClient::GetInstance().OverrideBrightness(brightness);
+            });
             SetDisplayBrightness(node->GetBrightness());
         }
         SetBrightnessWindow(node->GetWindowId());
@@ -606,23 +644,15 @@ void WindowNodeContainer::UpdateBrightness(uint32_t id, bool byRemoved)
 void WindowNodeContainer::AssignZOrder()
 {
     zOrder_ = 0;
-    WindowNodeOperationFunc func = [this](sptr<WindowNode> node) {
-        if (node->leashWinSurfaceNode_ != nullptr) {
-            node->leashWinSurfaceNode_->SetPositionZ(zOrder_);
-        }
-
-        if (node->surfaceNode_ != nullptr) {
-            node->surfaceNode_->SetPositionZ(zOrder_);
-        }
-
-        if (node->startingWinSurfaceNode_ != nullptr) {
-            node->startingWinSurfaceNode_->SetPositionZ(zOrder_);
-        }
+    auto windowNodes = GetZOrderedWindowNodes();
+    for (auto& node : *windowNodes) {
+        node->SetZOrder(zOrder_); // only writes to RS when z-order or surface nodes changed
         ++zOrder_;
-        return false;
-    };
-    TraverseWindowTree(func, false);
-    displayGroupController_->UpdateDisplayGroupWindowTree();
+    }
+    if (displayGroupWindowTreeGeneration_ != windowTreeGeneration_) {
+        displayGroupController_->UpdateDisplayGroupWindowTree();
+        displayGroupWindowTreeGeneration_ = windowTreeGeneration_;
+    }
 }
 
 WMError WindowNodeContainer::SetFocusWindow(uint32_t windowId)
@@ -714,33 +744,39 @@ sptr<WindowNode> WindowNodeContainer::GetRootNode(WindowRootNodeType type) const
 
 void WindowNodeContainer::HandleKeepScreenOn(const sptr<WindowNode>& node, bool requireLock)
 {
-    if (requireLock && node->keepScreenLock_ == nullptr) {
+    // the running lock of a node is only created and used on the outbound call worker
+    std::string windowName = node->GetWindowName();
+    OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::RUNNING_LOCK, node->GetWindowId(),
+        [node, windowName, requireLock]() {
+        if (requireLock && node->keepScreenLock_ == nullptr) {
+            // reset ipc identity
+            std::string identity = IPCSkeleton::ResetCallingIdentity();
+            node->keepScreenLock_ = PowerMgr::PowerMgrClient::GetInstance().CreateRunningLock(windowName,
+                PowerMgr::RunningLockType::RUNNINGLOCK_SCREEN);
+            // set ipc identity to raw
+            IPCSkeleton::SetCallingIdentity(identity);
+        }
+        if (node->keepScreenLock_ == nullptr) {
+            return;
+        }
+        WLOGFI("handle keep screen on: [%{public}s, %{public}d]", windowName.c_str(), requireLock);
+        HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "container:HandleKeepScreenOn(%s, %d)",
+            windowName.c_str(), requireLock);
+        ErrCode res;
         // reset ipc identity
         std::string identity = IPCSkeleton::ResetCallingIdentity();
-        node->keepScreenLock_ = PowerMgr::PowerMgrClient::GetInstance().CreateRunningLock(node->GetWindowName(),
-            PowerMgr::RunningLockType::RUNNINGLOCK_SCREEN);
+        if (requireLock) {
+            res = node->keepScreenLock_->Lock();
+        } else {
+            res = node->keepScreenLock_->UnLock();
+        }
         // set ipc identity to raw
         IPCSkeleton::SetCallingIdentity(identity);
-    }
-    if (node->keepScreenLock_ == nullptr) {
-        return;
-    }
-    WLOGFI("handle keep screen on: [%{public}s, %{public}d]", node->GetWindowName().c_str(), requireLock);
-    HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "container:HandleKeepScreenOn(%s, %d)",
-        node->GetWindowName().c_str(), requireLock);
-    ErrCode res;
-    // reset ipc identity
-    std::string identity = IPCSkeleton::ResetCallingIdentity();
-    if (requireLock) {
-        res = node->keepScreenLock_->Lock();
-    } else {
-        res = node->keepScreenLock_->UnLock();
-    }
-    // set ipc identity to raw
-    IPCSkeleton::SetCallingIdentity(identity);
-    if (res != ERR_OK) {
-        WLOGFE("handle keep screen running lock failed: [operation: %{public}d, err: %{public}d]", requireLock, res);
-    }
+        if (res != ERR_OK) {
+            WLOGFE("handle keep screen running lock failed: [operation: %{public}d, err: %{public}d]",
+                requireLock, res);
+        }
+    });
 }
 
 bool WindowNodeContainer::IsAboveSystemBarNode(sptr<WindowNode> node) const
@@ -998,6 +1034,7 @@ void WindowNodeContainer::RaiseOrderedWindowToTop(std::vector<sptr<WindowNode>>&
             [wid] (sptr<WindowNode> orderedNode) { return orderedNode->GetWindowId() == wid; });
         if (orderedIter != orderedNodes.end()) {
             iter = windowNodes.erase(iter);
+            MarkWindowTreeChanged();
         } else {
             iter++;
         }
@@ -1018,6 +1055,7 @@ void WindowNodeContainer::RaiseWindowToTop(uint32_t windowId, std::vector<sptr<W
     if (iter != windowNodes.end()) {
         sptr<WindowNode> node = *iter;
         windowNodes.erase(iter);
+        MarkWindowTreeChanged();
         UpdateWindowTree(node);
         WLOGFI("raise window to top %{public}u", node->GetWindowId());
     }
@@ -1025,19 +1063,40 @@ void WindowNodeContainer::RaiseWindowToTop(uint32_t windowId, std::vector<sptr<W
 
 void WindowNodeContainer::TraverseContainer(std::vector<sptr<WindowNode>>& windowNodes) const
 {
-    for (auto& node : belowAppWindowNode_->children_) {
-        TraverseWindowNode(node, windowNodes);
-    }
-    for (auto& node : appWindowNode_->children_) {
-        TraverseWindowNode(node, windowNodes);
+    auto zOrderedWindowNodes = GetZOrderedWindowNodes();
+    windowNodes.insert(windowNodes.end(), zOrderedWindowNodes->rbegin(), zOrderedWindowNodes->rend());
+}
+
+void WindowNodeContainer::MarkWindowTreeChanged()
+{
+    ++windowTreeGeneration_;
+}
+
+sptr<WindowNode> WindowNodeContainer::HitTest(const PointInfo& point, const HitTestFilterFunc& filter) const
+{
+    return hitTestIndex_->HitTest(point, filter);
+}
+
+std::shared_ptr<const std::vector<sptr<WindowNode>>> WindowNodeContainer::GetZOrderedWindowNodes() const
+{
+    if (zOrderedWindowNodes_ != nullptr && zOrderedWindowNodesGeneration_ == windowTreeGeneration_) {
+        return zOrderedWindowNodes_;
     }
-    for (auto& node : aboveAppWindowNode_->children_) {
-        TraverseWindowNode(node, windowNodes);
+    // a new vector is published instead of refilling the old one, so traversals in progress stay valid
+    auto windowNodes = std::make_shared<std::vector<sptr<WindowNode>>>();
+    windowNodes->reserve(zOrderedWindowNodes_ != nullptr ? zOrderedWindowNodes_->size() : 0);
+    for (auto& rootNode : { belowAppWindowNode_, appWindowNode_, aboveAppWindowNode_ }) {
+        for (auto& node : rootNode->children_) {
+            AppendZOrderedWindowNode(node, *windowNodes);
+        }
     }
-    std::reverse(windowNodes.begin(), windowNodes.end());
+    zOrderedWindowNodes_ = windowNodes;
+    zOrderedWindowNodesGeneration_ = windowTreeGeneration_;
+    return zOrderedWindowNodes_;
 }
 
-void WindowNodeContainer::TraverseWindowNode(sptr<WindowNode>& node, std::vector<sptr<WindowNode>>& windowNodes) const
+void WindowNodeContainer::AppendZOrderedWindowNode(const sptr<WindowNode>& node,
+    std::vector<sptr<WindowNode>>& windowNodes) const
 {
     if (node == nullptr) {
         return;
@@ -1066,16 +1125,7 @@ AvoidArea WindowNodeContainer::GetAvoidAreaByType(const sptr<WindowNode>& node,
 
 bool WindowNodeContainer::CheckWindowNodeWhetherInWindowTree(const sptr<WindowNode>& node) const
 {
-    bool isInWindowTree = false;
-    WindowNodeOperationFunc func = [&node, &isInWindowTree](sptr<WindowNode> windowNode) {
-        if (node->GetWindowId() == windowNode->GetWindowId()) {
-            isInWindowTree = true;
-            return true;
-        }
-        return false;
-    };
-    TraverseWindowTree(func, true);
-    return isInWindowTree;
+    return FindWindowNodeById(node->GetWindowId()) != nullptr;
 }
 
 void WindowNodeContainer::DumpScreenWindowTree()
@@ -1597,6 +1647,7 @@ void WindowNodeContainer::ReZOrderShowWhenLockedWindows(bool up)
             iter++;
         }
     }
+    MarkWindowTreeChanged();
 
     for (auto& needReZOrderNode : needReZOrderNodes) {
         needReZOrderNode->priority_ = dstPriority;
@@ -1613,6 +1664,7 @@ void WindowNodeContainer::ReZOrderShowWhenLockedWindows(bool up)
         UpdateModeSupportInfoWhenKeyguardChange(needReZOrderNode, up);
 
         parentNode->children_.insert(position, needReZOrderNode);
+        MarkWindowTreeChanged();
         if (up && WindowHelper::IsSplitWindowMode(needReZOrderNode->GetWindowMode())) {
             needReZOrderNode->GetWindowProperty()->ResumeLastWindowMode();
             if (needReZOrderNode->GetWindowToken() != nullptr) {
@@ -1676,76 +1728,20 @@ void WindowNodeContainer::DropShowWhenLockedWindowIfNeeded(const sptr<WindowNode
 
 void WindowNodeContainer::TraverseWindowTree(const WindowNodeOperationFunc& func, bool isFromTopToBottom) const
 {
-    std::vector<sptr<WindowNode>> rootNodes = { belowAppWindowNode_, appWindowNode_, aboveAppWindowNode_ };
+    auto windowNodes = GetZOrderedWindowNodes();
     if (isFromTopToBottom) {
-        std::reverse(rootNodes.begin(), rootNodes.end());
-    }
-
-    for (auto& node : rootNodes) {
-        if (isFromTopToBottom) {
-            for (auto iter = node->children_.rbegin(); iter != node->children_.rend(); ++iter) {
-                if (TraverseFromTopToBottom(*iter, func)) {
-                    return;
-                }
-            }
-        } else {
-            for (auto iter = node->children_.begin(); iter != node->children_.end(); ++iter) {
-                if (TraverseFromBottomToTop(*iter, func)) {
-                    return;
-                }
+        for (auto iter = windowNodes->rbegin(); iter != windowNodes->rend(); ++iter) {
+            if (func(*iter)) {
+                return;
             }
         }
-    }
-}
-
-bool WindowNodeContainer::TraverseFromTopToBottom(sptr<WindowNode> node, const WindowNodeOperationFunc& func) const
-{
-    if (node == nullptr) {
-        return false;
-    }
-    auto iterBegin = node->children_.rbegin();
-    for (; iterBegin != node->children_.rend(); ++iterBegin) {
-        if ((*iterBegin)->priority_ <= 0) {
-            break;
-        }
-        if (func(*iterBegin)) {
-            return true;
-        }
-    }
-    if (func(node)) {
-        return true;
-    }
-    for (; iterBegin != node->children_.rend(); ++iterBegin) {
-        if (func(*iterBegin)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-bool WindowNodeContainer::TraverseFromBottomToTop(sptr<WindowNode> node, const WindowNodeOperationFunc& func) const
-{
-    if (node == nullptr) {
-        return false;
-    }
-    auto iterBegin = node->children_.begin();
-    for (; iterBegin != node->children_.end(); ++iterBegin) {
-        if ((*iterBegin)->priority_ >= 0) {
-            break;
-        }
-        if (func(*iterBegin)) {
-            return true;
-        }
-    }
-    if (func(node)) {
-        return true;
-    }
-    for (; iterBegin != node->children_.end(); ++iterBegin) {
-        if (func(*iterBegin)) {
-            return true;
+    } else {
+        for (auto iter = windowNodes->begin(); iter != windowNodes->end(); ++iter) {
+            if (func(*iter)) {
+                return;
+            }
         }
     }
-    return false;
 }
 
 float WindowNodeContainer::GetVirtualPixelRatio(DisplayId displayId) const
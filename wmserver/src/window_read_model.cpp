@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "window_read_model.h"
+
+namespace OHOS {
+namespace Rosen {
+AvoidArea WindowReadModel::GetAvoidAreaByType(uint32_t windowId, AvoidAreaType avoidAreaType) const
+{
+    auto iter = windowInfos_.find(windowId);
+    if (iter == windowInfos_.end()) {
+        return {};
+    }
+    auto avoidAreaIter = iter->second.avoidAreas_.find(avoidAreaType);
+    if (avoidAreaIter == iter->second.avoidAreas_.end()) {
+        return {};
+    }
+    return avoidAreaIter->second;
+}
+
+WMError WindowReadModel::GetTopWindowId(uint32_t mainWinId, uint32_t& topWinId) const
+{
+    auto iter = windowInfos_.find(mainWinId);
+    if (iter == windowInfos_.end()) {
+        return WMError::WM_ERROR_INVALID_WINDOW;
+    }
+    topWinId = iter->second.topWindowId_;
+    return WMError::WM_OK;
+}
+
+WMError WindowReadModel::GetModeChangeHotZones(DisplayId displayId, ModeChangeHotZones& hotZones) const
+{
+    auto iter = hotZones_.find(displayId);
+    if (iter == hotZones_.end()) {
+        return WMError::WM_ERROR_NULLPTR;
+    }
+    hotZones = iter->second;
+    return WMError::WM_OK;
+}
+
+void WindowReadModel::GetAccessibilityWindowInfo(sptr<AccessibilityWindowInfo>& windowInfo) const
+{
+    // window infos are not modified after publishing, so they are shared rather than copied
+    windowInfo->windowList_.insert(windowInfo->windowList_.end(),
+        accessibilityWindowList_.begin(), accessibilityWindowList_.end());
+}
+} // namespace Rosen
+} // namespace OHOS
@@ -22,6 +22,7 @@
 #include <transaction/rs_transaction.h>
 
 #include "display_manager_service_inner.h"
+#include "outbound_call_worker.h"
 #include "window_helper.h"
 #include "window_manager_hilog.h"
 #include "window_manager_service.h"
@@ -160,18 +161,17 @@ sptr<WindowNode> WindowRoot::FindWindowNodeWithToken(const sptr<IRemoteObject>&
         WLOGFE("token is null");
         return nullptr;
     }
-    auto iter = std::find_if(windowNodeMap_.begin(), windowNodeMap_.end(),
-        [token](const std::map<uint32_t, sptr<WindowNode>>::value_type& pair) {
-            if (!(WindowHelper::IsSubWindow(pair.second->GetWindowType()))) {
-                return pair.second->abilityToken_ == token;
+    auto iter = abilityTokenWindowIdMap_.find(token);
+    if (iter != abilityTokenWindowIdMap_.end()) {
+        for (auto windowId : iter->second) {
+            auto node = GetWindowNode(windowId);
+            if (node != nullptr && !WindowHelper::IsSubWindow(node->GetWindowType())) {
+                return node;
             }
-            return false;
-        });
-    if (iter == windowNodeMap_.end()) {
-        WLOGFI("cannot find windowNode");
-        return nullptr;
+        }
     }
-    return iter->second;
+    WLOGFI("cannot find windowNode");
+    return nullptr;
 }
 
 void WindowRoot::AddDeathRecipient(sptr<WindowNode> node)
@@ -203,8 +203,9 @@ WMError WindowRoot::SaveWindow(const sptr<WindowNode>& node)
     WLOGFI("save windowId %{public}u", node->GetWindowId());
     windowNodeMap_.insert(std::make_pair(node->GetWindowId(), node));
     if (node->surfaceNode_ != nullptr) {
-        surfaceIdWindowNodeMap_.insert(std::make_pair(node->surfaceNode_->GetId(), node));
+        AddSurfaceNodeIdWindowNodePair(node->surfaceNode_->GetId(), node);
     }
+    AddWindowNodeIndex(node);
     if (node->GetWindowToken()) {
         AddDeathRecipient(node);
     }
@@ -280,9 +281,51 @@ void WindowRoot::ExitSplitMode(DisplayId displayId)
     container->ExitSplitMode(displayId);
 }
 
+sptr<WindowNode> WindowRoot::HitTest(DisplayId displayId, const PointInfo& point, const HitTestFilterFunc& filter)
+{
+    auto container = GetOrCreateWindowNodeContainer(displayId);
+    if (container == nullptr) {
+        WLOGFE("get container failed %{public}" PRIu64"", displayId);
+        return nullptr;
+    }
+    return container->HitTest(point, filter);
+}
+
 void WindowRoot::AddSurfaceNodeIdWindowNodePair(uint64_t surfaceNodeId, sptr<WindowNode> node)
 {
-    surfaceIdWindowNodeMap_.insert(std::make_pair(surfaceNodeId, node));
+    if (node == nullptr) {
+        return;
+    }
+    if (surfaceIdWindowNodeMap_.insert(std::make_pair(surfaceNodeId, node)).second) {
+        windowIdSurfaceIdMap_[node->GetWindowId()].push_back(surfaceNodeId);
+    }
+}
+
+void WindowRoot::AddWindowNodeIndex(const sptr<WindowNode>& node)
+{
+    abilityTokenWindowIdMap_[node->abilityToken_].insert(node->GetWindowId());
+    if (node->GetWindowType() == WindowType::WINDOW_TYPE_DIALOG) {
+        dialogTargetWindowIdMap_[node->dialogTargetToken_].insert(node->GetWindowId());
+    }
+}
+
+void WindowRoot::RemoveWindowNodeIndex(const sptr<WindowNode>& node)
+{
+    auto eraseFromIndex = [](std::map<sptr<IRemoteObject>, std::set<uint32_t>>& index,
+        const sptr<IRemoteObject>& token, uint32_t windowId) {
+        auto iter = index.find(token);
+        if (iter == index.end()) {
+            return;
+        }
+        iter->second.erase(windowId);
+        if (iter->second.empty()) {
+            index.erase(iter);
+        }
+    };
+    eraseFromIndex(abilityTokenWindowIdMap_, node->abilityToken_, node->GetWindowId());
+    if (node->GetWindowType() == WindowType::WINDOW_TYPE_DIALOG) {
+        eraseFromIndex(dialogTargetWindowIdMap_, node->dialogTargetToken_, node->GetWindowId());
+    }
 }
 
 std::vector<std::pair<uint64_t, bool>> WindowRoot::GetWindowVisibilityChangeInfo(
@@ -332,6 +375,7 @@ void WindowRoot::NotifyWindowVisibilityChange(std::shared_ptr<RSOcclusionData> o
             continue;
         }
         node->isVisible_ = isVisible;
+        node->UpdateContentGeneration();
         windowVisibilityInfos.emplace_back(new WindowVisibilityInfo(node->GetWindowId(), node->GetCallingPid(),
             node->GetCallingUid(), isVisible, node->GetWindowType()));
         WLOGFD("NotifyWindowVisibilityChange: covered status changed window:%{public}u, isVisible:%{public}d",
@@ -458,8 +502,7 @@ WMError WindowRoot::PostProcessAddWindowNode(sptr<WindowNode>& node, sptr<Window
         node->GetWindowId(), node->GetWindowName().c_str(), static_cast<uint32_t>(node->GetRequestedOrientation()),
         node->GetWindowType(), WindowHelper::IsMainWindow(node->GetWindowType()));
     if (WindowHelper::IsRotatableWindow(node->GetWindowType(), node->GetWindowMode())) {
-        DisplayManagerServiceInner::GetInstance().
-            SetOrientationFromWindow(node->GetDisplayId(), node->GetRequestedOrientation());
+        SetOrientationFromWindow(node);
     }
     return WMError::WM_OK;
 }
@@ -572,8 +615,7 @@ WMError WindowRoot::RemoveWindowNode(uint32_t windowId)
     }
     if (nextOrientationWindow != nullptr && WindowHelper::IsRotatableWindow(
         nextOrientationWindow->GetWindowType(), nextOrientationWindow->GetWindowMode())) {
-        DisplayManagerServiceInner::GetInstance().SetOrientationFromWindow(nextOrientationWindow->GetDisplayId(),
-            nextOrientationWindow->GetRequestedOrientation());
+        SetOrientationFromWindow(nextOrientationWindow);
     }
     return res;
 }
@@ -593,6 +635,24 @@ WMError WindowRoot::UpdateWindowNode(uint32_t windowId, WindowUpdateReason reaso
     return container->UpdateWindowNode(node, reason);
 }
 
+WMError WindowRoot::MoveWindowNode(uint32_t windowId, const Rect& requestRect)
+{
+    auto node = GetWindowNode(windowId);
+    if (node == nullptr) {
+        WLOGFE("could not find window");
+        return WMError::WM_ERROR_NULLPTR;
+    }
+    auto container = GetOrCreateWindowNodeContainer(node->GetDisplayId());
+    if (container == nullptr) {
+        WLOGFE("move window failed, window container could not be found");
+        return WMError::WM_ERROR_NULLPTR;
+    }
+    if (!container->MoveWindowNode(node, requestRect)) {
+        return WMError::WM_ERROR_INVALID_OPERATION;
+    }
+    return WMError::WM_OK;
+}
+
 WMError WindowRoot::UpdateSizeChangeReason(uint32_t windowId, WindowSizeChangeReason reason)
 {
     auto node = GetWindowNode(windowId);
@@ -627,15 +687,28 @@ void WindowRoot::SetBrightness(uint32_t windowId, float brightness)
     }
     if (windowId == container->GetActiveWindow()) {
         if (container->GetDisplayBrightness() != brightness) {
-            WLOGFI("set brightness with value: %{public}u", container->ToOverrideBrightness(brightness));
-            DisplayPowerMgr::DisplayPowerMgrClient::GetInstance().OverrideBrightness(
-                container->ToOverrideBrightness(brightness));
+            uint32_t overrideBrightness = container->ToOverrideBrightness(brightness);
+            WLOGFI("set brightness with value: %{public}u", overrideBrightness);
+            OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::BRIGHTNESS, 0, [overrideBrightness]() {
+                DisplayPowerMgr::DisplayPowerMgrClient::GetInstance().OverrideBrightness(overrideBrightness);
+            });
             container->SetDisplayBrightness(brightness);
         }
         container->SetBrightnessWindow(windowId);
     }
 }
 
+void WindowRoot::SetOrientationFromWindow(const sptr<WindowNode>& node)
+{
+    DisplayId displayId = node->GetDisplayId();
+    Orientation orientation = node->GetRequestedOrientation();
+    // a newer orientation request of the display replaces one DMS has not been asked for yet
+    OutboundCallWorker::GetInstance().PostCall(OutboundCallTarget::DISPLAY_ORIENTATION, displayId,
+        [displayId, orientation]() {
+            DisplayManagerServiceInner::GetInstance().SetOrientationFromWindow(displayId, orientation);
+        });
+}
+
 void WindowRoot::HandleKeepScreenOn(uint32_t windowId, bool requireLock)
 {
     auto node = GetWindowNode(windowId);
@@ -683,8 +756,7 @@ WMError WindowRoot::SetWindowMode(sptr<WindowNode>& node, WindowMode dstMode)
     }
     auto res = container->SetWindowMode(node, dstMode);
     if (WindowHelper::IsRotatableWindow(node->GetWindowType(), node->GetWindowMode())) {
-        DisplayManagerServiceInner::GetInstance().
-            SetOrientationFromWindow(node->GetDisplayId(), node->GetRequestedOrientation());
+        SetOrientationFromWindow(node);
     }
     return res;
 }
@@ -756,18 +828,12 @@ WMError WindowRoot::DestroyWindowInner(sptr<WindowNode>& node)
         node->GetWindowId(), node->isVisible_);
     WindowManagerAgentController::GetInstance().UpdateWindowVisibilityInfo(windowVisibilityInfos);
 
-    auto cmpFunc = [node](const std::map<uint64_t, sptr<WindowNode>>::value_type& pair) {
-        if (pair.second == nullptr) {
-            return false;
+    auto surfaceIter = windowIdSurfaceIdMap_.find(node->GetWindowId());
+    if (surfaceIter != windowIdSurfaceIdMap_.end()) {
+        for (auto surfaceId : surfaceIter->second) {
+            surfaceIdWindowNodeMap_.erase(surfaceId);
         }
-        if (pair.second->GetWindowId() == node->GetWindowId()) {
-            return true;
-        }
-        return false;
-    };
-    auto iter = std::find_if(surfaceIdWindowNodeMap_.begin(), surfaceIdWindowNodeMap_.end(), cmpFunc);
-    if (iter != surfaceIdWindowNodeMap_.end()) {
-        surfaceIdWindowNodeMap_.erase(iter);
+        windowIdSurfaceIdMap_.erase(surfaceIter);
     }
 
     sptr<IWindow> window = node->GetWindowToken();
@@ -782,6 +848,7 @@ WMError WindowRoot::DestroyWindowInner(sptr<WindowNode>& node)
         }
         windowIdMap_.erase(window->AsObject());
     }
+    RemoveWindowNodeIndex(node);
     windowNodeMap_.erase(node->GetWindowId());
     WLOGFI("destroy window node use_count:%{public}d", node->GetSptrRefCount());
     return WMError::WM_OK;
@@ -930,19 +997,25 @@ WMError WindowRoot::RequestActiveWindow(uint32_t windowId)
         node->GetWindowType(), WindowHelper::IsMainWindow(node->GetWindowType()));
     if (res == WMError::WM_OK &&
         WindowHelper::IsRotatableWindow(node->GetWindowType(), node->GetWindowMode())) {
-        DisplayManagerServiceInner::GetInstance().
-            SetOrientationFromWindow(node->GetDisplayId(), node->GetRequestedOrientation());
+        SetOrientationFromWindow(node);
     }
     return res;
 }
 
 std::shared_ptr<RSSurfaceNode> WindowRoot::GetSurfaceNodeByAbilityToken(const sptr<IRemoteObject>& abilityToken) const
 {
-    for (const auto& iter : windowNodeMap_) {
-        if (iter.second->abilityToken_ != abilityToken) {
-            continue;
+    auto node = GetWindowNodeByAbilityToken(abilityToken);
+    return (node != nullptr) ? node->surfaceNode_ : nullptr;
+}
+
+sptr<WindowNode> WindowRoot::GetWindowNodeByAbilityToken(const sptr<IRemoteObject>& abilityToken) const
+{
+    auto iter = abilityTokenWindowIdMap_.find(abilityToken);
+    if (iter != abilityTokenWindowIdMap_.end() && !iter->second.empty()) {
+        auto node = GetWindowNode(*iter->second.begin());
+        if (node != nullptr) {
+            return node;
         }
-        return iter.second->surfaceNode_;
     }
     WLOGFE("could not find required abilityToken!");
     return nullptr;
@@ -1041,6 +1114,47 @@ WMError WindowRoot::GetTopWindowId(uint32_t mainWinId, uint32_t& topWinId)
     return WMError::WM_OK;
 }
 
+void WindowRoot::GetWindowReadInfos(std::unordered_map<uint32_t, WindowReadInfo>& windowInfos)
+{
+    for (auto& iter : windowNodeMap_) {
+        const sptr<WindowNode>& node = iter.second;
+        if (node == nullptr || !node->currentVisibility_) {
+            continue;
+        }
+        FillWindowReadInfo(node, windowInfos[iter.first]);
+    }
+}
+
+void WindowRoot::UpdateWindowReadInfo(uint32_t windowId, std::unordered_map<uint32_t, WindowReadInfo>& windowInfos)
+{
+    auto node = GetWindowNode(windowId);
+    if (node == nullptr || !node->currentVisibility_) {
+        windowInfos.erase(windowId);
+        return;
+    }
+    WindowReadInfo info;
+    FillWindowReadInfo(node, info);
+    windowInfos[windowId] = info;
+}
+
+void WindowRoot::FillWindowReadInfo(const sptr<WindowNode>& node, WindowReadInfo& info)
+{
+    static const std::vector<AvoidAreaType> avoidAreaTypes = {
+        AvoidAreaType::TYPE_SYSTEM,
+        AvoidAreaType::TYPE_CUTOUT,
+        AvoidAreaType::TYPE_SYSTEM_GESTURE,
+        AvoidAreaType::TYPE_KEYBOARD,
+    };
+    GetTopWindowId(node->GetWindowId(), info.topWindowId_);
+    sptr<WindowNodeContainer> container = GetOrCreateWindowNodeContainer(node->GetDisplayId());
+    if (container == nullptr) {
+        return;
+    }
+    for (auto avoidAreaType : avoidAreaTypes) {
+        info.avoidAreas_[avoidAreaType] = container->GetAvoidAreaByType(node, avoidAreaType);
+    }
+}
+
 WMError WindowRoot::SetWindowLayoutMode(DisplayId displayId, WindowLayoutMode mode)
 {
     auto container = GetOrCreateWindowNodeContainer(displayId);
@@ -1420,18 +1534,17 @@ sptr<WindowNode> WindowRoot::FindDialogCallerNode(WindowType type, sptr<IRemoteO
         return nullptr;
     }
 
-    auto iter = std::find_if(windowNodeMap_.begin(), windowNodeMap_.end(),
-        [token](const std::map<uint32_t, sptr<WindowNode>>::value_type& pair) {
-            if (WindowHelper::IsMainWindow(pair.second->GetWindowType())) {
-                return pair.second->abilityToken_ == token;
+    auto iter = abilityTokenWindowIdMap_.find(token);
+    if (iter != abilityTokenWindowIdMap_.end()) {
+        for (auto windowId : iter->second) {
+            auto node = GetWindowNode(windowId);
+            if (node != nullptr && WindowHelper::IsMainWindow(node->GetWindowType())) {
+                return node;
             }
-            return false;
-        });
-    if (iter == windowNodeMap_.end()) {
-        WLOGFI("cannot find windowNode");
-        return nullptr;
+        }
     }
-    return iter->second;
+    WLOGFI("cannot find windowNode");
+    return nullptr;
 }
 
 bool WindowRoot::CheckMultiDialogWindows(WindowType type, sptr<IRemoteObject> token)
@@ -1440,23 +1553,30 @@ bool WindowRoot::CheckMultiDialogWindows(WindowType type, sptr<IRemoteObject> to
         return false;
     }
 
-    sptr<WindowNode> newCaller, oriCaller;
-
-    newCaller = FindDialogCallerNode(type, token);
+    sptr<WindowNode> newCaller = FindDialogCallerNode(type, token);
     if (newCaller == nullptr) {
         return false;
     }
 
-    for (auto& iter : windowNodeMap_) {
-        if (iter.second->GetWindowType() == WindowType::WINDOW_TYPE_DIALOG) {
-            oriCaller = FindDialogCallerNode(iter.second->GetWindowType(), iter.second->dialogTargetToken_);
-            if (oriCaller == newCaller) {
-                return true;
-            }
-        }
-    }
+    // the caller of a dialog is the first main window owning its target token, so an existing dialog shares
+    // the caller with the new one exactly when it targets the same token
+    auto iter = dialogTargetWindowIdMap_.find(token);
+    return iter != dialogTargetWindowIdMap_.end() && !iter->second.empty();
+}
 
-    return false;
+void WindowRoot::BindDialogTarget(const sptr<WindowNode>& node, sptr<IRemoteObject> targetToken)
+{
+    if (node == nullptr) {
+        return;
+    }
+    bool isSaved = GetWindowNode(node->GetWindowId()) == node;
+    if (isSaved) {
+        RemoveWindowNodeIndex(node);
+    }
+    node->dialogTargetToken_ = targetToken;
+    if (isSaved) {
+        AddWindowNodeIndex(node);
+    }
 }
 } // namespace Rosen
 } // namespace OHOS
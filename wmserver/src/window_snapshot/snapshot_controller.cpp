@@ -15,12 +15,14 @@
 
 #include "snapshot_controller.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cinttypes>
 #include <hisysevent.h>
 #include <hitrace_meter.h>
+#include <iterator>
 #include <sstream>
 
-#include "surface_capture_future.h"
 #include "window_manager_hilog.h"
 #include "wm_common.h"
 
@@ -29,6 +31,65 @@ namespace Rosen {
 namespace {
     constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_DISPLAY, "SnapshotController"};
     constexpr int REPORT_SHOW_WINDOW_TIMES = 50;
+    constexpr size_t SNAPSHOT_CACHE_MAX_NUM = 8;
+    constexpr int64_t SNAPSHOT_TIMEOUT_MS = 2000;
+    const std::string SNAPSHOT_TIMEOUT_THREAD_NAME = "SnapshotTimeout";
+}
+
+void SnapshotRequest::Cancel()
+{
+    isFinished_.store(true);
+}
+
+bool SnapshotRequest::IsFinished() const
+{
+    return isFinished_.load();
+}
+
+bool SnapshotRequest::Complete(WMError ret, const std::shared_ptr<Media::PixelMap>& pixelMap)
+{
+    if (isFinished_.exchange(true)) {
+        return false;
+    }
+    if (callback_) {
+        callback_(ret, pixelMap);
+    }
+    return true;
+}
+
+int64_t SnapshotRequest::GetElapsedTime() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+        startTime_).count();
+}
+
+void SnapshotCapture::OnSurfaceCapture(std::shared_ptr<Media::PixelMap> pixelMap)
+{
+    std::vector<CaptureListener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (isFinished_) {
+            return;
+        }
+        isFinished_ = true;
+        pixelMap_ = pixelMap;
+        listeners.swap(listeners_);
+    }
+    for (auto& listener : listeners) {
+        listener(pixelMap);
+    }
+}
+
+void SnapshotCapture::AddListener(CaptureListener listener)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!isFinished_) {
+            listeners_.push_back(std::move(listener));
+            return;
+        }
+    }
+    listener(pixelMap_);
 }
 
 void SnapshotController::Init(sptr<WindowRoot>& root)
@@ -36,54 +97,172 @@ void SnapshotController::Init(sptr<WindowRoot>& root)
     windowRoot_ = root;
 }
 
-WMError SnapshotController::TakeSnapshot(const std::shared_ptr<RSSurfaceNode>& surfaceNode, Snapshot& snapshot)
+std::shared_ptr<AppExecFwk::EventHandler> SnapshotController::CreateTimeoutHandler()
 {
-    std::shared_ptr<SurfaceCaptureFuture> callback = std::make_shared<SurfaceCaptureFuture>();
-    rsInterface_.TakeSurfaceCapture(surfaceNode, callback, scaleW, scaleH);
-    std::shared_ptr<Media::PixelMap> pixelMap = callback->GetResult(2000); // wait for <= 2000ms
-    if (pixelMap == nullptr) {
-        WLOGFE("Failed to get pixelmap, return nullptr!");
-        return WMError::WM_ERROR_NULLPTR;
+    return std::make_shared<AppExecFwk::EventHandler>(AppExecFwk::EventRunner::Create(SNAPSHOT_TIMEOUT_THREAD_NAME));
+}
+
+std::shared_ptr<SnapshotCapture> SnapshotController::GetOrCreateCapture(const SnapshotCacheKey& key,
+    std::chrono::steady_clock::time_point deadline, bool& isNewCapture)
+{
+    std::lock_guard<std::mutex> lock(snapshotCacheMutex_);
+    auto now = std::chrono::steady_clock::now();
+    RemoveExpiredCapturesLocked(now);
+    for (auto iter = snapshotCache_.begin(); iter != snapshotCache_.end();) {
+        bool isOlderGeneration = iter->first.nodeId_ == key.nodeId_ &&
+            iter->first.contentGeneration_ != key.contentGeneration_;
+        iter = isOlderGeneration ? snapshotCache_.erase(iter) : std::next(iter);
+    }
+    auto iter = snapshotCache_.find(key);
+    if (iter != snapshotCache_.end()) {
+        iter->second.deadline_ = std::max(iter->second.deadline_, deadline);
+        isNewCapture = false;
+        return iter->second.capture_;
+    }
+    if (snapshotCache_.size() >= SNAPSHOT_CACHE_MAX_NUM) {
+        auto oldest = std::min_element(snapshotCache_.begin(), snapshotCache_.end(),
+            [](const auto& left, const auto& right) {
+                return left.second.requestTime_ < right.second.requestTime_;
+            });
+        snapshotCache_.erase(oldest);
     }
-    snapshot.SetPixelMap(pixelMap);
-    return WMError::WM_OK;
+    auto capture = std::make_shared<SnapshotCapture>();
+    snapshotCache_[key] = { capture, now, deadline };
+    isNewCapture = true;
+    return capture;
 }
 
-int32_t SnapshotController::GetSnapshot(const sptr<IRemoteObject> &token, Snapshot& snapshot)
+void SnapshotController::RemoveExpiredCapturesLocked(std::chrono::steady_clock::time_point now)
+{
+    for (auto iter = snapshotCache_.begin(); iter != snapshotCache_.end();) {
+        iter = (iter->second.deadline_ <= now) ? snapshotCache_.erase(iter) : std::next(iter);
+    }
+}
+
+void SnapshotController::RemoveExpiredCaptures()
+{
+    std::lock_guard<std::mutex> lock(snapshotCacheMutex_);
+    RemoveExpiredCapturesLocked(std::chrono::steady_clock::now());
+}
+
+void SnapshotController::RemoveCapture(const SnapshotCacheKey& key,
+    const std::shared_ptr<SnapshotCapture>& capture)
+{
+    std::lock_guard<std::mutex> lock(snapshotCacheMutex_);
+    auto iter = snapshotCache_.find(key);
+    if (iter != snapshotCache_.end() && iter->second.capture_ == capture) {
+        snapshotCache_.erase(iter);
+    }
+}
+
+void SnapshotController::TakeSnapshot(const std::shared_ptr<RSSurfaceNode>& surfaceNode,
+    uint32_t contentGeneration, const std::shared_ptr<SnapshotRequest>& request,
+    std::chrono::steady_clock::time_point deadline)
+{
+    SnapshotCacheKey key = { surfaceNode->GetId(), scaleW, scaleH, contentGeneration };
+    bool isNewCapture = false;
+    std::shared_ptr<SnapshotCapture> capture = GetOrCreateCapture(key, deadline, isNewCapture);
+    // the capture keeps its listeners until it finishes, a strong reference here would never be released
+    std::weak_ptr<SnapshotCapture> weakCapture = capture;
+    capture->AddListener([this, key, weakCapture, request](const std::shared_ptr<Media::PixelMap>& pixelMap) {
+        // the server does not see client redraws, so only a capture in flight is shared, never a finished one
+        RemoveCapture(key, weakCapture.lock());
+        if (pixelMap == nullptr) {
+            WLOGFE("Failed to get pixelmap, return nullptr!");
+            FinishRequest(request, WMError::WM_ERROR_NULLPTR, nullptr);
+            return;
+        }
+        FinishRequest(request, WMError::WM_OK, pixelMap);
+    });
+    if (isNewCapture) {
+        rsInterface_.TakeSurfaceCapture(surfaceNode, capture, scaleW, scaleH);
+    } else {
+        WLOGFD("join capture of node %{public}" PRIu64", generation %{public}u", key.nodeId_, contentGeneration);
+    }
+}
+
+void SnapshotController::FinishRequest(const std::shared_ptr<SnapshotRequest>& request, WMError ret,
+    const std::shared_ptr<Media::PixelMap>& pixelMap)
+{
+    if (!request->Complete(ret, pixelMap) || ret != WMError::WM_OK) {
+        return;
+    }
+    getSnapshotTimeConfig_.getSnapshotTimes_++;
+    RecordGetSnapshotEvent(request->GetElapsedTime());
+}
+
+std::shared_ptr<SnapshotRequest> SnapshotController::GetSnapshotAsync(const sptr<IRemoteObject>& token,
+    SnapshotCallback callback, int64_t timeoutMs)
 {
-    HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:GetSnapshot");
-    auto startTime = std::chrono::steady_clock::now();
     if (token == nullptr) {
         WLOGFE("Get snapshot failed, because token is null.");
-        return static_cast<int32_t>(WMError::WM_ERROR_NULLPTR);
+        return nullptr;
     }
-    if (handler_ == nullptr) {
+    if (timeoutHandler_ == nullptr || taskPoster_ == nullptr) {
         WLOGFE("Get snapshot failed, because handler is null.");
-        return static_cast<int32_t>(WMError::WM_ERROR_NULLPTR);
+        return nullptr;
     }
-    std::shared_ptr<RSSurfaceNode> surfaceNode;
-    auto task = [this, &surfaceNode, token] () {
-        if (windowRoot_ == nullptr || token == nullptr) {
-            surfaceNode = nullptr;
+    auto request = std::make_shared<SnapshotRequest>(std::move(callback));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    auto timeoutTask = [this, request] () {
+        // a capture no request waits for any more is given up, the next request issues a new one
+        RemoveExpiredCaptures();
+        if (!request->IsFinished()) {
+            WLOGFE("Get snapshot timeout after %{public}" PRId64" ms", request->GetElapsedTime());
+            FinishRequest(request, WMError::WM_ERROR_NULLPTR, nullptr);
+        }
+    };
+    if (!timeoutHandler_->PostTask(timeoutTask, timeoutMs, AppExecFwk::EventQueue::Priority::IMMEDIATE)) {
+        WLOGFE("Get snapshot failed, because the timeout task could not be posted.");
+        return nullptr;
+    }
+    auto task = [this, token, request, deadline] () {
+        if (request->IsFinished()) {
+            return;
+        }
+        if (windowRoot_ == nullptr) {
             WLOGFE("Get snapshot failed, because windowRoot is null.");
+            FinishRequest(request, WMError::WM_ERROR_NULLPTR, nullptr);
             return;
         }
-        surfaceNode = windowRoot_->GetSurfaceNodeByAbilityToken(token);
+        auto node = windowRoot_->GetWindowNodeByAbilityToken(token);
+        if (node == nullptr || node->surfaceNode_ == nullptr) {
+            WLOGFE("Get surfaceNode failed, because surfaceNode is null");
+            FinishRequest(request, WMError::WM_ERROR_NULLPTR, nullptr);
+            return;
+        }
+        TakeSnapshot(node->surfaceNode_, node->GetContentGeneration(), request, deadline);
     };
-    // post sync task to wms main handler
-    handler_->PostSyncTask(task, AppExecFwk::EventQueue::Priority::IMMEDIATE);
-    if (surfaceNode == nullptr) {
-        WLOGFE("Get surfaceNode failed, because surfaceNode is null");
+    // the token lookup is bookkeeping and must not overtake input
+    if (!taskPoster_(task)) {
+        WLOGFE("Get snapshot failed, because the lookup task could not be posted.");
+        // the timeout task finds the request finished and does not call back
+        request->Cancel();
+        return nullptr;
+    }
+    return request;
+}
+
+int32_t SnapshotController::GetSnapshot(const sptr<IRemoteObject> &token, Snapshot& snapshot)
+{
+    HITRACE_METER_FMT(HITRACE_TAG_WINDOW_MANAGER, "wms:GetSnapshot");
+    using SnapshotResult = std::pair<WMError, std::shared_ptr<Media::PixelMap>>;
+    auto future = std::make_shared<RunnableFuture<SnapshotResult>>();
+    future->Reset({ WMError::WM_ERROR_NULLPTR, nullptr });
+    auto request = GetSnapshotAsync(token, [future](WMError ret, const std::shared_ptr<Media::PixelMap>& pixelMap) {
+        future->SetValue({ ret, pixelMap });
+    }, SNAPSHOT_TIMEOUT_MS);
+    if (request == nullptr) {
         return static_cast<int32_t>(WMError::WM_ERROR_NULLPTR);
     }
-    WMError res = TakeSnapshot(surfaceNode, snapshot);
-    if (res == WMError::WM_OK) {
-        getSnapshotTimeConfig_.getSnapshotTimes_++;
-        auto currentTime = std::chrono::steady_clock::now();
-        int64_t costTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime).count();
-        RecordGetSnapshotEvent(costTime);
+    // the binder thread gives up at the same deadline as the request, whichever thread notices it first
+    SnapshotResult result = future->GetResult(SNAPSHOT_TIMEOUT_MS);
+    request->Cancel();
+    if (result.first != WMError::WM_OK || result.second == nullptr) {
+        return static_cast<int32_t>(WMError::WM_ERROR_NULLPTR);
     }
-    return static_cast<int32_t>(res);
+    snapshot.SetPixelMap(result.second);
+    return static_cast<int32_t>(WMError::WM_OK);
 }
 
 void SnapshotController::RecordGetSnapshotEvent(int64_t costTime)
@@ -16,6 +16,7 @@
 #include "zidl/window_manager_proxy.h"
 #include <ipc_types.h>
 #include <rs_iwindow_animation_controller.h>
+#include "marshalling_helper.h"
 #include "window_manager_hilog.h"
 
 namespace OHOS {
@@ -589,7 +590,7 @@ void WindowManagerProxy::MinimizeWindowsByLauncher(std::vector<uint32_t> windowI
         return;
     }
 
-    if (!data.WriteUInt32Vector(windowIds)) {
+    if (!MarshallingHelper::MarshallingVectorPodObj<uint32_t>(data, windowIds)) {
         WLOGFE("Write windowIds failed");
         return;
     }
@@ -16,6 +16,7 @@
 #include "zidl/window_manager_stub.h"
 #include <ipc_skeleton.h>
 #include <rs_iwindow_animation_controller.h>
+#include "marshalling_helper.h"
 #include "window_manager_hilog.h"
 
 namespace OHOS {
@@ -199,7 +200,10 @@ int32_t WindowManagerStub::OnRemoteRequest(uint32_t code, MessageParcel &data, M
         }
         case WindowManagerMessage::TRANS_ID_GET_ANIMATION_CALLBACK: {
             std::vector<uint32_t> windowIds;
-            data.ReadUInt32Vector(&windowIds);
+            if (!MarshallingHelper::UnmarshallingVectorPodObj<uint32_t>(data, windowIds)) {
+                WLOGFE("Read windowIds failed");
+                break;
+            }
             bool isAnimated = data.ReadBool();
             sptr<RSIWindowAnimationFinishedCallback> finishedCallback = nullptr;
             MinimizeWindowsByLauncher(windowIds, isAnimated, finishedCallback);
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "wms_benchmark_env.h"
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr uint32_t FOCUS_STORM_WINDOW_NUM = 16;
+    constexpr uint32_t ROTATION_WINDOW_NUM = 8;
+    constexpr uint32_t DRAG_FRAME_NUM = 120; // one second of pointer events at 120 Hz
+    constexpr int32_t DRAG_STEP = 4;
+    const Rect FLOATING_RECT = { 200, 200, 800, 600 };
+    const Rect FULLSCREEN_RECT = { 0, 0, 2560, 1600 };
+
+    Rect GetCascadeRect(uint32_t index)
+    {
+        constexpr int32_t cascadeStep = 40;
+        constexpr uint32_t cascadeNum = 16;
+        int32_t offset = static_cast<int32_t>(index % cascadeNum) * cascadeStep;
+        return { FLOATING_RECT.posX_ + offset, FLOATING_RECT.posY_ + offset, FLOATING_RECT.width_,
+            FLOATING_RECT.height_ };
+    }
+}
+
+static void BM_CreateWindows(benchmark::State& state)
+{
+    WmsBenchmarkEnv env;
+    OperationRecorder recorder(env);
+    uint32_t windowNum = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        for (uint32_t i = 0; i < windowNum; i++) {
+            recorder.Start();
+            env.CreateAppWindow("create" + std::to_string(i), WindowMode::WINDOW_MODE_FLOATING, GetCascadeRect(i));
+            recorder.Stop();
+        }
+        state.PauseTiming();
+        env.DestroyAllWindows();
+        state.ResumeTiming();
+    }
+    recorder.Report(state);
+}
+BENCHMARK(BM_CreateWindows)->Arg(8)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+static void BM_FocusStorm(benchmark::State& state)
+{
+    WmsBenchmarkEnv env;
+    OperationRecorder recorder(env);
+    for (uint32_t i = 0; i < FOCUS_STORM_WINDOW_NUM; i++) {
+        env.CreateAppWindow("focus" + std::to_string(i), WindowMode::WINDOW_MODE_FLOATING, GetCascadeRect(i));
+    }
+    const auto& windowIds = env.GetWindowIds();
+    size_t index = 0;
+    for (auto _ : state) {
+        recorder.Start();
+        uint32_t windowId = windowIds[index++ % windowIds.size()];
+        env.RunOnHandler([&env, windowId]() { env.windowController_->RequestFocus(windowId); });
+        recorder.Stop();
+    }
+    recorder.Report(state);
+}
+BENCHMARK(BM_FocusStorm)->Unit(benchmark::kMicrosecond);
+
+static void BM_SplitScreenEntry(benchmark::State& state)
+{
+    WmsBenchmarkEnv env;
+    OperationRecorder recorder(env);
+    uint32_t primaryId = env.CreateAppWindow("primary", WindowMode::WINDOW_MODE_FULLSCREEN, FULLSCREEN_RECT);
+    env.CreateAppWindow("secondary", WindowMode::WINDOW_MODE_FULLSCREEN, FULLSCREEN_RECT);
+    for (auto _ : state) {
+        recorder.Start();
+        env.RunOnHandler([&env, primaryId]() {
+            env.windowController_->SetWindowMode(primaryId, WindowMode::WINDOW_MODE_SPLIT_PRIMARY);
+        });
+        recorder.Stop();
+        state.PauseTiming();
+        env.RunOnHandler([&env, primaryId]() {
+            env.windowController_->SetWindowMode(primaryId, WindowMode::WINDOW_MODE_FULLSCREEN);
+        });
+        state.ResumeTiming();
+    }
+    recorder.Report(state);
+}
+BENCHMARK(BM_SplitScreenEntry)->Unit(benchmark::kMicrosecond);
+
+static void BM_Rotation(benchmark::State& state)
+{
+    WmsBenchmarkEnv env;
+    OperationRecorder recorder(env);
+    for (uint32_t i = 0; i < ROTATION_WINDOW_NUM; i++) {
+        env.CreateAppWindow("rotation" + std::to_string(i), WindowMode::WINDOW_MODE_FLOATING, GetCascadeRect(i));
+    }
+    bool isRotated = false;
+    for (auto _ : state) {
+        isRotated = !isRotated;
+        recorder.Start();
+        env.RotateDisplay(isRotated ? Rotation::ROTATION_90 : Rotation::ROTATION_0);
+        recorder.Stop();
+    }
+    env.RotateDisplay(Rotation::ROTATION_0);
+    recorder.Report(state);
+}
+BENCHMARK(BM_Rotation)->Unit(benchmark::kMicrosecond);
+
+// range(0): 0 moves the window, 1 resizes it from the bottom right corner
+static void BM_Drag120Hz(benchmark::State& state)
+{
+    WmsBenchmarkEnv env;
+    OperationRecorder recorder(env);
+    uint32_t windowId = env.CreateAppWindow("drag", WindowMode::WINDOW_MODE_FLOATING, FLOATING_RECT);
+    bool isResize = (state.range(0) != 0);
+    sptr<WindowProperty> property = new WindowProperty();
+    property->SetWindowId(windowId);
+    property->SetWindowSizeChangeReason(isResize ? WindowSizeChangeReason::DRAG : WindowSizeChangeReason::MOVE);
+    for (auto _ : state) {
+        for (uint32_t frame = 0; frame < DRAG_FRAME_NUM; frame++) {
+            // drag back and forth so the window stays on the display
+            int32_t offset = static_cast<int32_t>((frame < DRAG_FRAME_NUM / 2) ? frame : DRAG_FRAME_NUM - frame) *
+                DRAG_STEP;
+            Rect rect = FLOATING_RECT;
+            if (isResize) {
+                rect.width_ += static_cast<uint32_t>(offset);
+                rect.height_ += static_cast<uint32_t>(offset);
+            } else {
+                rect.posX_ += offset;
+                rect.posY_ += offset;
+            }
+            property->SetRequestRect(rect);
+            // stamped as the pointer event would be, so the commit latency of the frame is recorded as well
+            int64_t pointerTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            recorder.Start();
+            env.RunOnHandler([&env, &property, pointerTime]() {
+                env.windowController_->UpdateMoveOrDragRect(property, pointerTime);
+            });
+            recorder.Stop();
+        }
+        recorder.Start();
+        env.RunOnHandler([&env, windowId]() { env.windowController_->FinishMoveOrDrag(windowId); });
+        recorder.Stop();
+    }
+    recorder.Report(state);
+}
+BENCHMARK(BM_Drag120Hz)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+} // namespace Rosen
+} // namespace OHOS
+
+BENCHMARK_MAIN();
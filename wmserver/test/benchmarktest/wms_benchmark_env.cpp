@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wms_benchmark_env.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <ui/rs_surface_node.h>
+
+#include "window_manager_hilog.h"
+
+namespace {
+    std::atomic<uint64_t> g_allocationCount { 0 };
+}
+
+// every allocation of the benchmark process is counted, the scenarios report the ones done inside an operation
+void* operator new(size_t size)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr HiviewDFX::HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WINDOW, "WmsBenchmarkEnv"};
+    constexpr DisplayId BENCHMARK_DISPLAY_ID = 0;
+    constexpr int32_t BENCHMARK_DISPLAY_WIDTH = 2560;
+    constexpr int32_t BENCHMARK_DISPLAY_HEIGHT = 1600;
+    constexpr uint32_t BENCHMARK_REFRESH_RATE = 120;
+    constexpr float BENCHMARK_VIRTUAL_PIXEL_RATIO = 1.5f;
+    constexpr int32_t PERCENT = 100;
+    const std::string BENCHMARK_THREAD_NAME = "WmsBenchmark";
+}
+
+WmsBenchmarkEnv::WmsBenchmarkEnv()
+{
+    windowRoot_ = new WindowRoot([](Event event, const sptr<IRemoteObject>& remoteObject) {});
+    inputWindowMonitor_ = new InputWindowMonitor(windowRoot_);
+    inputWindowMonitor_->SetDisplayGroupInfoSink([this](const MMI::DisplayGroupInfo& displayGroupInfo) {
+        inputFlushCount_.fetch_add(1, std::memory_order_relaxed);
+    });
+    windowController_ = new WindowController(windowRoot_, inputWindowMonitor_);
+    windowController_->SetRsTransactionFlusher([this]() {
+        rsFlushCount_.fetch_add(1, std::memory_order_relaxed);
+    });
+    handler_ = std::make_shared<AppExecFwk::EventHandler>(AppExecFwk::EventRunner::Create(BENCHMARK_THREAD_NAME));
+    windowController_->SetEventHandler(handler_);
+
+    displayInfo_ = new DisplayInfo();
+    displayInfo_->SetDisplayId(BENCHMARK_DISPLAY_ID);
+    displayInfo_->SetScreenId(BENCHMARK_DISPLAY_ID);
+    displayInfo_->SetScreenGroupId(BENCHMARK_DISPLAY_ID);
+    displayInfo_->SetWidth(BENCHMARK_DISPLAY_WIDTH);
+    displayInfo_->SetHeight(BENCHMARK_DISPLAY_HEIGHT);
+    displayInfo_->SetRefreshRate(BENCHMARK_REFRESH_RATE);
+    displayInfo_->SetVirtualPixelRatio(BENCHMARK_VIRTUAL_PIXEL_RATIO);
+    if (windowRoot_->CreateWindowNodeContainer(displayInfo_) == nullptr) {
+        WLOGFE("create window node container for the benchmark display failed");
+    }
+}
+
+WmsBenchmarkEnv::~WmsBenchmarkEnv()
+{
+    DestroyAllWindows();
+    windowController_->SetEventHandler(nullptr);
+}
+
+void WmsBenchmarkEnv::RunOnHandler(const std::function<void()>& task)
+{
+    handler_->PostSyncTask(task, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+    // the commit task was posted at the same priority while task ran, so it has run once this returns
+    handler_->PostSyncTask([]() {}, AppExecFwk::EventQueue::Priority::IMMEDIATE);
+}
+
+uint32_t WmsBenchmarkEnv::CreateAppWindow(const std::string& name, WindowMode mode, const Rect& rect)
+{
+    sptr<WindowProperty> property = new WindowProperty();
+    property->SetWindowName(name);
+    property->SetWindowType(WindowType::WINDOW_TYPE_APP_MAIN_WINDOW);
+    property->SetWindowMode(mode);
+    property->SetRequestRect(rect);
+    property->SetWindowRect(rect);
+    property->SetDisplayId(displayInfo_->GetDisplayId());
+    property->SetFocusable(true);
+
+    struct RSSurfaceNodeConfig config;
+    config.SurfaceNodeName = name;
+    // not a window node, so no surface is requested from the render service
+    auto surfaceNode = RSSurfaceNode::Create(config, false);
+    sptr<IWindow> window = new BenchmarkWindow();
+    uint32_t windowId = INVALID_WINDOW_ID;
+    RunOnHandler([this, &window, &property, &surfaceNode, &windowId]() {
+        WMError ret = windowController_->CreateWindow(window, property, surfaceNode, windowId, nullptr, 0, 0);
+        if (ret != WMError::WM_OK) {
+            WLOGFE("create window failed, ret: %{public}u", static_cast<uint32_t>(ret));
+            windowId = INVALID_WINDOW_ID;
+            return;
+        }
+        property->SetWindowId(windowId);
+        ret = windowController_->AddWindowNode(property);
+        if (ret != WMError::WM_OK) {
+            WLOGFE("add window node failed, ret: %{public}u", static_cast<uint32_t>(ret));
+            windowController_->DestroyWindow(windowId, false);
+            windowId = INVALID_WINDOW_ID;
+        }
+    });
+    if (windowId != INVALID_WINDOW_ID) {
+        windowIds_.push_back(windowId);
+    }
+    return windowId;
+}
+
+void WmsBenchmarkEnv::DestroyAllWindows()
+{
+    RunOnHandler([this]() {
+        for (auto windowId : windowIds_) {
+            windowController_->DestroyWindow(windowId, false);
+        }
+    });
+    windowIds_.clear();
+}
+
+void WmsBenchmarkEnv::RotateDisplay(Rotation rotation)
+{
+    bool isVertical = (rotation == Rotation::ROTATION_90 || rotation == Rotation::ROTATION_270);
+    displayInfo_->SetWidth(isVertical ? BENCHMARK_DISPLAY_HEIGHT : BENCHMARK_DISPLAY_WIDTH);
+    displayInfo_->SetHeight(isVertical ? BENCHMARK_DISPLAY_WIDTH : BENCHMARK_DISPLAY_HEIGHT);
+    displayInfo_->SetRotation(rotation);
+    std::map<DisplayId, sptr<DisplayInfo>> displayInfoMap = { { displayInfo_->GetDisplayId(), displayInfo_ } };
+    RunOnHandler([this, &displayInfoMap]() {
+        windowController_->NotifyDisplayStateChange(displayInfo_->GetDisplayId(), displayInfo_, displayInfoMap,
+            DisplayStateChangeType::UPDATE_ROTATION);
+    });
+}
+
+const std::vector<uint32_t>& WmsBenchmarkEnv::GetWindowIds() const
+{
+    return windowIds_;
+}
+
+uint64_t WmsBenchmarkEnv::GetInputFlushCount() const
+{
+    return inputFlushCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t WmsBenchmarkEnv::GetRsFlushCount() const
+{
+    return rsFlushCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t WmsBenchmarkEnv::GetAllocationCount()
+{
+    return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+OperationRecorder::OperationRecorder(const WmsBenchmarkEnv& env) : env_(env)
+{
+}
+
+void OperationRecorder::Start()
+{
+    startInputFlushCount_ = env_.GetInputFlushCount();
+    startRsFlushCount_ = env_.GetRsFlushCount();
+    startAllocationCount_ = WmsBenchmarkEnv::GetAllocationCount();
+    startTime_ = std::chrono::steady_clock::now();
+}
+
+void OperationRecorder::Stop()
+{
+    auto endTime = std::chrono::steady_clock::now();
+    // counted before the sample is stored, the recorder's own allocations are not the operation's
+    allocationCount_ += WmsBenchmarkEnv::GetAllocationCount() - startAllocationCount_;
+    inputFlushCount_ += env_.GetInputFlushCount() - startInputFlushCount_;
+    rsFlushCount_ += env_.GetRsFlushCount() - startRsFlushCount_;
+    latencies_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime_).count());
+}
+
+void OperationRecorder::Report(benchmark::State& state)
+{
+    if (latencies_.empty()) {
+        return;
+    }
+    std::sort(latencies_.begin(), latencies_.end());
+    auto percentile = [this](size_t percent) {
+        return static_cast<double>(latencies_[(latencies_.size() - 1) * percent / PERCENT]);
+    };
+    double operationCount = static_cast<double>(latencies_.size());
+    state.counters["p50(us)"] = percentile(50); // 50: median
+    state.counters["p90(us)"] = percentile(90); // 90: 90th percentile
+    state.counters["p99(us)"] = percentile(99); // 99: 99th percentile
+    state.counters["max(us)"] = static_cast<double>(latencies_.back());
+    state.counters["allocs/op"] = static_cast<double>(allocationCount_) / operationCount;
+    state.counters["mmiFlushes/op"] = static_cast<double>(inputFlushCount_) / operationCount;
+    state.counters["rsFlushes/op"] = static_cast<double>(rsFlushCount_) / operationCount;
+}
+} // namespace Rosen
+} // namespace OHOS
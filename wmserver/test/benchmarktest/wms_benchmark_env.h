@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_ROSEN_WMS_BENCHMARK_ENV_H
+#define OHOS_ROSEN_WMS_BENCHMARK_ENV_H
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <event_handler.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "input_window_monitor.h"
+#include "window_controller.h"
+#include "window_root.h"
+#include "wm_common.h"
+#include "zidl/window_stub.h"
+
+namespace OHOS {
+namespace Rosen {
+// client window stand-in, a local stub so the death recipient and the client callbacks stay in process
+class BenchmarkWindow : public WindowStub {
+public:
+    void UpdateWindowRect(const struct Rect& rect, bool decoStatus, WindowSizeChangeReason reason) override {}
+    void UpdateWindowMode(WindowMode mode) override {}
+    void UpdateWindowModeSupportInfo(uint32_t modeSupportInfo) override {}
+    void UpdateFocusStatus(bool focused) override {}
+    void UpdateAvoidArea(const sptr<AvoidArea>& avoidArea, AvoidAreaType type) override {}
+    void UpdateWindowState(WindowState state) override {}
+    void UpdateWindowDragInfo(const PointInfo& point, DragEvent event) override {}
+    void UpdateDisplayId(DisplayId from, DisplayId to) override {}
+    void UpdateOccupiedAreaChangeInfo(const sptr<OccupiedAreaChangeInfo>& info) override {}
+    void UpdateActiveStatus(bool isActive) override {}
+    sptr<WindowProperty> GetWindowProperty() override
+    {
+        return nullptr;
+    }
+    void NotifyTouchOutside() override {}
+    void NotifyScreenshot() override {}
+    void DumpInfo(const std::vector<std::string>& params, std::vector<std::string>& info) override {}
+    void NotifyDestroy(void) override {}
+    void NotifyWindowClientPointUp(const std::shared_ptr<MMI::PointerEvent>& pointerEvent) override {}
+};
+
+/*
+ * WindowRoot, WindowController and InputWindowMonitor wired as in WMS, but on a synthetic display,
+ * with surface nodes that are never bound to a render service surface and with the RS transaction
+ * flushes and the display group info counted instead of sent to RS and MMI, so the scenarios run
+ * without a GPU, DMS screens or input. Operations run on a handler, as WMS tasks do, so the commit
+ * stage merges their flushes the same way. It still links the RS client, the event runner and IPC,
+ * so it is an ohos_benchmarktest run on a device and not a host binary.
+ */
+class WmsBenchmarkEnv {
+public:
+    WmsBenchmarkEnv();
+    ~WmsBenchmarkEnv();
+
+    uint32_t CreateAppWindow(const std::string& name, WindowMode mode, const Rect& rect);
+    void DestroyAllWindows();
+    void RotateDisplay(Rotation rotation);
+    // runs task on the handler and returns once the commit it requested has run as well
+    void RunOnHandler(const std::function<void()>& task);
+    const std::vector<uint32_t>& GetWindowIds() const;
+    uint64_t GetInputFlushCount() const;
+    uint64_t GetRsFlushCount() const;
+    static uint64_t GetAllocationCount();
+
+    sptr<WindowRoot> windowRoot_;
+    sptr<InputWindowMonitor> inputWindowMonitor_;
+    sptr<WindowController> windowController_;
+    sptr<DisplayInfo> displayInfo_;
+
+private:
+    std::shared_ptr<AppExecFwk::EventHandler> handler_;
+    std::vector<uint32_t> windowIds_;
+    // updated on the handler, read by the benchmark thread
+    std::atomic<uint64_t> inputFlushCount_ { 0 };
+    std::atomic<uint64_t> rsFlushCount_ { 0 };
+};
+
+// per-operation latency samples of one benchmark, reported as percentiles next to the allocation and flush counts
+class OperationRecorder {
+public:
+    explicit OperationRecorder(const WmsBenchmarkEnv& env);
+    void Start();
+    void Stop();
+    void Report(benchmark::State& state);
+
+private:
+    const WmsBenchmarkEnv& env_;
+    std::vector<int64_t> latencies_;
+    std::chrono::steady_clock::time_point startTime_;
+    uint64_t startAllocationCount_ { 0 };
+    uint64_t startInputFlushCount_ { 0 };
+    uint64_t startRsFlushCount_ { 0 };
+    uint64_t allocationCount_ { 0 };
+    uint64_t inputFlushCount_ { 0 };
+    uint64_t rsFlushCount_ { 0 };
+};
+} // namespace Rosen
+} // namespace OHOS
+#endif // OHOS_ROSEN_WMS_BENCHMARK_ENV_H
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "window_manager_agent_dispatcher.h"
+#include "zidl/window_manager_agent_stub.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Rosen {
+namespace {
+    constexpr DisplayId DISPLAY_ID = 0;
+    constexpr std::chrono::milliseconds WAIT_TIMEOUT { 1000 };
+}
+
+// records the focus changes it receives, the first delivery waits until the test releases it
+class FocusRecordingAgent : public WindowManagerAgentStub {
+public:
+    void UpdateFocusChangeInfo(const sptr<FocusChangeInfo>& focusChangeInfo, bool focused) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait_for(lock, WAIT_TIMEOUT, [this] { return isReleased_; });
+        focusChanges_.emplace_back(focusChangeInfo->windowId_, focused);
+        condition_.notify_all();
+    }
+    void UpdateSystemBarRegionTints(DisplayId displayId, const SystemBarRegionTints& tints) override {}
+    void NotifyAccessibilityWindowInfo(const sptr<AccessibilityWindowInfo>& windowInfo,
+        WindowUpdateType type) override {}
+    void UpdateWindowVisibilityInfo(const std::vector<sptr<WindowVisibilityInfo>>& visibilityInfos) override {}
+    void UpdateCameraFloatWindowStatus(uint32_t accessTokenId, bool isShowing) override {}
+
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isReleased_ = true;
+        condition_.notify_all();
+    }
+    std::vector<std::pair<uint32_t, bool>> WaitForFocusChanges(size_t num)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait_for(lock, WAIT_TIMEOUT, [this, num] { return focusChanges_.size() >= num; });
+        return focusChanges_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool isReleased_ { false };
+    std::vector<std::pair<uint32_t, bool>> focusChanges_;
+};
+
+class WindowManagerAgentDispatcherTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+    void DispatchFocus(const sptr<IWindowManagerAgent>& agent, uint32_t windowId, bool focused);
+    std::unique_ptr<WindowManagerAgentDispatcher> dispatcher_;
+};
+
+void WindowManagerAgentDispatcherTest::SetUpTestCase()
+{
+}
+
+void WindowManagerAgentDispatcherTest::TearDownTestCase()
+{
+}
+
+void WindowManagerAgentDispatcherTest::SetUp()
+{
+    dispatcher_ = std::make_unique<WindowManagerAgentDispatcher>(nullptr);
+}
+
+void WindowManagerAgentDispatcherTest::TearDown()
+{
+    dispatcher_ = nullptr;
+}
+
+// the same notification WindowManagerAgentController::UpdateFocusChangeInfo dispatches
+void WindowManagerAgentDispatcherTest::DispatchFocus(const sptr<IWindowManagerAgent>& agent, uint32_t windowId,
+    bool focused)
+{
+    sptr<FocusChangeInfo> focusChangeInfo = new FocusChangeInfo(windowId, DISPLAY_ID, 0, 0,
+        WindowType::WINDOW_TYPE_APP_MAIN_WINDOW, nullptr);
+    dispatcher_->Dispatch(agent, { WindowManagerAgentType::WINDOW_MANAGER_AGENT_TYPE_FOCUS, false, DISPLAY_ID,
+        { windowId }, [focusChangeInfo, focused](const sptr<IWindowManagerAgent>& target) {
+            target->UpdateFocusChangeInfo(focusChangeInfo, focused);
+        }, !focused });
+}
+
+namespace {
+/**
+ * @tc.name: FocusChangeSequence
+ * @tc.desc: unfocus A, focus B, unfocus B, focus C is delivered as unfocus A, focus C
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowManagerAgentDispatcherTest, FocusChangeSequence, Function | SmallTest | Level2)
+{
+    sptr<FocusRecordingAgent> agent = new FocusRecordingAgent();
+    constexpr uint32_t windowA = 1;
+    constexpr uint32_t windowB = 2;
+    constexpr uint32_t windowC = 3;
+    // the worker holds "unfocus A" or has not taken it yet, the rest stays pending either way
+    DispatchFocus(agent, windowA, false);
+    DispatchFocus(agent, windowB, true);
+    DispatchFocus(agent, windowB, false);
+    DispatchFocus(agent, windowC, true);
+    agent->Release();
+
+    auto focusChanges = agent->WaitForFocusChanges(2); // 2: unfocus A and focus C
+    ASSERT_EQ(2u, focusChanges.size());
+    ASSERT_EQ(std::make_pair(windowA, false), focusChanges[0]);
+    ASSERT_EQ(std::make_pair(windowC, true), focusChanges[1]);
+}
+
+/**
+ * @tc.name: DeliveredFocusIsNotUndone
+ * @tc.desc: the unfocus of a window whose focus was already delivered is delivered as well
+ * @tc.type: FUNC
+ */
+HWTEST_F(WindowManagerAgentDispatcherTest, DeliveredFocusIsNotUndone, Function | SmallTest | Level2)
+{
+    sptr<FocusRecordingAgent> agent = new FocusRecordingAgent();
+    constexpr uint32_t windowA = 1;
+    agent->Release();
+    DispatchFocus(agent, windowA, true);
+    ASSERT_EQ(1u, agent->WaitForFocusChanges(1).size());
+    DispatchFocus(agent, windowA, false);
+
+    auto focusChanges = agent->WaitForFocusChanges(2); // 2: focus and unfocus A
+    ASSERT_EQ(2u, focusChanges.size());
+    ASSERT_EQ(std::make_pair(windowA, false), focusChanges[1]);
+}
+}
+} // namespace Rosen
+} // namespace OHOS